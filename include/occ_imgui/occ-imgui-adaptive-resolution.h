@@ -0,0 +1,78 @@
+#pragma once
+
+#include <opencascade/V3d_View.hxx>
+
+//! Adaptive rendering quality of the view during camera interaction.
+//! While a camera gesture or a view animation is in progress, the view is rendered with a reduced
+//! Graphic3d_RenderingParams::RenderResolutionScale and without MSAA; the scale follows the
+//! measured frame time towards the target. Full quality is restored once the camera has been still
+//! for the refine delay.
+class OccImguiAdaptiveResolution
+{
+public:
+  //! Return TRUE if the quality is reduced during interaction.
+  bool isEnabled() const { return myIsEnabled; }
+
+  //! Enable or disable reduced quality during interaction; applied by the next update().
+  void setEnabled(const bool theIsEnabled) { myIsEnabled = theIsEnabled; }
+
+  //! Return number of MSAA samples of still frames.
+  int msaaSamples() const { return myMsaaSamples; }
+
+  //! Set number of MSAA samples of still frames; applied by setupView().
+  void setMsaaSamples(const int theNbSamples) { myMsaaSamples = theNbSamples; }
+
+  //! Return frame time in seconds the resolution scale is adapted to.
+  double targetFrameTime() const { return myTargetFrameTime; }
+
+  //! Set frame time in seconds the resolution scale is adapted to.
+  void setTargetFrameTime(const double theSeconds) { myTargetFrameTime = theSeconds; }
+
+  //! Return the lowest resolution scale used during interaction.
+  float minScale() const { return myMinScale; }
+
+  //! Set the lowest resolution scale used during interaction.
+  void setMinScale(const float theScale);
+
+  //! Return delay in seconds after the last interaction before full quality is restored.
+  double refineDelay() const { return myRefineDelay; }
+
+  //! Return resolution scale of interactive frames.
+  float scale() const { return myScale; }
+
+  //! Return TRUE if interactive frames are being rendered at reduced quality.
+  bool isDegraded() const { return myIsDegraded; }
+
+  //! Apply full quality rendering parameters to the view.
+  void setupView(const Handle(V3d_View)& theView) const;
+
+  //! Advance by one frame.
+  //! @param[in] theIsInteracting  camera gesture or animation is in progress
+  //! @param[in] theTime           current time in seconds
+  //! @param[in] theFrameTime      duration of the previous frame if it has redrawn the scene
+  //!                              at reduced quality, or 0
+  //! @return TRUE if the rendering parameters have to be applied
+  bool update(bool theIsInteracting, double theTime, double theFrameTime);
+
+  //! Apply current quality to the view; a different view degraded before is restored
+  //! to full quality and invalidated.
+  void apply(const Handle(V3d_View)& theView);
+
+  //! Forget the view before it is removed.
+  void release(const Handle(V3d_View)& theView);
+
+private:
+  //! Restore full quality of the degraded view.
+  void restoreView();
+
+private:
+  Handle(V3d_View) myView; //!< view rendered at reduced quality
+  double           myTargetFrameTime = 1.0 / 30.0;
+  double           myRefineDelay     = 0.15;
+  double           myInteractionTime = 0.0;
+  float            myScale           = 1.0f;
+  float            myMinScale        = 0.25f;
+  int              myMsaaSamples     = 0;
+  bool             myIsEnabled       = true;
+  bool             myIsDegraded      = false;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <opencascade/AIS_InteractiveObject.hxx>
+#include <opencascade/Bnd_Box.hxx>
+
+#include <vector>
+
+//! Wireframe bounding boxes standing in for parts which are still being loaded.
+//! One object draws the boxes of a whole chunk of parts as a single segment array;
+//! it is not selectable and has only the wireframe display mode 0.
+class OccImguiBoxPlaceholder : public AIS_InteractiveObject
+{
+  DEFINE_STANDARD_RTTI_INLINE(OccImguiBoxPlaceholder, AIS_InteractiveObject)
+
+public:
+  //! Main constructor.
+  explicit OccImguiBoxPlaceholder(const std::vector<Bnd_Box>& theBoxes);
+
+  //! Return the boxes.
+  const std::vector<Bnd_Box>& boxes() const { return myBoxes; }
+
+  //! Return TRUE for the wireframe mode 0.
+  Standard_Boolean AcceptDisplayMode(const Standard_Integer theMode) const override
+  {
+    return theMode == 0;
+  }
+
+protected:
+  //! Compute the segments of all boxes.
+  void Compute(const Handle(PrsMgr_PresentationManager)& thePrsMgr,
+               const Handle(Prs3d_Presentation)&         thePrs,
+               const Standard_Integer                    theMode) override;
+
+  //! Placeholders have no selection.
+  void ComputeSelection(const Handle(SelectMgr_Selection)&, const Standard_Integer) override {}
+
+private:
+  std::vector<Bnd_Box> myBoxes;
+};
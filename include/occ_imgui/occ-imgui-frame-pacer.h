@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//! Frame pacing of the interactive viewer.
+//! Frames start no more often than the target rate allows, or than the much lower idle rate once
+//! no input has arrived for the idle delay, so that continuous rendering (animations, streamed
+//! imports, progress bars) never busy-loops a core. The swap interval follows the measured frame
+//! work: frames missing the display refresh are swapped without waiting for the next one.
+//! Timestamps of input events are carried to the buffer swap of the frame handling them, giving
+//! input-to-present latencies of the latest frames.
+class OccImguiFramePacer
+{
+public:
+  //! Return frame rate limit in frames per second, 0 if unlimited.
+  double targetRate() const { return myTargetRate; }
+
+  //! Set frame rate limit in frames per second, 0 for unlimited.
+  void setTargetRate(const double theRate) { myTargetRate = theRate > 0.0 ? theRate : 0.0; }
+
+  //! Return frame rate limit without input, in frames per second.
+  double idleRate() const { return myIdleRate; }
+
+  //! Set frame rate limit without input, in frames per second.
+  void setIdleRate(double theRate);
+
+  //! Return time without input after which the idle rate applies, in seconds.
+  double idleDelay() const { return myIdleDelay; }
+
+  //! Set time without input after which the idle rate applies, in seconds.
+  void setIdleDelay(const double theSeconds) { myIdleDelay = theSeconds; }
+
+  //! Return TRUE if the swap interval adapts to the frame work, FALSE for plain vsync.
+  bool isAdaptiveSwap() const { return myIsAdaptiveSwap; }
+
+  //! Enable or disable adaptive swap interval.
+  void setAdaptiveSwap(const bool theIsAdaptive) { myIsAdaptiveSwap = theIsAdaptive; }
+
+  //! Return display refresh rate in Hz.
+  double refreshRate() const { return myRefreshRate; }
+
+  //! Set display refresh rate in Hz.
+  void setRefreshRate(double theRate);
+
+  //! Set if the driver tears late swaps by itself with a negative swap interval
+  //! (WGL_EXT_swap_control_tear / GLX_EXT_swap_control_tear).
+  void setSwapTearSupported(const bool theIsSupported) { myIsSwapTearSupported = theIsSupported; }
+
+  //! Record an input event received at theTime (in seconds).
+  void addInput(double theTime);
+
+  //! Return TRUE if no input has arrived for the idle delay.
+  bool isIdle(const double theTime) const { return theTime - myInputTime >= myIdleDelay; }
+
+  //! Return seconds to wait at theTime before the next frame may start.
+  double frameDelay(double theTime) const;
+
+  //! Mark the start of a frame.
+  void beginFrame(double theTime);
+
+  //! Mark the buffer swap of the frame; collects latency of inputs received before the frame.
+  //! @param[in] theSwapStart  time before the swap, ending the frame work
+  //! @param[in] theSwapEnd    time after the swap
+  void endFrame(double theSwapStart, double theSwapEnd);
+
+  //! Return swap interval for the next frames: 1 waits for the display refresh,
+  //! 0 swaps immediately, -1 lets the driver tear late swaps.
+  int swapInterval() const { return mySwapInterval; }
+
+  //! Return smoothed rate of swapped frames, in frames per second.
+  double frameRate() const { return myFrameRate; }
+
+  //! Return smoothed frame work before the swap, in seconds.
+  double frameWork() const { return myFrameWork; }
+
+  //! Return number of collected latency samples.
+  size_t nbLatencies() const { return myLatencies.size(); }
+
+  //! Return the nearest-rank percentile of the latest input-to-present latencies, in milliseconds.
+  double latencyPercentile(double thePercent) const;
+
+  //! Remove collected latency samples.
+  void resetLatencies();
+
+private:
+  std::vector<double> myLatencies;                  //!< ring of the latest latencies, in ms
+  size_t              myNextLatency         = 0;
+  double              myTargetRate          = 60.0;
+  double              myIdleRate            = 4.0;
+  double              myIdleDelay           = 2.0;
+  double              myRefreshRate         = 60.0;
+  double              myInputTime           = 0.0;  //!< time of the latest input
+  double              myPendingInputTime    = -1.0; //!< oldest input not presented yet, or -1
+  double              myFrameStart          = -1.0; //!< start of the latest frame, or -1
+  double              myLastSwap            = -1.0; //!< end of the latest swap, or -1
+  double              myFrameWork           = 0.0;
+  double              myFrameRate           = 0.0;
+  int                 mySwapInterval        = 1;
+  bool                myIsAdaptiveSwap      = true;
+  bool                myIsSwapTearSupported = false;
+};
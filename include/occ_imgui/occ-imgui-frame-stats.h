@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//! Collection of frame time samples (in milliseconds) computing order statistics.
+class OccImguiFrameStats
+{
+public:
+  //! Reserve memory for the expected number of samples.
+  void reserve(const size_t theNbSamples) { mySamples.reserve(theNbSamples); }
+
+  //! Append a new sample.
+  void add(const double theMillis) { mySamples.push_back(theMillis); }
+
+  //! Remove all samples.
+  void reset() { mySamples.clear(); }
+
+  //! Return number of samples.
+  size_t size() const { return mySamples.size(); }
+
+  //! Return TRUE if no samples have been collected.
+  bool isEmpty() const { return mySamples.empty(); }
+
+  //! Return the smallest sample or 0 if empty.
+  double minimum() const;
+
+  //! Return the largest sample or 0 if empty.
+  double maximum() const;
+
+  //! Return the arithmetic mean or 0 if empty.
+  double mean() const;
+
+  //! Return the median sample.
+  double median() const { return percentile(50.0); }
+
+  //! Return the nearest-rank percentile for the value within [0, 100] or 0 if empty.
+  double percentile(double thePercent) const;
+
+private:
+  std::vector<double> mySamples;
+};
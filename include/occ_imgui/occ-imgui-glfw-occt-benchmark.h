@@ -0,0 +1,54 @@
+#pragma once
+
+#include "occ-imgui-frame-stats.h"
+#include "occ-imgui-glfw-occt-view.h"
+
+#include <ostream>
+
+//! Headless viewer measuring frame times on a synthetic scene of boxes and cones.
+class GlfwOcctBenchmark : public GlfwOcctView
+{
+public:
+  //! Benchmark parameters.
+  struct Parameters
+  {
+    int  NbFrames       = 300;  //!< number of measured frames
+    int  NbWarmupFrames = 10;   //!< number of frames rendered before measuring
+    int  NbShapes       = 100;  //!< number of boxes and cones in the scene
+    int  Width          = 1280; //!< offscreen window width
+    int  Height         = 720;  //!< offscreen window height
+    bool ToSyncGpu      = true; //!< wait for the GPU after each stage to measure full frame cost
+  };
+
+public:
+  //! Default constructor.
+  GlfwOcctBenchmark();
+
+  //! Run the benchmark; returns FALSE if the offscreen viewer could not be created.
+  bool perform(const Parameters& theParams);
+
+  //! Print min/median/p99 frame times of each stage.
+  void dump(std::ostream& theStream) const;
+
+  //! Return timings of FlushViewEvents().
+  const OccImguiFrameStats& flushStats() const { return myFlushStats; }
+
+  //! Return timings of renderGui().
+  const OccImguiFrameStats& guiStats() const { return myGuiStats; }
+
+  //! Return timings of whole frames.
+  const OccImguiFrameStats& frameStats() const { return myFrameStats; }
+
+private:
+  //! Fill 3D Viewer with a grid of theNbShapes boxes and cones.
+  void initBenchmarkScene(int theNbShapes) const;
+
+  //! Orbit the camera by a small step so that every frame is a full redraw.
+  void orbitCamera() const;
+
+private:
+  Parameters         myParams;
+  OccImguiFrameStats myFlushStats;
+  OccImguiFrameStats myGuiStats;
+  OccImguiFrameStats myFrameStats;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "occ-imgui-frame-stats.h"
+#include "occ-imgui-glfw-occt-view.h"
+#include "occ-imgui-input-recording.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Headless viewer replaying recorded window input at a fixed frame step and measuring frame times.
+//! The recorded model is imported first, outside of the measurement; recorded events are then
+//! handed to ImGui and to the input queue on the frame their time falls into, so that every build
+//! processes the same input on the same frames.
+class GlfwOcctReplay : public GlfwOcctView
+{
+public:
+  //! Replay parameters.
+  struct Parameters
+  {
+    std::string RecordingPath;               //!< file written by a recording session
+    double      FrameStep      = 1.0 / 60.0; //!< fixed frame step in seconds
+    double      TailTime       = 1.0;        //!< time replayed after the last event, in seconds
+    int         NbWarmupFrames = 10;         //!< frames rendered after loading, before replaying
+    bool        ToSyncGpu      = true;       //!< wait for the GPU after each frame
+  };
+
+  //! Timing of one replayed frame.
+  struct FrameTiming
+  {
+    double Time     = 0.0;   //!< replay time in seconds
+    double Millis   = 0.0;   //!< frame duration in milliseconds
+    size_t NbEvents = 0;     //!< recorded events handed over on this frame
+    bool   IsScene  = false; //!< the scene has been redrawn
+  };
+
+public:
+  //! Default constructor.
+  GlfwOcctReplay();
+
+  //! Replay the recording; returns FALSE if the recording cannot be read
+  //! or the offscreen viewer could not be created, see errorMessage().
+  bool perform(const Parameters& theParams);
+
+  //! Return the reason of a failed replay.
+  const std::string& errorMessage() const { return myError; }
+
+  //! Print min/median/p99 times of all frames and of frames redrawing the scene.
+  void dump(std::ostream& theStream) const;
+
+  //! Write per-frame timings as CSV.
+  bool writeTimings(const std::string& thePath) const;
+
+  //! Return timings of replayed frames.
+  const std::vector<FrameTiming>& frames() const { return myFrames; }
+
+  //! Return times of all replayed frames.
+  const OccImguiFrameStats& frameStats() const { return myFrameStats; }
+
+  //! Return times of replayed frames redrawing the scene.
+  const OccImguiFrameStats& sceneStats() const { return mySceneStats; }
+
+private:
+  //! Hand over recorded events up to theTime; returns number of events.
+  size_t feedEvents(double theTime);
+
+private:
+  Parameters               myParams;
+  OccImguiInputRecording   myReplay;
+  size_t                   myNextEvent = 0;
+  std::vector<FrameTiming> myFrames;
+  OccImguiFrameStats       myFrameStats;
+  OccImguiFrameStats       mySceneStats;
+  std::string              myError;
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "occ-imgui-glfw-occt-view.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Headless viewer rendering snapshots of models from camera presets into PNG files.
+//! Each model is read, meshed through the mesh cache (sharing its disk cache with interactive
+//! sessions), displayed alone and dumped with V3d_View::ToPixMap() once per preset.
+class GlfwOcctSnapshot : public GlfwOcctView
+{
+public:
+  //! Camera preset.
+  enum Preset
+  {
+    Preset_Iso,
+    Preset_Top,
+    Preset_Bottom,
+    Preset_Front,
+    Preset_Back,
+    Preset_Left,
+    Preset_Right,
+    Preset_NB
+  };
+
+  //! Model to render.
+  struct Model
+  {
+    std::string Path;
+    std::string Name; //!< base name of the images, "<Name>-<preset>.png"
+  };
+
+  //! Snapshot parameters.
+  struct Parameters
+  {
+    std::vector<Model>  Models;
+    std::vector<Preset> Presets{Preset_Iso};
+    std::string         OutputDir     = ".";
+    int                 Width         = 256; //!< image width
+    int                 Height        = 256; //!< image height
+    int                 NbMsaaSamples = 4;
+  };
+
+  //! Result of one snapshot; model loading and meshing times are reported
+  //! with the first preset of each model.
+  struct Result
+  {
+    std::string Model;
+    std::string Image;
+    std::string Error;
+    Preset      View     = Preset_Iso;
+    double      LoadMs   = 0.0;
+    double      MeshMs   = 0.0;
+    double      RenderMs = 0.0;
+    double      WriteMs  = 0.0;
+    bool        IsOk     = false;
+  };
+
+public:
+  //! Return preset name.
+  static const char* presetName(int thePreset);
+
+  //! Find preset by name; returns FALSE if the name is unknown.
+  static bool presetFromName(const std::string& theName, Preset& thePreset);
+
+  //! Write results as comma-separated JSON objects, to be embedded into a JSON array.
+  static void dumpResults(std::ostream& theStream, const std::vector<Result>& theResults);
+
+public:
+  //! Default constructor.
+  GlfwOcctSnapshot();
+
+  //! Render all models; returns FALSE if the offscreen viewer could not be created.
+  bool perform(const Parameters& theParams);
+
+  //! Return results of the last perform() call, one per model and preset.
+  const std::vector<Result>& results() const { return myResults; }
+
+  //! Return number of failed snapshots.
+  size_t nbFailed() const;
+
+private:
+  //! Render all presets of one model.
+  void renderModel(const Model& theModel);
+
+private:
+  Parameters          myParams;
+  std::vector<Result> myResults;
+};
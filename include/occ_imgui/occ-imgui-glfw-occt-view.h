@@ -1,14 +1,58 @@
 #pragma once
 
+#include "occ-imgui-adaptive-resolution.h"
+#include "occ-imgui-frame-pacer.h"
 #include "occ-imgui-glfw-occt-window.h"
+#include "occ-imgui-importer.h"
+#include "occ-imgui-input-queue.h"
+#include "occ-imgui-input-recording.h"
+#include "occ-imgui-memory-budget.h"
+#include "occ-imgui-mesh-lod-cache.h"
+#include "occ-imgui-modeling.h"
+#include "occ-imgui-profiler.h"
+#include "occ-imgui-program-cache.h"
+#include "occ-imgui-scene-index.h"
+#include "occ-imgui-scene-lod.h"
+#include "occ-imgui-spsc-queue.h"
+#include "occ-imgui-startup-timeline.h"
 
 #include <opencascade/AIS_InteractiveContext.hxx>
+#include <opencascade/AIS_Shape.hxx>
 #include <opencascade/AIS_ViewController.hxx>
+#include <opencascade/Aspect_NeutralWindow.hxx>
+#include <opencascade/OpenGl_Context.hxx>
+#include <opencascade/OpenGl_FrameBuffer.hxx>
 #include <opencascade/V3d_View.hxx>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 //! Sample class creating 3D Viewer within GLFW window.
 class GlfwOcctView : protected AIS_ViewController
 {
+public:
+  //! Camera setup of a new 3D view panel.
+  enum ViewKind
+  {
+    ViewKind_Perspective,
+    ViewKind_Top,    //!< orthographic view along -Z
+    ViewKind_Front,  //!< orthographic view along +Y
+    ViewKind_Side,   //!< orthographic view along -X
+    ViewKind_Detail, //!< perspective view zoomed into the center of the active view
+    ViewKind_NB
+  };
+
+  //! Return view kind name.
+  static const char* viewKindName(int theKind);
+
 public:
   //! Default constructor.
   GlfwOcctView();
@@ -19,7 +63,38 @@ public:
   //! Main application entry point.
   void run();
 
-private:
+  //! Return TRUE if the viewer renders into a hidden offscreen window.
+  bool isHeadless() const { return myIsHeadless; }
+
+  //! Render into a hidden offscreen window instead of a visible one; should be set before run().
+  void setHeadless(const bool theIsHeadless) { myIsHeadless = theIsHeadless; }
+
+  //! Import a CAD or mesh file in background; may be called before run().
+  void openFile(const TCollection_AsciiString& thePath);
+
+  //! Record window input into the file, written on exit; should be set before run().
+  //! The GUI starts with the default layout and without platform windows, as in replays.
+  void setRecordPath(const std::string& thePath) { myRecordPath = thePath; }
+
+  //! Return TRUE if frames are rendered by a dedicated thread, see setRenderThread().
+  bool hasRenderThread() const { return myIsRenderThread && !myIsHeadless; }
+
+  //! Render frames on a dedicated thread owning the OpenGL context, while the thread calling run()
+  //! only pumps window events; should be set before run(), ignored by headless viewers.
+  //! Disabled by default: ImGui panels cannot leave the main window in this mode,
+  //! and there is no clipboard, mouse cursor shapes or keys beyond those used by the GUI.
+  void setRenderThread(const bool theToUse) { myIsRenderThread = theToUse; }
+
+  //! Limit the frame rate (in frames per second, 0 for unlimited).
+  void setTargetFrameRate(const double theRate) { myFramePacer.setTargetRate(theRate); }
+
+  //! Return timeline of startup phases.
+  const OccImguiStartupTimeline& startupTimeline() const { return myStartupTimeline; }
+
+  //! Print the startup timeline into standard output once startup completes.
+  void setStartupTimelinePrinted(const bool theToPrint) { myToPrintStartupTimeline = theToPrint; }
+
+protected:
   //! Create GLFW window.
   void initWindow(int theWidth, int theHeight, const char* theTitle);
 
@@ -27,25 +102,227 @@ private:
   void initViewer();
 
   //! Init ImGui.
-  void initGui() const;
+  void initGui();
+
+  //! Perform initialization deferred by initViewer() until after the first frame:
+  //! the grid, the view cube and the OpenGL diagnostics log.
+  void completeStartup();
 
   //! Render ImGUI.
   void renderGui();
 
+  //! Build ImGui windows of the frame.
+  void buildGui();
+
+  //! Dockable panel showing one view of the shared viewer.
+  //! The view renders into Fbo through Window sized to the panel, while myOcctWindow
+  //! only provides the GL context shared by all views.
+  struct ViewPanel
+  {
+    Handle(V3d_View)             View;
+    Handle(Aspect_NeutralWindow) Window;
+    Handle(OpenGl_FrameBuffer)   Fbo;
+    std::string                  Title;             //!< unique ImGui window name
+    Graphic3d_Vec2i              Origin;            //!< panel position in GLFW window
+    Graphic3d_Vec2i              Size;              //!< panel size in window pixels
+    Graphic3d_Vec2               Scale{1.0f, 1.0f}; //!< framebuffer / window pixels
+    ViewKind                     Kind      = ViewKind_Perspective;
+    size_t                       NbRedraws = 0;
+    bool                         IsHovered = false;
+    bool                         IsVisible = true; //!< view is active in the viewer
+    bool                         IsOpen    = true; //!< cleared by the close button of the panel
+  };
+
+  //! Create a new view of the viewer shown by a dockable panel.
+  ViewPanel* addViewPanel(ViewKind theKind);
+
+  //! Release the view and the offscreen framebuffer of the panel.
+  void releaseViewPanel(ViewPanel& thePanel);
+
+  //! Make the panel receive input; myView refers to the view of the active panel.
+  void setActiveViewPanel(ViewPanel* thePanel);
+
+  //! Render the panel showing the offscreen framebuffer of its view.
+  void renderViewPanel(ViewPanel& thePanel);
+
+  //! Activate or deactivate the view of the panel in the viewer, so that views of hidden panels
+  //! are never redrawn.
+  void setViewPanelVisible(ViewPanel& thePanel, bool theIsVisible);
+
+  //! Reallocate the offscreen framebuffer of the view to match its panel.
+  void updateViewFramebuffer(ViewPanel& thePanel);
+
+  //! Convert a cursor position within GLFW window into the offscreen coordinates of active view.
+  Graphic3d_Vec2i toViewPosition(const Graphic3d_Vec2i& theWindowPos) const;
+
+  //! Invalidate all views after changes of the scene content.
+  void invalidateViews();
+
   //! Fill 3D Viewer with a DEMO items.
-  void initDemoScene() const;
+  void initDemoScene();
 
   //! Application event loop.
   void mainloop();
 
+  //! Window event type passed to the render thread.
+  enum RenderCommandType
+  {
+    RenderCommand_MouseMove,
+    RenderCommand_MouseButton,
+    RenderCommand_Scroll,
+    RenderCommand_Key,
+    RenderCommand_Char,
+    RenderCommand_Focus,
+    RenderCommand_CursorEnter,
+    RenderCommand_Resize
+  };
+
+  //! Window event passed to the render thread; positions are in window coordinates.
+  struct RenderCommand
+  {
+    RenderCommandType Type = RenderCommand_MouseMove;
+    Graphic3d_Vec2i   Position;        //!< cursor position, or window size of resizes
+    Graphic3d_Vec2i   FramebufferSize; //!< framebuffer size of resizes
+    Graphic3d_Vec2d   ScrollDelta;
+    int               Code   = 0;   //!< mouse button, key, character, or focus and enter state
+    int               Action = 0;   //!< press, repeat or release
+    int               Mods   = 0;   //!< key modifiers
+    double            Time   = 0.0; //!< GLFW time of the event, in seconds
+  };
+
+  //! Event loop of the thread calling run() while the render thread draws frames.
+  void eventLoop();
+
+  //! Frame loop of the render thread.
+  void renderLoop();
+
+  //! Return seconds to wait for events before the next frame: zero to render immediately,
+  //! negative to wait until something happens.
+  double eventTimeout() const;
+
+  //! Queue the window event for the render thread; events not fitting into the full queue
+  //! are kept until the next call instead of blocking the event thread.
+  void pushRenderCommand(const RenderCommand& theCommand);
+
+  //! Move events kept by pushRenderCommand() into the queue; returns FALSE if it is still full.
+  bool flushRenderBacklog();
+
+  //! Wait up to theTimeout seconds (indefinitely if negative) for window events or a wakeup;
+  //! frame pacing delays (theIsPacing) are cut short only by stopping the render thread.
+  void waitRenderCommands(double theTimeout, bool theIsPacing = false);
+
+  //! Hand queued window events over to ImGui and to the input queue.
+  void applyRenderCommands();
+
+  //! Set ImGui display size and time in place of the GLFW backend,
+  //! which can only be used by the event thread.
+  void newGuiPlatformFrame();
+
+  //! Wake up the frame loop from any thread: the render thread, or the GLFW event loop.
+  void wakeup();
+
+  //! Update the scene and render the views and the GUI of one frame.
+  //! @param[in] theTime  frame time in seconds, see frameTime()
+  void renderFrame(double theTime);
+
+  //! Return time in seconds driving input handling and animations: the fixed frame clock
+  //! of replays, or the GLFW timer.
+  double frameTime() const;
+
+  //! Forward input events queued since the last frame to the view controller
+  //! and apply the window size once it has settled.
+  void applyInputEvents();
+
+  //! Display objects finished by the importer within the per-frame time budget.
+  void displayImportedObjects();
+
+  //! Render the file import section of the "Controls" panel.
+  void renderImportControls();
+
+  //! Render the modeling section of the "Controls" panel.
+  void renderModelingControls();
+
+  //! Swap results of finished modeling tasks into their shapes.
+  void applyModelingResults();
+
+  //! Render the "Scene" panel listing objects of the context.
+  void renderScenePanel();
+
+  //! List the object in the "Scene" panel.
+  void addSceneObject(const Handle(AIS_InteractiveObject)& theObject);
+
+  //! Remove the object from the "Scene" panel.
+  void removeSceneObject(const Handle(AIS_InteractiveObject)& theObject);
+
+  //! Fill name and attributes of the object listed in the "Scene" panel.
+  void sceneObjectText(size_t theId, std::string& theName, std::string& theAttributes) const;
+
+  //! Swap cached tessellation levels of displayed shapes after quality or camera changes.
+  //! @param[in] theTime  frame time in seconds, see frameTime()
+  void updateMeshLevels(double theTime);
+
+  //! Return tessellation level to be displayed for the shape.
+  int desiredMeshLevel(const TopoDS_Shape& theShape, double thePixelSize);
+
+  //! Attach cached tessellation level to the shape and recompute its presentation.
+  //! Requests background meshing and returns FALSE if the level is not cached yet;
+  //! replays mesh the level synchronously instead.
+  bool applyMeshLevel(const Handle(AIS_Shape)& theShape, int theLevel);
+
+  //! Evict detail of hidden or off-screen shapes while over the memory budget
+  //! and rebuild evicted shapes entering a view.
+  void updateMemoryBudget(double theTime);
+
+  //! Return views of visible panels.
+  std::vector<Handle(V3d_View)> visibleViews() const;
+
+  //! Return the smallest size of a screen pixel in model units among views of visible panels;
+  //! tessellation levels are chosen for the view showing the scene in most detail.
+  double finestPixelSize() const;
+
+  //! Render the tessellation section of the "Settings" panel.
+  void renderTessellationSettings();
+
+  //! Render the culling section of the "Settings" panel.
+  void renderCullingSettings();
+
+  //! Render the rendering quality section of the "Settings" panel.
+  void renderQualitySettings();
+
+  //! Render the frame pacing section of the "Settings" panel.
+  void renderPacingSettings();
+
+  //! Render the memory section of the "Settings" panel.
+  void renderMemorySettings();
+
+  //! Render the profiler section of the "Settings" panel.
+  void renderProfilerSettings();
+
   //! Clean up before .
-  void cleanup() const;
+  void cleanup();
+
+  //! Return TRUE if a mouse gesture rotating, panning or zooming the camera is in progress.
+  bool isCameraGesture() const;
+
+  //! Return TRUE if the camera is being changed by a gesture, mouse wheel or animation.
+  bool isCameraInteraction() const;
+
+  //! Handle dynamic highlighting; detection is skipped during camera gestures
+  //! and throttled to the detection cost.
+  void handleDynamicHighlight(const Handle(AIS_InteractiveContext)& theCtx,
+                              const Handle(V3d_View)&               theView) override;
 
   //! Handle view redraw.
   void handleViewRedraw(const Handle(AIS_InteractiveContext)& theCtx,
                         const Handle(V3d_View)&               theView) override;
 
-  //! @name GLWF callbacks
+  //! Return OpenGL context of the viewer or NULL if the viewer has not been created.
+  Handle(OpenGl_Context) glContext() const;
+
+  //! Wait until the GPU has finished all pending commands of the view's OpenGL context.
+  void finishGpu() const;
+
+  //! @name GLWF callbacks, only queueing events for applyInputEvents()
 private:
   //! Window resize event.
   void onResize(int theWidth, int theHeight);
@@ -59,6 +336,21 @@ private:
   //! Mouse move event.
   void onMouseMove(int thePosX, int thePosY);
 
+  //! Key event, handled only with a render thread; ImGui receives it through the command queue.
+  void onKey(int theKey, int theAction, int theMods);
+
+  //! Text input event, handled only with a render thread.
+  void onChar(unsigned int theCodepoint);
+
+  //! Window focus event, handled only with a render thread.
+  void onFocus(bool theIsFocused);
+
+  //! Cursor entering or leaving the window, handled only with a render thread.
+  void onCursorEnter(bool theIsEntered);
+
+  //! Append an event to the input recording, if recording.
+  void recordInput(OccImguiInputRecording::Event theEvent);
+
   //! @name GLWF callbacks (static functions)
 private:
   //! GLFW callback redirecting messages into Message::DefaultMessenger().
@@ -102,13 +394,139 @@ private:
     toView(theWin)->onMouseMove(static_cast<int>(thePosX), static_cast<int>(thePosY));
   }
 
-private:
+  //! Key callback.
+  static void onKeyCallback(GLFWwindow* theWin,
+                            const int   theKey,
+                            const int /*theScancode*/,
+                            const int   theAction,
+                            const int   theMods)
+  {
+    toView(theWin)->onKey(theKey, theAction, theMods);
+  }
+
+  //! Text input callback.
+  static void onCharCallback(GLFWwindow* theWin, const unsigned int theCodepoint)
+  {
+    toView(theWin)->onChar(theCodepoint);
+  }
+
+  //! Window focus callback.
+  static void onFocusCallback(GLFWwindow* theWin, const int theIsFocused)
+  {
+    toView(theWin)->onFocus(theIsFocused != 0);
+  }
+
+  //! Cursor enter callback.
+  static void onCursorEnterCallback(GLFWwindow* theWin, const int theIsEntered)
+  {
+    toView(theWin)->onCursorEnter(theIsEntered != 0);
+  }
+
+protected:
   Handle(GlfwOcctWindow)         myOcctWindow;
-  Handle(V3d_View)               myView;
+  Handle(V3d_View)               myView; //!< view of the active panel
   Handle(AIS_InteractiveContext) myContext;
   bool                           myToWaitEvents = true;
+  bool                           myIsHeadless   = false;
+
+  // Input events coalesced per frame
+  OccImguiInputQueue                     myInputQueue;
+  std::vector<OccImguiInputQueue::Event> myInputEvents;
+
+  // Input recording; replays drive frames by a fixed clock and ignore window input
+  OccImguiInputRecording myInputRecording;
+  std::string            myRecordPath;
+  double                 myRecordStartTime = -1.0; //!< negative until recording has started
+  double                 myFrameClock      = -1.0; //!< fixed frame time, negative if not replaying
+  double                 myFrameClockStep  = 0.0;  //!< fixed frame step of replays
+
+  // Dedicated render thread owning the OpenGL context, fed with window events by the event thread
+  OccImguiSpscQueue<RenderCommand> myRenderCommands{4096};
+  std::deque<RenderCommand>        myRenderBacklog; //!< events of the event thread not queued yet
+  std::thread                      myRenderThread;
+  std::mutex                       myRenderMutex; //!< only guards sleeping of the render thread
+  std::condition_variable          myRenderCondition;
+  std::atomic<bool>                myIsRenderSleeping{false};
+  std::atomic<bool>                myIsRenderWoken{false};
+  std::atomic<bool>                myToStopRender{false};
+  bool                             myIsRenderThread = false;
+  Graphic3d_Vec2i                  myWindowSize;      //!< window size of the render thread
+  Graphic3d_Vec2i                  myFramebufferSize; //!< framebuffer size of the render thread
+  double                           myGuiTime = 0.0;   //!< time of the last GUI frame, in seconds
+
+  // Tessellation levels
+  OccImguiMeshDiskCache        myMeshDiskCache;
+  OccImguiMeshLodCache         myMeshCache;
+  double                       myMeshLevelPixelSize  = 0.0; //!< pixel size of the last update
+  double                       myMeshLevelUpdateTime = 0.0;
+  int                          myMeshLevel           = OccImguiMeshLodCache::Level_Medium;
+  bool                         myIsAutoMeshLevel     = true;
+  bool                         myToUpdateMeshLevels  = false;
+
+  // Frame rate limits, adaptive swap interval and input-to-present latency
+  OccImguiFramePacer myFramePacer;
+  int                mySwapInterval = -2; //!< swap interval of the window, -2 until set
+
+  // GPU buffers and triangulations of hidden or off-screen shapes dropped while over the budget
+  OccImguiMemoryBudget myMemoryBudget;
+
+  // Bounding box proxies of shapes covering few pixels; re-evaluated after camera changes
+  OccImguiSceneLod mySceneLod;
+
+  // Reduced resolution during camera interaction
+  OccImguiAdaptiveResolution myAdaptiveResolution;
+  double                     myDegradedFrameTime = 0.0; //!< last frame redrawn at reduced quality
+
+  // Background file import
+  OccImguiImporter        myImporter{myMeshCache};
+  TCollection_AsciiString myPendingImport;
+  std::array<char, 1024>  myImportPath{};
+  size_t                  myNbImportedObjects = 0;
+  bool                    myIsImportFitted    = false; //!< view has been fit to the first objects
+
+  // Background modeling operations on selected shapes
+  OccImguiModeling        myModeling{myMeshCache};
+  TCollection_AsciiString myModelingMessage; //!< outcome of the last finished task
+  int                     myModelingOperation = OccImguiModeling::Operation_Fuse;
+  double                  myModelingValue     = 2.0; //!< fillet radius or offset distance
+
+  // "Scene" panel; objects are identified by their index in mySceneObjects
+  OccImguiSceneIndex mySceneIndex{
+    [this](size_t theId, std::string& theName, std::string& theAttributes) {
+      sceneObjectText(theId, theName, theAttributes);
+    }};
+  std::vector<Handle(AIS_InteractiveObject)>               mySceneObjects;
+  std::unordered_map<const AIS_InteractiveObject*, size_t> mySceneObjectIds;
+  std::array<char, 256>                                    mySceneFilter{};
+  const AIS_InteractiveObject*                             mySceneSelection      = nullptr;
+  bool                                                     myIsScenePanelVisible = false;
+
+  // Offscreen views of the shared viewer, the first one is the main "3D View" panel
+  std::vector<std::unique_ptr<ViewPanel>> myViewPanels;
+  ViewPanel*                              myActivePanel    = nullptr;
+  unsigned int                            myViewDockId     = 0; //!< dock node of the main panel
+  int                                     myNbCreatedViews = 0;
+
+  // Throttled hover detection
+  double myHoverTime      = 0.0; //!< time of the last detection, in seconds
+  double myHoverDuration  = 0.0; //!< duration of the last detection, in seconds
+  bool   myIsHoverPending = false;
+
+  // Scene redraws are tracked separately from GUI frames, which reuse the last scene image
+  size_t myNbSceneFrames = 0;
+  size_t myNbGuiFrames   = 0;
+
+  // Startup: phases until the first presented frame and after it,
+  // OCCT shader programs restored from binaries linked by earlier sessions
+  OccImguiStartupTimeline myStartupTimeline;
+  OccImguiProgramCache    myProgramCache;
+  bool                    myIsStartupPending       = false; //!< completeStartup() not done yet
+  bool                    myToPrintStartupTimeline = false;
 
-  // ImGui viewport dimensions
-  int myViewportWidth  = 0;
-  int myViewportHeight = 0;
+  // Frame profiler
+  OccImguiProfiler                      myProfiler;
+  std::vector<OccImguiProfiler::Sample> myProfilerSamples;
+  std::vector<float>                    myProfilerGraphs;
+  std::array<char, 1024>                myTracePath{};
+  TCollection_AsciiString               myTraceStatus;
 };
@@ -35,6 +35,14 @@ public:
   //! Return cursor position.
   Graphic3d_Vec2i CursorPosition() const;
 
+  //! Update the window size reported by GLFW callbacks; unlike DoResize(),
+  //! never queries GLFW and may be used by threads other than the main one.
+  void SetSize(const Graphic3d_Vec2i& theSize)
+  {
+    myXRight  = myXLeft + theSize.x();
+    myYBottom = myYTop + theSize.y();
+  }
+
 public:
   //! Returns native Window handle
   Aspect_Drawable NativeHandle() const override;
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "occ-imgui-mesh-lod-cache.h"
+#include "occ-imgui-progress.h"
+
+#include <opencascade/AIS_InteractiveObject.hxx>
+#include <opencascade/Message_ProgressRange.hxx>
+#include <opencascade/TCollection_AsciiString.hxx>
+#include <opencascade/TopoDS_Shape.hxx>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! Background import of STEP, IGES and BREP files and of STL, OBJ and glTF meshes.
+//! Reading, transfer and meshing run on worker threads; finished presentable objects are queued
+//! and handed over to the GUI thread in batches by fetch(). Once the file has been transferred,
+//! bounding box placeholders of all parts are queued first; parts are then meshed largest first
+//! in growing chunks, each replacing the placeholder of its chunk.
+//! Parts are meshed through the mesh cache, so their triangulation levels can be swapped later;
+//! imported meshes keep their own triangulation.
+//! Parts sharing a TShape (e.g. repeated fasteners) become AIS_ConnectedInteractive instances
+//! of one undisplayed AIS_Shape, so all of them share its presentation and vertex buffers.
+class OccImguiImporter
+{
+public:
+  //! Object handed over to the GUI thread.
+  struct ImportedObject
+  {
+    Handle(AIS_InteractiveObject) Object;      //!< part or placeholder to display, may be null
+    Handle(AIS_InteractiveObject) Placeholder; //!< placeholder to remove once Object is displayed
+  };
+
+  //! Import state.
+  enum State
+  {
+    State_Idle,      //!< nothing has been imported yet
+    State_Running,   //!< worker thread is reading, transferring or meshing
+    State_Finished,  //!< all objects have been queued
+    State_Cancelled, //!< import was cancelled by the user
+    State_Failed     //!< file could not be read
+  };
+
+public:
+  //! Main constructor.
+  explicit OccImguiImporter(OccImguiMeshLodCache& theMeshCache)
+      : myMeshCache(theMeshCache)
+  {
+  }
+
+  //! Destructor cancelling and joining the worker thread.
+  ~OccImguiImporter();
+
+  //! Return TRUE if the file extension is supported.
+  static bool isSupportedFile(const TCollection_AsciiString& thePath);
+
+  //! Read the file and transfer it into a shape on the calling thread.
+  static TopoDS_Shape readShape(const TCollection_AsciiString& thePath,
+                                const Message_ProgressRange&   theProgress);
+
+  //! Set callback invoked from the worker thread when new objects have been queued.
+  void setWakeupCallback(const std::function<void()>& theCallback) { myWakeup = theCallback; }
+
+  //! Start importing the file on a worker thread; returns FALSE if an import is already running.
+  //! Objects still queued by the previous import are fetched first.
+  bool start(const TCollection_AsciiString& thePath);
+
+  //! Request cancellation of the running import.
+  void cancel();
+
+  //! Wait for the worker thread to finish.
+  void wait();
+
+  //! Return current state.
+  State state() const { return myState; }
+
+  //! Return TRUE if the worker thread is running.
+  bool isRunning() const { return myState == State_Running; }
+
+  //! Return normalized progress within [0, 1].
+  double progress() const { return myProgress.IsNull() ? 0.0 : myProgress->GetPosition(); }
+
+  //! Return the name of the current import step.
+  TCollection_AsciiString stepName() const
+  {
+    return myProgress.IsNull() ? TCollection_AsciiString() : myProgress->stepName();
+  }
+
+  //! Return the path of the last started import.
+  const TCollection_AsciiString& filePath() const { return myFilePath; }
+
+  //! Return the error message of a failed import.
+  TCollection_AsciiString errorMessage() const;
+
+  //! Return number of parts queued by the last import.
+  size_t nbParts() const { return myNbParts; }
+
+  //! Return number of parts of the last import queued as instances of shared geometry.
+  size_t nbInstances() const { return myNbInstances; }
+
+  //! Return number of shared geometries referenced by instances of the last import.
+  size_t nbPrototypes() const { return myNbPrototypes; }
+
+  //! Return TRUE if finished objects are waiting to be displayed.
+  bool hasPendingObjects() const;
+
+  //! Move up to theMaxNbObjects finished objects into theObjects; returns number of moved objects.
+  size_t fetch(std::vector<ImportedObject>& theObjects, size_t theMaxNbObjects);
+
+private:
+  //! Worker thread body.
+  void perform(const TCollection_AsciiString&  thePath,
+               const Handle(OccImguiProgress)& theProgress);
+
+  //! Queue placeholders of all parts, then mesh parts in parallel and queue them for display,
+  //! the largest parts first.
+  void meshAndQueue(std::vector<TopoDS_Shape>    theParts,
+                    const Message_ProgressRange& theProgress);
+
+private:
+  OccImguiMeshLodCache&      myMeshCache;
+  std::thread                myThread;
+  std::function<void()>      myWakeup;
+  Handle(OccImguiProgress)   myProgress;
+  TCollection_AsciiString    myFilePath;
+  std::atomic<State>         myState{State_Idle};
+  std::atomic<size_t>        myNbParts{0};
+  std::atomic<size_t>        myNbInstances{0};
+  std::atomic<size_t>        myNbPrototypes{0};
+  mutable std::mutex         myMutex;
+  std::deque<ImportedObject> myQueue;
+  TCollection_AsciiString    myError;
+};
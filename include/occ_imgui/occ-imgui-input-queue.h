@@ -0,0 +1,69 @@
+#pragma once
+
+#include <opencascade/Graphic3d_Vec.hxx>
+
+#include <cstddef>
+#include <vector>
+
+//! Queue collecting window input events between frames.
+//! Consecutive mouse moves collapse into the latest position and consecutive scrolls accumulate
+//! their deltas, while the order relative to button events is preserved; window resizes are
+//! debounced, so that only the final size is applied once it has settled.
+class OccImguiInputQueue
+{
+public:
+  //! Event type.
+  enum EventType
+  {
+    EventType_MouseMove,
+    EventType_MouseButton,
+    EventType_Scroll
+  };
+
+  //! Input event; positions are in window coordinates.
+  struct Event
+  {
+    EventType       Type = EventType_MouseMove;
+    Graphic3d_Vec2i Position;
+    int             Button      = 0;   //!< button of EventType_MouseButton
+    int             Action      = 0;   //!< press or release of EventType_MouseButton
+    int             Mods        = 0;   //!< key modifiers of EventType_MouseButton
+    double          ScrollDelta = 0.0; //!< accumulated vertical offset of EventType_Scroll
+  };
+
+public:
+  //! Queue cursor movement.
+  void pushMouseMove(const Graphic3d_Vec2i& thePos);
+
+  //! Queue mouse button press or release.
+  void pushMouseButton(const Graphic3d_Vec2i& thePos, int theButton, int theAction, int theMods);
+
+  //! Queue mouse wheel scroll.
+  void pushScroll(const Graphic3d_Vec2i& thePos, double theDelta);
+
+  //! Record window resize at theTime (in seconds).
+  void pushResize(const Graphic3d_Vec2i& theSize, double theTime);
+
+  //! Move queued events into theEvents in arrival order.
+  void takeEvents(std::vector<Event>& theEvents);
+
+  //! Return TRUE if a resize is waiting for the window size to settle.
+  bool hasPendingResize() const { return myHasResize; }
+
+  //! Return TRUE and the final window size if no resize has arrived during theDelay seconds.
+  bool takeResize(double theTime, double theDelay, Graphic3d_Vec2i& theSize);
+
+  //! Return number of events received since construction.
+  size_t nbReceived() const { return myNbReceived; }
+
+  //! Return number of events handed out by takeEvents() since construction.
+  size_t nbApplied() const { return myNbApplied; }
+
+private:
+  std::vector<Event> myEvents;
+  Graphic3d_Vec2i    myResizeSize;
+  double             myResizeTime = 0.0;
+  bool               myHasResize  = false;
+  size_t             myNbReceived = 0;
+  size_t             myNbApplied  = 0;
+};
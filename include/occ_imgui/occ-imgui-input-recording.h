@@ -0,0 +1,80 @@
+#pragma once
+
+#include <opencascade/Graphic3d_Vec.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! Timestamped window input events recorded for deterministic replays.
+//! The file stores the initial window size, the path of the opened model and the events as
+//! variable-length little-endian records with microsecond time deltas, so that a minute of mouse
+//! input takes a few tens of kilobytes.
+class OccImguiInputRecording
+{
+public:
+  //! Event type.
+  enum EventType
+  {
+    EventType_MouseMove,
+    EventType_MouseButton,
+    EventType_Scroll,
+    EventType_Resize,
+    EventType_NB
+  };
+
+  //! Recorded event; positions are in window coordinates.
+  struct Event
+  {
+    double          Time = 0.0; //!< seconds since the start of recording
+    EventType       Type = EventType_MouseMove;
+    Graphic3d_Vec2i Position;          //!< cursor position, or window size of EventType_Resize
+    int             Button      = 0;   //!< button of EventType_MouseButton
+    int             Action      = 0;   //!< press or release of EventType_MouseButton
+    int             Mods        = 0;   //!< key modifiers of EventType_MouseButton
+    double          ScrollDelta = 0.0; //!< vertical offset of EventType_Scroll
+  };
+
+public:
+  //! Return initial window size.
+  const Graphic3d_Vec2i& windowSize() const { return myWindowSize; }
+
+  //! Set initial window size.
+  void setWindowSize(const Graphic3d_Vec2i& theSize) { myWindowSize = theSize; }
+
+  //! Return path of the model opened at the start of recording, or an empty string.
+  const std::string& modelPath() const { return myModelPath; }
+
+  //! Set path of the model opened at the start of recording.
+  void setModelPath(const std::string& thePath) { myModelPath = thePath; }
+
+  //! Return events in time order.
+  const std::vector<Event>& events() const { return myEvents; }
+
+  //! Return time of the last event in seconds.
+  double duration() const { return myEvents.empty() ? 0.0 : myEvents.back().Time; }
+
+  //! Remove all events.
+  void clear() { myEvents.clear(); }
+
+  //! Append an event; times earlier than the last event are clamped to keep the order.
+  void add(const Event& theEvent);
+
+  //! Encode the recording into file data.
+  void encode(std::vector<uint8_t>& theData) const;
+
+  //! Decode file data; returns FALSE if the data is not a recording or is truncated.
+  bool decode(const uint8_t* theData, size_t theSize);
+
+  //! Write the recording into the file.
+  bool write(const std::string& thePath) const;
+
+  //! Read the recording from the file.
+  bool read(const std::string& thePath);
+
+private:
+  std::vector<Event> myEvents;
+  std::string        myModelPath;
+  Graphic3d_Vec2i    myWindowSize;
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+//! Read-only memory mapping of a whole file.
+class OccImguiMappedFile
+{
+public:
+  //! Default constructor.
+  OccImguiMappedFile() = default;
+
+  //! Destructor unmapping the file.
+  ~OccImguiMappedFile() { close(); }
+
+  OccImguiMappedFile(const OccImguiMappedFile&)            = delete;
+  OccImguiMappedFile& operator=(const OccImguiMappedFile&) = delete;
+
+  //! Map the file; returns FALSE if the file cannot be opened or is empty.
+  bool open(const std::filesystem::path& thePath);
+
+  //! Unmap the file.
+  void close();
+
+  //! Return TRUE if a file is mapped.
+  bool isOpen() const { return myData != nullptr; }
+
+  //! Return pointer to the mapped file content.
+  const uint8_t* data() const { return myData; }
+
+  //! Return size of the mapped file content in bytes.
+  size_t size() const { return mySize; }
+
+private:
+  const uint8_t* myData = nullptr;
+  size_t         mySize = 0;
+#if defined(_WIN32)
+  void* myFile    = nullptr;
+  void* myMapping = nullptr;
+#endif
+};
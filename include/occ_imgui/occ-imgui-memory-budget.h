@@ -0,0 +1,133 @@
+#pragma once
+
+#include "occ-imgui-mesh-lod-cache.h"
+
+#include <opencascade/AIS_InteractiveContext.hxx>
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/Graphic3d_WorldViewProjState.hxx>
+#include <opencascade/OpenGl_Context.hxx>
+#include <opencascade/TCollection_AsciiString.hxx>
+#include <opencascade/V3d_View.hxx>
+
+#include <cstddef>
+#include <unordered_set>
+#include <vector>
+
+//! Memory accounting of displayed shapes and eviction of their detail under a budget.
+//! Memory of a shape covers the vertex buffers of its presentations and the triangulations cached
+//! for it, shared by all its instances. While the total exceeds the budget, shapes which are hidden
+//! or outside of every view lose their presentations (releasing GPU buffers) and all tessellation
+//! levels except the coarse one, largest first; they are rebuilt once they enter a view again.
+class OccImguiMemoryBudget
+{
+public:
+  //! Memory of one shape.
+  struct ShapeMemory
+  {
+    Handle(AIS_Shape) Shape;
+    size_t            GpuBytes  = 0;     //!< estimated size of vertex and index buffers
+    size_t            MeshBytes = 0;     //!< cached triangulations of all levels
+    bool              IsHidden  = true;  //!< neither the shape nor its instances are displayed
+    bool              IsVisible = false; //!< the shape or one of its instances is within a view
+    bool              IsEvicted = false; //!< presentations have been cleared
+  };
+
+  //! Memory usage summary; process counters are (size_t)-1 where unavailable.
+  struct Stats
+  {
+    size_t HeapBytes       = size_t(-1); //!< heap usage of the process
+    size_t WorkingSetBytes = size_t(-1); //!< resident memory of the process
+    size_t GpuFreeBytes    = 0;          //!< free video memory reported by the driver, or 0
+    size_t GpuBytes        = 0;          //!< estimated vertex buffers of displayed shapes
+    size_t MeshBytes       = 0;          //!< cached triangulations of accounted shapes
+    size_t NbEvicted       = 0;          //!< shapes currently evicted
+    size_t NbEvictions     = 0;          //!< evictions since start
+  };
+
+public:
+  //! Return estimated size of vertex and index buffers of the object presentations in bytes.
+  static size_t presentationSize(const Handle(PrsMgr_PresentableObject)& theObject);
+
+  //! Return TRUE if the box may be visible within the view enlarged by theMargin;
+  //! boxes crossing the eye plane of a perspective camera are considered visible.
+  static bool isInView(const Bnd_Box& theBox, const Handle(V3d_View)& theView, double theMargin);
+
+public:
+  //! Return TRUE if detail is evicted while over the budget.
+  bool isEnabled() const { return myIsEnabled; }
+
+  //! Enable or disable eviction; evicted shapes are restored by the next update() when disabled.
+  void setEnabled(const bool theIsEnabled)
+  {
+    myIsEnabled = theIsEnabled;
+    myToUpdate  = true;
+  }
+
+  //! Return memory budget in bytes.
+  size_t budget() const { return myBudget; }
+
+  //! Set memory budget in bytes.
+  void setBudget(const size_t theBytes)
+  {
+    myBudget   = theBytes;
+    myToUpdate = true;
+  }
+
+  //! Return memory usage summary of the last accounting.
+  const Stats& stats() const { return myStats; }
+
+  //! Return shapes of the last accounting ordered by decreasing memory.
+  const std::vector<ShapeMemory>& shapes() const { return myShapes; }
+
+  //! Return TRUE if presentations of the shape have been cleared by the budget.
+  bool isEvicted(const Handle(AIS_Shape)& theShape) const
+  {
+    return myEvicted.count(theShape.get()) != 0;
+  }
+
+  //! Return video memory description of the OpenGL driver.
+  const TCollection_AsciiString& gpuInfo() const { return myGpuInfo; }
+
+  //! Account memory, restore evicted shapes entering a view and evict hidden or off-screen shapes
+  //! while over the budget. Accounting runs every theInterval seconds, or earlier after camera
+  //! changes while some shapes are evicted.
+  //! @param[in]  theCtx        interactive context
+  //! @param[in]  theViews      views to test visibility against
+  //! @param[in]  theMeshCache  cache of tessellation levels
+  //! @param[in]  theGlCtx      OpenGL context for video memory info, may be null
+  //! @param[in]  theTime       current time in seconds
+  //! @param[in]  theInterval   minimal interval between accountings triggered by camera changes
+  //! @param[out] theRestored   evicted shapes to be displayed again at their proper level
+  //! @return TRUE if any presentation has been cleared
+  bool update(const Handle(AIS_InteractiveContext)& theCtx,
+              const std::vector<Handle(V3d_View)>&  theViews,
+              OccImguiMeshLodCache&                 theMeshCache,
+              const Handle(OpenGl_Context)&         theGlCtx,
+              double                                theTime,
+              double                                theInterval,
+              std::vector<Handle(AIS_Shape)>&       theRestored);
+
+private:
+  //! Recompute memory and visibility of all displayed and hidden shapes.
+  void account(const Handle(AIS_InteractiveContext)& theCtx,
+               const std::vector<Handle(V3d_View)>&  theViews,
+               const OccImguiMeshLodCache&           theMeshCache,
+               const Handle(OpenGl_Context)&         theGlCtx);
+
+  //! Clear presentations of the shape and drop its detailed tessellation levels.
+  void evict(ShapeMemory& theShape, OccImguiMeshLodCache& theMeshCache);
+
+  //! Return size of triangulations cached for accounted shapes, counting shared TShapes once.
+  size_t meshBytes(const OccImguiMeshLodCache& theMeshCache) const;
+
+private:
+  std::vector<ShapeMemory>                  myShapes;
+  std::unordered_set<const AIS_Shape*>      myEvicted;
+  std::vector<Graphic3d_WorldViewProjState> myCameraStates;
+  TCollection_AsciiString                   myGpuInfo;
+  Stats                                     myStats;
+  double                                    myUpdateTime = -1.0;
+  size_t                                    myBudget     = size_t(2048) << 20;
+  bool                                      myIsEnabled  = true;
+  bool                                      myToUpdate   = true;
+};
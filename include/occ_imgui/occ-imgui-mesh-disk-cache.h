@@ -0,0 +1,81 @@
+#pragma once
+
+#include <opencascade/Poly_Triangulation.hxx>
+#include <opencascade/TopoDS_Shape.hxx>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+//! Persistent cache of face triangulations stored in a directory.
+//! Each entry holds the triangulations (nodes, normals, UV nodes and triangles) of all faces of
+//! one shape for one tessellation level in a compact binary file named by a hash of the shape
+//! content and the meshing parameters. Entries are memory-mapped on load; least recently used
+//! entries are evicted once the directory exceeds the size limit.
+class OccImguiMeshDiskCache
+{
+public:
+  //! Return default cache directory, taken from OCC_IMGUI_MESH_CACHE_DIR environment variable
+  //! or placed into the temporary directory.
+  static std::filesystem::path defaultDirectory();
+
+  //! Return default size limit, taken from OCC_IMGUI_MESH_CACHE_SIZE_MB environment variable.
+  static uint64_t defaultSizeLimit();
+
+  //! Compute the key of the shape geometry; the key does not depend on the shape location.
+  //! Serializes the whole shape, so it should be computed once per shape.
+  static uint64_t shapeKey(const TopoDS_Shape& theShape);
+
+  //! Combine the shape key with meshing parameters into the key of an entry.
+  static uint64_t levelKey(uint64_t theShapeKey, double theDeflection, double theAngle);
+
+public:
+  //! Main constructor.
+  OccImguiMeshDiskCache(const std::filesystem::path& theDirectory = defaultDirectory(),
+                        uint64_t                     theSizeLimit = defaultSizeLimit());
+
+  //! Return cache directory.
+  const std::filesystem::path& directory() const { return myDirectory; }
+
+  //! Return size limit in bytes.
+  uint64_t sizeLimit() const { return mySizeLimit; }
+
+  //! Return current size of the cache directory in bytes.
+  uint64_t size() const { return mySize; }
+
+  //! Return number of entries found since construction.
+  uint64_t nbHits() const { return myNbHits; }
+
+  //! Return number of entries not found since construction.
+  uint64_t nbMisses() const { return myNbMisses; }
+
+  //! Load triangulations of theNbFaces faces; returns FALSE if the entry is missing or invalid.
+  //! Thread-safe.
+  bool load(uint64_t                                 theKey,
+            size_t                                   theNbFaces,
+            std::vector<Handle(Poly_Triangulation)>& theTriangulations);
+
+  //! Store triangulations of all faces and evict old entries exceeding the size limit.
+  //! Thread-safe.
+  void store(uint64_t theKey, const std::vector<Handle(Poly_Triangulation)>& theTriangulations);
+
+  //! Remove all entries.
+  void clear();
+
+private:
+  //! Return path of the entry file.
+  std::filesystem::path entryPath(uint64_t theKey) const;
+
+  //! Remove least recently used entries until the cache fits into the size limit.
+  void evict();
+
+private:
+  std::filesystem::path myDirectory;
+  uint64_t              mySizeLimit = 0;
+  std::atomic<uint64_t> mySize{0};
+  std::atomic<uint64_t> myNbHits{0};
+  std::atomic<uint64_t> myNbMisses{0};
+  std::mutex            myEvictMutex;
+};
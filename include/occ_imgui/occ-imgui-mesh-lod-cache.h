@@ -0,0 +1,165 @@
+#pragma once
+
+#include "occ-imgui-mesh-disk-cache.h"
+
+#include <opencascade/Poly_Triangulation.hxx>
+#include <opencascade/Standard_Transient.hxx>
+#include <opencascade/TopoDS_Face.hxx>
+#include <opencascade/TopoDS_Shape.hxx>
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+//! Cache of several tessellation levels per shape.
+//! Each level is meshed once with BRepMesh_IncrementalMesh (in parallel across shapes and faces)
+//! on a topological copy of the shape, so meshing never touches faces being displayed;
+//! switching the level later only re-attaches cached triangulations to the faces.
+//! Shapes are identified by their TShape, so instances of the same part share the cache entry.
+//! An optional disk cache persists meshed levels between sessions.
+class OccImguiMeshLodCache
+{
+public:
+  //! Tessellation level.
+  enum Level
+  {
+    Level_Coarse,
+    Level_Medium, //!< matches default deflection of AIS_Shape
+    Level_Fine,
+    Level_NB
+  };
+
+  //! Level meshed in background and ready for activation.
+  struct ReadyLevel
+  {
+    TopoDS_Shape               Shape;
+    int                        Level = Level_Medium;
+    Handle(Standard_Transient) Owner; //!< object passed to requestAsync()
+  };
+
+public:
+  //! Return level name.
+  static const char* levelName(int theLevel);
+
+  //! Return relative deviation coefficient of the level.
+  static double deviationCoefficient(int theLevel);
+
+  //! Return angular deflection of the level in radians.
+  static double deviationAngle(int theLevel);
+
+  //! Return estimated size of the triangulation arrays in bytes.
+  static size_t triangulationSize(const Handle(Poly_Triangulation)& theTriangulation);
+
+public:
+  //! Default constructor.
+  OccImguiMeshLodCache() = default;
+
+  //! Destructor stopping the background thread.
+  ~OccImguiMeshLodCache();
+
+  //! Set callback invoked from the background thread when requested levels become ready.
+  void setWakeupCallback(const std::function<void()>& theCallback);
+
+  //! Set persistent cache consulted before meshing and filled after it; may be nullptr.
+  //! Should be set before any meshing starts.
+  void setDiskCache(OccImguiMeshDiskCache* theCache) { myDiskCache = theCache; }
+
+  //! Compute missing triangulations of the level for all shapes.
+  //! Runs in parallel across shapes and faces; safe to call from any thread.
+  void mesh(const std::vector<TopoDS_Shape>& theShapes, int theLevel);
+
+  //! Return TRUE if faces of the shape carry imported triangulations without surfaces;
+  //! such shapes keep their own triangulation and are never meshed into levels.
+  bool isMeshOnly(const TopoDS_Shape& theShape) { return findOrCreateEntry(theShape)->IsMeshOnly; }
+
+  //! Return TRUE if the level of the shape has been meshed.
+  bool hasLevel(const TopoDS_Shape& theShape, int theLevel) const;
+
+  //! Return absolute linear deflection of the level for the shape.
+  double deflection(const TopoDS_Shape& theShape, int theLevel);
+
+  //! Return currently attached level of the shape or -1 if none.
+  int activeLevel(const TopoDS_Shape& theShape) const;
+
+  //! Attach cached triangulations of the level to the shape faces.
+  //! Returns FALSE if the level has not been meshed yet.
+  //! Should be called while no presentation of the shape is being computed.
+  bool activate(const TopoDS_Shape& theShape, int theLevel);
+
+  //! Queue meshing of the level on the background thread; the shape should already have an entry,
+  //! i.e. have been meshed or queried before, as requests of unknown shapes are skipped.
+  void requestAsync(const TopoDS_Shape&               theShape,
+                    int                               theLevel,
+                    const Handle(Standard_Transient)& theOwner);
+
+  //! Move levels meshed in background since the last call into theLevels.
+  size_t takeReady(std::vector<ReadyLevel>& theLevels);
+
+  //! Remove all cached triangulations.
+  void clear();
+
+  //! Remove cached levels of the shape, e.g. once it has been replaced or removed from the scene;
+  //! faces keep the attached triangulation. Pending background requests of the shape are dropped.
+  void erase(const TopoDS_Shape& theShape);
+
+  //! Return estimated size of all cached triangulations in bytes.
+  size_t memorySize() const;
+
+  //! Return estimated size of cached triangulations of the shape in bytes;
+  //! for mesh-only shapes, the size of their imported triangulations.
+  size_t memorySize(const TopoDS_Shape& theShape) const;
+
+  //! Drop cached levels of the shape except theKeepLevel and the active one;
+  //! dropped levels are meshed again (or read from the disk cache) when requested.
+  //! Returns estimated number of released bytes.
+  size_t release(const TopoDS_Shape& theShape, int theKeepLevel);
+
+private:
+  //! Cached tessellation levels of one shape.
+  struct Entry
+  {
+    TopoDS_Shape                                                  Shape;
+    std::vector<TopoDS_Face>                                      Faces;
+    std::array<double, Level_NB>                                  Deflections{};
+    std::array<std::vector<Handle(Poly_Triangulation)>, Level_NB> Triangulations;
+    std::once_flag                                                DiskKeyFlag;
+    uint64_t                                                      DiskKey     = 0;
+    int                                                           ActiveLevel = -1;
+    bool                                                          IsMeshOnly  = false;
+  };
+
+  //! Return estimated size of triangulations of the entry; should be called under the lock.
+  static size_t entrySize(const Entry& theEntry);
+
+  //! Return existing entry of the shape or nullptr.
+  std::shared_ptr<Entry> findEntry(const TopoDS_Shape& theShape) const;
+
+  //! Return existing entry of the shape or create a new one.
+  std::shared_ptr<Entry> findOrCreateEntry(const TopoDS_Shape& theShape);
+
+  //! Compute missing triangulations of the level for all entries.
+  void meshEntries(const std::vector<std::shared_ptr<Entry>>& theEntries, int theLevel);
+
+  //! Background thread body.
+  void processRequests();
+
+private:
+  std::unordered_map<const TopoDS_TShape*, std::shared_ptr<Entry>> myEntries;
+  mutable std::mutex                                               myMutex;
+  OccImguiMeshDiskCache*                                           myDiskCache = nullptr;
+
+  // Background meshing
+  std::thread             myThread;
+  std::condition_variable myCondition;
+  std::deque<ReadyLevel>  myRequests;
+  std::vector<ReadyLevel> myReady;
+  std::function<void()>   myWakeup;
+  bool                    myToStop = false;
+};
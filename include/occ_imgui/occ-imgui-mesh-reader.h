@@ -0,0 +1,50 @@
+#pragma once
+
+#include <opencascade/Message_ProgressRange.hxx>
+#include <opencascade/Poly_Triangulation.hxx>
+#include <opencascade/TCollection_AsciiString.hxx>
+#include <opencascade/TopoDS_Shape.hxx>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! Reader of triangle mesh files (STL, OBJ, glTF).
+//! Binary STL and OBJ files are memory-mapped and parsed in parallel chunks directly into
+//! single-precision Poly_Triangulation arrays, without intermediate node containers; glTF files
+//! are read by RWGltf_CafReader loading buffers in parallel. The result is a compound of faces
+//! without surfaces carrying the triangulations, as produced by OCCT mesh readers.
+class OccImguiMeshReader
+{
+public:
+  //! Number of binary STL triangles per chunk; each chunk becomes one face.
+  static constexpr size_t THE_STL_CHUNK_SIZE = size_t(1) << 18;
+
+public:
+  //! Return TRUE if the file extension denotes a supported mesh format.
+  static bool isSupportedFile(const TCollection_AsciiString& thePath);
+
+  //! Read the mesh file; returns a null shape if the file cannot be read.
+  static TopoDS_Shape readShape(const TCollection_AsciiString& thePath,
+                                const Message_ProgressRange&   theProgress);
+
+  //! Return TRUE if the content has the size of a binary STL file with its triangle count;
+  //! other content is treated as ASCII STL.
+  static bool isBinaryStl(const uint8_t* theData, size_t theSize);
+
+  //! Parse binary STL content into triangulations of up to theChunkSize triangles each;
+  //! coincident nodes are merged within a chunk and degenerate triangles are skipped.
+  //! Returns FALSE if the content is truncated or parsing has been cancelled.
+  static bool readBinaryStl(const uint8_t*                           theData,
+                            size_t                                   theSize,
+                            size_t                                   theChunkSize,
+                            std::vector<Handle(Poly_Triangulation)>& theTriangulations,
+                            const Message_ProgressRange&             theProgress);
+
+  //! Parse OBJ content (vertices and faces; polygons are split into triangle fans) into one
+  //! triangulation. Returns a null handle if a face refers to a missing vertex or parsing
+  //! has been cancelled.
+  static Handle(Poly_Triangulation) readObj(const char*                  theData,
+                                            size_t                       theSize,
+                                            const Message_ProgressRange& theProgress);
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "occ-imgui-mesh-lod-cache.h"
+#include "occ-imgui-progress.h"
+
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/Message_ProgressRange.hxx>
+#include <opencascade/TCollection_AsciiString.hxx>
+#include <opencascade/TopoDS_Shape.hxx>
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//! Modeling operations (Booleans, fillets and offsets) running on worker threads.
+//! Each task works on topological copies of its inputs, so displayed shapes are never touched
+//! while their triangulations are swapped by the GUI thread; Booleans run in OCCT parallel mode.
+//! Tasks are cancelled through their progress indicator. Results are meshed on the worker thread
+//! and handed over to the GUI thread by fetch(), which swaps them into the target AIS_Shape
+//! within one frame.
+class OccImguiModeling
+{
+public:
+  //! Modeling operation.
+  enum Operation
+  {
+    Operation_Fuse,   //!< union of the target with the tools
+    Operation_Cut,    //!< target minus the tools
+    Operation_Common, //!< intersection of the target with the tools
+    Operation_Fillet, //!< round all sharp edges of the target
+    Operation_Offset, //!< offset all faces of the target
+    Operation_NB
+  };
+
+  //! Task state.
+  enum Status
+  {
+    Status_Running,   //!< worker thread is computing
+    Status_Finished,  //!< result is ready to be displayed
+    Status_Cancelled, //!< task was cancelled by the user
+    Status_Failed     //!< operation failed, see Task::Error
+  };
+
+  //! Modeling task; Result, Error and Duration are written by the worker thread
+  //! only before State leaves Status_Running.
+  struct Task
+  {
+    Handle(AIS_Shape)              Target; //!< shape receiving the result
+    std::vector<Handle(AIS_Shape)> Tools;  //!< tools of Booleans, consumed by the result
+    Operation                      Op    = Operation_Fuse;
+    double                         Value = 0.0; //!< fillet radius or offset distance
+    Handle(OccImguiProgress)       Progress;
+    TopoDS_Shape                   Result;
+    TCollection_AsciiString        Error;
+    double                         StartTime = 0.0; //!< steady clock time of start, in seconds
+    double                         Duration  = 0.0; //!< computation time in seconds
+    std::atomic<Status>            State{Status_Running};
+    std::thread                    Thread;
+  };
+
+public:
+  //! Return operation name.
+  static const char* operationName(int theOperation);
+
+  //! Return TRUE for Boolean operations, which need at least one tool.
+  static bool isBoolean(int theOperation)
+  {
+    return theOperation == Operation_Fuse || theOperation == Operation_Cut
+        || theOperation == Operation_Common;
+  }
+
+  //! Perform the operation on the calling thread.
+  //! @param[in] theOperation  operation
+  //! @param[in] theShape      target shape (the object of Booleans)
+  //! @param[in] theTools      tools of Booleans, ignored otherwise
+  //! @param[in] theValue      fillet radius or offset distance
+  //! @param[in] theProgress   progress range checked for cancellation
+  //! @return result, or a null shape if the operation has been cancelled;
+  //!         throws Standard_Failure if the operation fails
+  static TopoDS_Shape perform(Operation                        theOperation,
+                              const TopoDS_Shape&              theShape,
+                              const std::vector<TopoDS_Shape>& theTools,
+                              double                           theValue,
+                              const Message_ProgressRange&     theProgress);
+
+public:
+  //! Main constructor.
+  explicit OccImguiModeling(OccImguiMeshLodCache& theMeshCache)
+      : myMeshCache(theMeshCache)
+  {
+  }
+
+  //! Destructor cancelling and joining all worker threads.
+  ~OccImguiModeling();
+
+  //! Set callback invoked from worker threads when a task has finished.
+  void setWakeupCallback(const std::function<void()>& theCallback) { myWakeup = theCallback; }
+
+  //! Start the operation on a worker thread; returns FALSE if the target or one of the tools
+  //! is used by another running task, or if a Boolean has no tools.
+  bool start(Operation                             theOperation,
+             const Handle(AIS_Shape)&              theTarget,
+             const std::vector<Handle(AIS_Shape)>& theTools,
+             double                                theValue);
+
+  //! Return TRUE if the shape is the target or a tool of a running task.
+  bool isBusy(const Handle(AIS_Shape)& theShape) const;
+
+  //! Return tasks not fetched yet, in start order.
+  const std::list<std::unique_ptr<Task>>& tasks() const { return myTasks; }
+
+  //! Request cancellation of all running tasks.
+  void cancel();
+
+  //! Wait for all worker threads to finish.
+  void wait();
+
+  //! Move tasks which are no longer running into theTasks; returns number of moved tasks.
+  size_t fetch(std::vector<std::unique_ptr<Task>>& theTasks);
+
+private:
+  //! Worker thread body; theShape and theTools are topological copies made by start().
+  void run(Task&                            theTask,
+           const TopoDS_Shape&              theShape,
+           const std::vector<TopoDS_Shape>& theTools);
+
+private:
+  OccImguiMeshLodCache&            myMeshCache;
+  std::function<void()>            myWakeup;
+  std::list<std::unique_ptr<Task>> myTasks; //!< accessed by the GUI thread only
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <opencascade/Image_PixMap.hxx>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//! Minimal PNG encoder for 8-bit gray, RGB and RGBA images.
+//! Image data is stored in uncompressed deflate blocks, which keeps the encoder free of zlib
+//! and faster than compressing; thumbnails can be recompressed by external tools if needed.
+class OccImguiPngWriter
+{
+public:
+  //! Return TRUE if the pixel format can be encoded.
+  static bool isSupportedFormat(Image_Format theFormat);
+
+  //! Encode the image into PNG file data; returns FALSE for unsupported pixel formats.
+  static bool encode(const Image_PixMap& theImage, std::vector<uint8_t>& theData);
+
+  //! Encode the image and write it into the file.
+  static bool write(const Image_PixMap& theImage, const std::string& thePath);
+
+  //! Return CRC-32 of the data as used by PNG chunks.
+  static uint32_t crc32(const uint8_t* theData, size_t theSize, uint32_t theCrc = 0);
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <opencascade/OpenGl_Context.hxx>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+//! Frame profiler measuring CPU time of frame stages with scoped timers
+//! and GPU time of selected stages with OpenGL timestamp queries.
+//! Samples are stored in a fixed-size ring buffer written by the thread driving the frames
+//! without locks; readers take snapshots of the latest samples, which allows rolling graphs
+//! and export into Chrome trace format (chrome://tracing, Perfetto).
+class OccImguiProfiler
+{
+public:
+  //! Frame stage.
+  enum Stage
+  {
+    Stage_Events,          //!< polling or waiting for window events
+    Stage_Update,          //!< applying input and scene changes
+    Stage_Scene,           //!< FlushViewEvents(), including the OCCT redraw
+    Stage_GuiBuild,        //!< building ImGui frame
+    Stage_GuiRender,       //!< ImGui_ImplOpenGL3_RenderDrawData()
+    Stage_PlatformWindows, //!< rendering ImGui platform windows
+    Stage_Swap,            //!< glfwSwapBuffers()
+    Stage_NB
+  };
+
+  //! Timing sample.
+  struct Sample
+  {
+    uint64_t Frame      = 0;
+    double   BeginUs    = 0.0; //!< start time in microseconds since profiler creation
+    double   DurationUs = 0.0;
+    Stage    StageId    = Stage_Events;
+    bool     IsGpu      = false;
+  };
+
+  //! Scoped CPU timer, optionally measuring GPU time of the commands issued within the scope.
+  class Scope
+  {
+  public:
+    //! Start measuring the stage.
+    Scope(OccImguiProfiler& theProfiler, Stage theStage, bool theToTimeGpu = false);
+
+    //! Stop measuring the stage.
+    ~Scope();
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    OccImguiProfiler& myProfiler;
+    double            myBeginUs;
+    int               myGpuQuery;
+    Stage             myStage;
+  };
+
+public:
+  //! Return stage name.
+  static const char* stageName(int theStage);
+
+  //! Return TRUE if GPU time of the stage is measured.
+  static bool isGpuStage(int theStage)
+  {
+    return theStage == Stage_Scene || theStage == Stage_GuiRender;
+  }
+
+public:
+  //! Default constructor.
+  OccImguiProfiler();
+
+  //! Return TRUE if samples are recorded.
+  bool isEnabled() const { return myIsEnabled; }
+
+  //! Enable or disable recording.
+  void setEnabled(const bool theIsEnabled) { myIsEnabled = theIsEnabled; }
+
+  //! Set OpenGL context for timer queries; GPU timing is disabled if it lacks OpenGL 3.3.
+  void setGlContext(const Handle(OpenGl_Context)& theGlCtx);
+
+  //! Release timer queries; should be called while the OpenGL context is still alive.
+  void releaseGlResources();
+
+  //! Return TRUE if GPU time is measured.
+  bool hasGpuTimer() const { return !myGlCtx.IsNull(); }
+
+  //! Start a new frame and collect finished GPU queries of previous frames.
+  void beginFrame();
+
+  //! Return index of the current frame.
+  uint64_t frameIndex() const { return myFrame; }
+
+  //! Return current time in microseconds since profiler creation.
+  double nowUs() const;
+
+  //! Append a sample; single producer.
+  void push(const Sample& theSample);
+
+  //! Copy up to theMaxSamples latest samples (oldest first) into theSamples.
+  void snapshot(std::vector<Sample>& theSamples, size_t theMaxSamples) const;
+
+  //! Write the latest samples in Chrome trace event format.
+  void exportChromeTrace(std::ostream& theStream) const;
+
+private:
+  //! Issue the begin timestamp query and return its slot or -1 if GPU timing is unavailable.
+  int beginGpu(Stage theStage);
+
+  //! Issue the end timestamp query of the slot.
+  void endGpu(int theQuery);
+
+  //! Read results of finished queries into the ring buffer.
+  void collectGpu();
+
+private:
+  //! Pair of timestamp queries.
+  struct GpuQuery
+  {
+    unsigned int Queries[2] = {0, 0};
+    Stage        StageId    = Stage_Events;
+    uint64_t     Frame      = 0;
+    bool         IsPending  = false;
+  };
+
+  static constexpr size_t THE_CAPACITY = 8192;
+
+private:
+  std::array<Sample, THE_CAPACITY>      mySamples;
+  std::atomic<size_t>                   myNbWritten{0};
+  std::chrono::steady_clock::time_point myEpoch;
+  uint64_t                              myFrame     = 0;
+  bool                                  myIsEnabled = true;
+
+  // GPU timing
+  Handle(OpenGl_Context) myGlCtx;
+  std::vector<GpuQuery>  myGpuQueries;
+  double                 myGpuOffsetUs = 0.0; //!< CPU time minus GPU time
+};
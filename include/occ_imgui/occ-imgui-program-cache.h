@@ -0,0 +1,83 @@
+#pragma once
+
+#include <opencascade/OpenGl_Context.hxx>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+//! Persistent cache of linked OpenGL program binaries.
+//! Once installed into OpenGL contexts, glLinkProgram() calls of OCCT shader programs go through
+//! the cache. Programs are keyed by a hash of the driver (vendor, renderer and version strings)
+//! and of the sources of their attached shaders. Programs linked in earlier sessions are restored
+//! with glProgramBinary() instead of being linked; the others are linked from source and their
+//! binaries, taken with glGetProgramBinary(), are stored. Binaries rejected by the driver are
+//! linked from source again and replaced.
+//! Requires OpenGL 4.1 and a driver offering at least one program binary format.
+class OccImguiProgramCache
+{
+public:
+  //! Return default cache directory, taken from OCC_IMGUI_PROGRAM_CACHE_DIR environment variable
+  //! or placed into the temporary directory.
+  static std::filesystem::path defaultDirectory();
+
+  //! Compute the key of a program built from theSources by theDriver.
+  static uint64_t programKey(const std::string& theDriver, const std::string& theSources);
+
+public:
+  //! Main constructor.
+  explicit OccImguiProgramCache(const std::filesystem::path& theDirectory = defaultDirectory());
+
+  //! Destructor; contexts still using the cache go on linking from source.
+  ~OccImguiProgramCache();
+
+  OccImguiProgramCache(const OccImguiProgramCache&)            = delete;
+  OccImguiProgramCache& operator=(const OccImguiProgramCache&) = delete;
+
+  //! Return cache directory.
+  const std::filesystem::path& directory() const { return myDirectory; }
+
+  //! Redirect program linking of the context through the cache; returns FALSE if the driver
+  //! does not support program binaries. All contexts should belong to the same driver.
+  bool install(const Handle(OpenGl_Context)& theGlCtx);
+
+  //! Return TRUE if the cache has been installed into a context.
+  bool isInstalled() const { return !myGlCtx.IsNull(); }
+
+  //! Return number of programs restored from binaries.
+  size_t nbLoaded() const { return myNbLoaded; }
+
+  //! Return number of programs linked from source.
+  size_t nbLinked() const { return myNbLinked; }
+
+  //! Return number of binaries rejected by the driver.
+  size_t nbRejected() const { return myNbRejected; }
+
+  //! Load the binary and its format; returns FALSE if the entry is missing or invalid.
+  bool load(uint64_t theKey, uint32_t& theFormat, std::vector<uint8_t>& theBinary) const;
+
+  //! Store the binary and its format.
+  void store(uint64_t theKey, uint32_t theFormat, const std::vector<uint8_t>& theBinary) const;
+
+private:
+  //! glLinkProgram() replacement installed into OpenGL contexts.
+  static void APIENTRY linkProgramHook(GLuint theProgram);
+
+  //! Restore the program from its binary, or link it and store its binary.
+  void linkProgram(GLuint theProgram);
+
+  //! Return types and sources of shaders attached to the program.
+  std::string programSources(GLuint theProgram) const;
+
+  //! Return path of the entry file.
+  std::filesystem::path entryPath(uint64_t theKey) const;
+
+private:
+  std::filesystem::path  myDirectory;
+  Handle(OpenGl_Context) myGlCtx; //!< first installed context, providing GL functions
+  std::string            myDriver;
+  size_t                 myNbLoaded   = 0;
+  size_t                 myNbLinked   = 0;
+  size_t                 myNbRejected = 0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <opencascade/Message_ProgressIndicator.hxx>
+#include <opencascade/TCollection_AsciiString.hxx>
+
+#include <atomic>
+#include <mutex>
+
+//! Thread-safe progress indicator polled by the GUI thread while a worker thread is running.
+class OccImguiProgress : public Message_ProgressIndicator
+{
+  DEFINE_STANDARD_RTTI_INLINE(OccImguiProgress, Message_ProgressIndicator)
+
+public:
+  //! Default constructor.
+  OccImguiProgress() = default;
+
+  //! Request the running operation to stop at the next progress check.
+  void requestCancel() { myToCancel = true; }
+
+  //! Return TRUE if cancellation has been requested.
+  bool isCancelRequested() const { return myToCancel; }
+
+  //! Return the name of the innermost named step being executed.
+  TCollection_AsciiString stepName() const;
+
+public:
+  //! Return TRUE if the user requested cancellation.
+  Standard_Boolean UserBreak() override { return myToCancel; }
+
+  //! Remember the name of the current step; called by the worker thread.
+  void Show(const Message_ProgressScope& theScope, const Standard_Boolean theToForce) override;
+
+private:
+  std::atomic<bool>       myToCancel{false};
+  mutable std::mutex      myMutex;
+  TCollection_AsciiString myStepName;
+};
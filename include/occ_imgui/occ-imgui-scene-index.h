@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+//! Searchable flat list of scene objects behind the "Scene" panel.
+//! Objects are identified by their insertion order. Names and attributes are fetched through
+//! a callback only once a row is shown, matched or indexed, and kept lower case for searching;
+//! update() fetches the remaining ones in bounded steps, so that the index is prebuilt by the
+//! time a filter is typed. Filters are whitespace-separated terms that all have to occur in the
+//! name or attributes; a filter extending the previous one only re-tests previous matches, and
+//! matching is spread over update() calls as well, so that no frame scans the whole scene.
+class OccImguiSceneIndex
+{
+public:
+  //! Callback filling name and attributes of the object.
+  using TextFunction =
+    std::function<void(size_t theId, std::string& theName, std::string& theAttributes)>;
+
+public:
+  //! Main constructor.
+  explicit OccImguiSceneIndex(const TextFunction& theText)
+      : myText(theText)
+  {
+  }
+
+  //! Append an object; returns its identifier.
+  size_t add();
+
+  //! Remove the object; its identifier is not reused.
+  void remove(size_t theId);
+
+  //! Fetch name and attributes of the object again, e.g. after its shape has changed.
+  void invalidate(size_t theId);
+
+  //! Return TRUE if the object has been removed.
+  bool isRemoved(const size_t theId) const { return myEntries[theId].IsRemoved; }
+
+  //! Return number of objects, removed ones included.
+  size_t nbEntries() const { return myEntries.size(); }
+
+  //! Return number of objects not removed.
+  size_t nbObjects() const { return myNbObjects; }
+
+  //! Return number of objects with fetched name and attributes.
+  size_t nbIndexed() const { return myNbIndexed; }
+
+  //! Return name of the object, fetched on first use.
+  const std::string& name(size_t theId);
+
+  //! Return attributes of the object, fetched on first use.
+  const std::string& attributes(size_t theId);
+
+  //! Return current filter.
+  const std::string& filter() const { return myFilter; }
+
+  //! Set filter; matching restarts, or continues on the previous matches if theFilter extends
+  //! the previous filter.
+  void setFilter(const std::string& theFilter);
+
+  //! Return identifiers of objects matching the filter, in insertion order;
+  //! grows until update() has tested all objects.
+  const std::vector<size_t>& rows() const { return myRows; }
+
+  //! Return TRUE if objects still have to be tested against the filter.
+  bool isFiltering() const
+  {
+    return myCandidatePos < myCandidates.size() || myScanPos < myEntries.size();
+  }
+
+  //! Return TRUE if all objects have been tested and indexed.
+  bool isComplete() const { return !isFiltering() && myNextIndexed >= myEntries.size(); }
+
+  //! Test up to theMaxSteps objects against the filter, then fetch names and attributes of
+  //! objects not indexed yet with the remaining steps; returns TRUE once complete.
+  bool update(size_t theMaxSteps);
+
+private:
+  //! Object entry.
+  struct Entry
+  {
+    std::string Name;
+    std::string Attributes;
+    std::string SearchText; //!< lower case name and attributes
+    bool        IsIndexed = false;
+    bool        IsRemoved = false;
+  };
+
+  //! Fetch name and attributes of the entry, if not fetched yet.
+  Entry& fetch(size_t theId);
+
+  //! Return TRUE if the object matches all filter terms.
+  bool matches(size_t theId);
+
+  //! Return TRUE if the object still has to be tested against the filter.
+  bool isPending(size_t theId) const;
+
+private:
+  TextFunction             myText;
+  std::vector<Entry>       myEntries;
+  std::string              myFilter;
+  std::vector<std::string> myTerms;            //!< lower case filter terms
+  std::vector<size_t>      myRows;             //!< matches among tested objects, sorted
+  std::vector<size_t>      myCandidates;       //!< previous matches re-tested by a refined filter
+  size_t                   myCandidatePos = 0; //!< next candidate to test
+  size_t                   myScanPos      = 0; //!< objects from here on are tested after candidates
+  size_t                   myNextIndexed  = 0; //!< next object to fetch in background
+  size_t                   myNbObjects    = 0;
+  size_t                   myNbIndexed    = 0;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <opencascade/AIS_InteractiveContext.hxx>
+#include <opencascade/Graphic3d_WorldViewProjState.hxx>
+#include <opencascade/V3d_View.hxx>
+
+#include <cstddef>
+#include <vector>
+
+//! Screen-size level of detail of displayed shapes.
+//! Frustum culling and discarding of objects smaller than a few pixels are delegated to the
+//! culling of OpenGl layers; shapes covering only a few more pixels are swapped to their bounding
+//! box presentation (AIS_Shape display mode 2) and back once they grow on screen again.
+//! Tessellation levels of shapes remaining shaded are handled by the mesh cache.
+class OccImguiSceneLod
+{
+public:
+  //! Display mode of AIS_Shape drawing its bounding box.
+  static constexpr int THE_PROXY_MODE = 2;
+
+  //! Compute world bounding box of a shape or of a shape instance;
+  //! returns FALSE for other objects and empty shapes.
+  static bool boundingBox(const Handle(AIS_InteractiveObject)& theObject, Bnd_Box& theBox);
+
+public:
+  //! Return TRUE if bounding box proxies are used.
+  bool isEnabled() const { return myIsEnabled; }
+
+  //! Enable or disable bounding box proxies; restored by the next update().
+  void setEnabled(const bool theIsEnabled)
+  {
+    myIsEnabled   = theIsEnabled;
+    myToUpdateAll = true;
+  }
+
+  //! Return screen size in pixels below which shapes are drawn as bounding boxes.
+  float proxySize() const { return myProxySize; }
+
+  //! Set screen size in pixels below which shapes are drawn as bounding boxes.
+  void setProxySize(const float theSize)
+  {
+    myProxySize   = theSize;
+    myToUpdateAll = true;
+  }
+
+  //! Return screen size in pixels below which objects are not drawn at all.
+  float cullingSize() const { return myCullingSize; }
+
+  //! Set screen size in pixels below which objects are not drawn at all; applied by setupView().
+  void setCullingSize(const float theSize) { myCullingSize = theSize; }
+
+  //! Return number of shapes currently drawn as bounding boxes.
+  size_t nbProxies() const { return myNbProxies; }
+
+  //! Request re-evaluation of all shapes, e.g. after new objects have been displayed.
+  void invalidate() { myToUpdateAll = true; }
+
+  //! Enable frustum culling of the view and size culling of the default layer.
+  void setupView(const Handle(V3d_View)& theView) const;
+
+  //! Swap presentations of displayed shapes after camera changes or invalidate();
+  //! shapes are drawn as bounding boxes only while small in every view of the list.
+  //! Camera changes are evaluated at most once per theInterval seconds.
+  //! Returns TRUE if any presentation has been swapped.
+  bool update(const Handle(AIS_InteractiveContext)& theCtx,
+              const std::vector<Handle(V3d_View)>&  theViews,
+              double                                theTime,
+              double                                theInterval);
+
+private:
+  //! Return projected size of the object bounding box in pixels or a negative value
+  //! if the object is not a shape or has no presentation yet.
+  double screenSize(const Handle(AIS_InteractiveObject)& theObject,
+                    const Handle(V3d_View)&               theView,
+                    int                                   theViewHeight) const;
+
+private:
+  std::vector<Graphic3d_WorldViewProjState> myCameraStates;
+  double                                    myUpdateTime  = 0.0;
+  size_t                                    myNbProxies   = 0;
+  float                                     myProxySize   = 8.0f;
+  float                                     myCullingSize = 1.0f;
+  bool                                      myIsEnabled   = true;
+  bool                                      myToUpdateAll = true;
+};
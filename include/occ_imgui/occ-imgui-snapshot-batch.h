@@ -0,0 +1,74 @@
+#pragma once
+
+#include "occ-imgui-glfw-occt-snapshot.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Batch rendering of model snapshots split across worker processes.
+//! Models are distributed by file size, largest first to the least loaded worker; every worker
+//! is a process of the same executable rendering its share in a hidden window with its own
+//! OpenGL context, and the results of all workers are merged into one JSON manifest.
+class OccImguiSnapshotBatch
+{
+public:
+  //! Batch parameters.
+  struct Parameters
+  {
+    GlfwOcctSnapshot::Parameters Snapshot;
+    std::string                  Executable;   //!< path of this executable, used to start workers
+    std::string                  ManifestPath; //!< "<OutputDir>/manifest.json" if empty
+    int                          NbWorkers = 0; //!< half of logical processors if 0
+  };
+
+public:
+  //! Assign items to workers balancing the sum of their costs; returns item indices per worker
+  //! in ascending order. Every item costs at least one unit, so empty files are spread too.
+  static std::vector<std::vector<size_t>> partition(const std::vector<uintmax_t>& theCosts,
+                                                    int                            theNbWorkers);
+
+  //! Give models without a name the file name stem, made unique by a numeric suffix.
+  static void assignImageNames(std::vector<GlfwOcctSnapshot::Model>& theModels);
+
+  //! Read a model list: one path per line, optionally followed by a tab and the image name;
+  //! empty lines and lines starting with '#' are skipped.
+  static bool readModelList(const std::string&                    thePath,
+                            std::vector<GlfwOcctSnapshot::Model>& theModels);
+
+  //! Write a model list readable by readModelList().
+  static bool writeModelList(const std::string&                          thePath,
+                             const std::vector<GlfwOcctSnapshot::Model>& theModels);
+
+  //! Render snapshots within this process and write their results for the batch process;
+  //! returns the process exit code.
+  static int performWorker(const GlfwOcctSnapshot::Parameters& theParams,
+                           const std::string&                  theResultsPath);
+
+public:
+  //! Render all snapshots and write the manifest; returns the process exit code.
+  int perform(const Parameters& theParams);
+
+  //! Write the manifest of the last perform() call.
+  void dumpManifest(std::ostream& theStream) const;
+
+private:
+  //! Results of one worker.
+  struct Worker
+  {
+    std::vector<GlfwOcctSnapshot::Model> Models;
+    std::string                          Results; //!< JSON objects written by dumpResults()
+    double                               WallMs = 0.0;
+    bool                                 IsOk   = false;
+  };
+
+  //! Return command line starting the worker process.
+  std::string workerCommand(const std::string& theListPath,
+                            const std::string& theResultsPath) const;
+
+private:
+  Parameters          myParams;
+  std::vector<Worker> myWorkers;
+  double              myWallMs = 0.0;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+//! Bounded lock-free queue passing values from one producer thread to one consumer thread.
+//! The ring buffer has a power-of-two capacity; each side owns one index and caches the last
+//! seen index of the other side, so that push() and pop() touch the shared cache line of the
+//! other thread only when the cached value says the queue is full or empty.
+template <typename T>
+class OccImguiSpscQueue
+{
+public:
+  //! Create the queue holding at least theCapacity values.
+  explicit OccImguiSpscQueue(const size_t theCapacity)
+  {
+    size_t aSize = 2;
+    while (aSize < theCapacity)
+    {
+      aSize *= 2;
+    }
+    mySlots.resize(aSize);
+    myMask = aSize - 1;
+  }
+
+  //! Return the maximum number of queued values.
+  size_t capacity() const { return mySlots.size(); }
+
+  //! Append the value; returns FALSE if the queue is full. Producer thread only.
+  bool push(const T& theValue)
+  {
+    const size_t aTail = myProducer.Index.load(std::memory_order_relaxed);
+    if (aTail - myProducer.Cached == mySlots.size())
+    {
+      myProducer.Cached = myConsumer.Index.load(std::memory_order_acquire);
+      if (aTail - myProducer.Cached == mySlots.size())
+      {
+        return false;
+      }
+    }
+    mySlots[aTail & myMask] = theValue;
+    myProducer.Index.store(aTail + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! Remove the oldest value; returns FALSE if the queue is empty. Consumer thread only.
+  bool pop(T& theValue)
+  {
+    const size_t aHead = myConsumer.Index.load(std::memory_order_relaxed);
+    if (aHead == myConsumer.Cached)
+    {
+      myConsumer.Cached = myProducer.Index.load(std::memory_order_acquire);
+      if (aHead == myConsumer.Cached)
+      {
+        return false;
+      }
+    }
+    theValue = mySlots[aHead & myMask];
+    myConsumer.Index.store(aHead + 1, std::memory_order_release);
+    return true;
+  }
+
+  //! Return TRUE if no values are queued; exact only on the consumer thread.
+  bool empty() const
+  {
+    return myConsumer.Index.load(std::memory_order_acquire)
+           == myProducer.Index.load(std::memory_order_acquire);
+  }
+
+private:
+  //! Index written by one side, with the last seen index of the other side,
+  //! padded to a cache line of its own.
+  struct Side
+  {
+    std::atomic<size_t> Index{0};
+    size_t              Cached = 0;
+    char                Padding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+  };
+
+private:
+  std::vector<T> mySlots;
+  size_t         myMask = 0;
+  Side           myProducer; //!< next slot to write, last seen consumer index
+  Side           myConsumer; //!< next slot to read, last seen producer index
+};
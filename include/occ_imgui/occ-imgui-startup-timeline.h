@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Timeline of application startup phases, in milliseconds since start().
+//! Phases are measured with scoped timers; the first presented frame splits them into phases
+//! delaying it and phases deferred until after it. Not thread-safe: phases should be recorded
+//! by one thread at a time.
+class OccImguiStartupTimeline
+{
+public:
+  //! Startup phase.
+  struct Phase
+  {
+    std::string Name;
+    double      BeginMs    = 0.0;
+    double      DurationMs = 0.0;
+  };
+
+  //! Scoped timer recording a phase.
+  class Scope
+  {
+  public:
+    //! Start measuring the phase.
+    Scope(OccImguiStartupTimeline& theTimeline, const char* theName)
+        : myTimeline(theTimeline),
+          myName(theName),
+          myBeginMs(theTimeline.elapsedMs())
+    {
+    }
+
+    //! Stop measuring the phase.
+    ~Scope() { myTimeline.addPhase(myName, myBeginMs, myTimeline.elapsedMs()); }
+
+    Scope(const Scope&)            = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    OccImguiStartupTimeline& myTimeline;
+    const char*              myName;
+    double                   myBeginMs;
+  };
+
+public:
+  //! Default constructor; starts the timeline.
+  OccImguiStartupTimeline() { start(); }
+
+  //! Restart the timeline, removing recorded phases.
+  void start();
+
+  //! Return milliseconds elapsed since start().
+  double elapsedMs() const
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - myStart)
+      .count();
+  }
+
+  //! Append a phase.
+  void addPhase(const std::string& theName, double theBeginMs, double theEndMs);
+
+  //! Return recorded phases, in order of completion.
+  const std::vector<Phase>& phases() const { return myPhases; }
+
+  //! Mark the first frame as presented at the given time; later calls are ignored.
+  void markFirstFrame(double theTimeMs);
+
+  //! Return TRUE if the first frame has been presented.
+  bool hasFirstFrame() const { return myFirstFrameMs >= 0.0; }
+
+  //! Return time of the first presented frame, or a negative value if not presented yet.
+  double firstFrameMs() const { return myFirstFrameMs; }
+
+  //! Return TRUE if the phase started after the first frame.
+  bool isDeferred(const Phase& thePhase) const
+  {
+    return hasFirstFrame() && thePhase.BeginMs >= myFirstFrameMs;
+  }
+
+  //! Print phases sorted by start time, together with the first frame.
+  void dump(std::ostream& theStream) const;
+
+private:
+  std::chrono::steady_clock::time_point myStart;
+  std::vector<Phase>                    myPhases;
+  double                                myFirstFrameMs = -1.0;
+};
@@ -0,0 +1,80 @@
+#include "occ_imgui/occ-imgui-glfw-occt-benchmark.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace
+{
+//! Print command line usage.
+void printBenchmarkUsage(const char* theExecutable)
+{
+  std::cout << "Usage: " << theExecutable << " [options]\n"
+            << "  --frames N     number of measured frames (default 300)\n"
+            << "  --warmup N     number of frames rendered before measuring (default 10)\n"
+            << "  --shapes K     number of boxes and cones in the scene (default 100)\n"
+            << "  --size WxH     offscreen framebuffer size (default 1280x720)\n"
+            << "  --no-sync      do not wait for the GPU after each stage\n";
+}
+} // namespace
+
+int main(int theNbArgs, char** theArgs)
+{
+  try
+  {
+    GlfwOcctBenchmark::Parameters aParams;
+    for (int anArgIter = 1; anArgIter < theNbArgs; ++anArgIter)
+    {
+      const std::string anArg  = theArgs[anArgIter];
+      const bool        hasVal = anArgIter + 1 < theNbArgs;
+      if (anArg == "--frames" && hasVal)
+      {
+        aParams.NbFrames = std::stoi(theArgs[++anArgIter]);
+      }
+      else if (anArg == "--warmup" && hasVal)
+      {
+        aParams.NbWarmupFrames = std::stoi(theArgs[++anArgIter]);
+      }
+      else if (anArg == "--shapes" && hasVal)
+      {
+        aParams.NbShapes = std::stoi(theArgs[++anArgIter]);
+      }
+      else if (anArg == "--size" && hasVal)
+      {
+        const std::string aSize = theArgs[++anArgIter];
+        const size_t      aSep  = aSize.find('x');
+        if (aSep == std::string::npos)
+        {
+          printBenchmarkUsage(theArgs[0]);
+          return EXIT_FAILURE;
+        }
+        aParams.Width  = std::stoi(aSize.substr(0, aSep));
+        aParams.Height = std::stoi(aSize.substr(aSep + 1));
+      }
+      else if (anArg == "--no-sync")
+      {
+        aParams.ToSyncGpu = false;
+      }
+      else
+      {
+        printBenchmarkUsage(theArgs[0]);
+        return anArg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+    }
+
+    GlfwOcctBenchmark aBenchmark;
+    if (!aBenchmark.perform(aParams))
+    {
+      std::cerr << "Unable to create an offscreen OpenGL viewer" << std::endl;
+      return EXIT_FAILURE;
+    }
+    aBenchmark.dump(std::cout);
+  }
+  catch (const std::exception& theError)
+  {
+    std::cerr << theError.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
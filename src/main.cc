@@ -1,13 +1,234 @@
+#include "occ_imgui/occ-imgui-glfw-occt-replay.h"
 #include "occ_imgui/occ-imgui-glfw-occt-view.h"
+#include "occ_imgui/occ-imgui-snapshot-batch.h"
 
-int main(int, char**)
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+//! Print command line usage.
+void printUsage(const char* theExecutable)
+{
+  std::cout << "Usage: " << theExecutable << " [--record FILE] [--render-thread] [--fps N]\n"
+            << "       " << std::string(std::strlen(theExecutable), ' ')
+            << " [--startup-timeline] [file]\n"
+            << "       " << theExecutable << " --replay FILE [options]\n"
+            << "       " << theExecutable << " --batch [options] [file...]\n"
+            << "--record writes mouse and window input into FILE on exit; the GUI starts with\n"
+            << "the default layout. --render-thread renders on a dedicated thread, so that slow\n"
+            << "frames never delay window events; panels then stay inside the main window.\n"
+            << "--fps limits the frame rate (default 60, 0 for unlimited). --startup-timeline\n"
+            << "prints durations of startup phases once the deferred ones have completed.\n"
+            << "Replay mode feeds a recording back headless at a fixed frame step:\n"
+            << "  --step MS        frame step in milliseconds (default 16.667)\n"
+            << "  --warmup N       frames rendered before replaying (default 10)\n"
+            << "  --timings FILE   write per-frame timings as CSV\n"
+            << "  --no-sync        do not wait for the GPU after each frame\n"
+            << "Batch mode renders PNG snapshots of every file from every view:\n"
+            << "  --list FILE      read files from FILE, one path per line, optionally followed\n"
+            << "                   by a tab and the image name\n"
+            << "  --views LIST     comma-separated views: iso, top, bottom, front, back, left,\n"
+            << "                   right (default iso)\n"
+            << "  --size WxH       image size (default 256x256)\n"
+            << "  --msaa N         number of MSAA samples (default 4)\n"
+            << "  --output DIR     image directory (default .)\n"
+            << "  --manifest FILE  JSON manifest with per-job timings (default DIR/manifest.json)\n"
+            << "  --workers N      number of worker processes (default half of CPU cores)\n";
+}
+
+//! Parse replay mode arguments and replay the recording; returns the process exit code.
+int runReplay(const int theNbArgs, char** theArgs)
+{
+  GlfwOcctReplay::Parameters aParams;
+  std::string                aTimingsPath;
+  for (int anArgIter = 2; anArgIter < theNbArgs; ++anArgIter)
+  {
+    const std::string anArg  = theArgs[anArgIter];
+    const bool        hasVal = anArgIter + 1 < theNbArgs;
+    if (anArg == "--step" && hasVal)
+    {
+      aParams.FrameStep = std::stod(theArgs[++anArgIter]) / 1000.0;
+    }
+    else if (anArg == "--warmup" && hasVal)
+    {
+      aParams.NbWarmupFrames = std::stoi(theArgs[++anArgIter]);
+    }
+    else if (anArg == "--timings" && hasVal)
+    {
+      aTimingsPath = theArgs[++anArgIter];
+    }
+    else if (anArg == "--no-sync")
+    {
+      aParams.ToSyncGpu = false;
+    }
+    else if (!anArg.empty() && anArg.front() != '-' && aParams.RecordingPath.empty())
+    {
+      aParams.RecordingPath = anArg;
+    }
+    else
+    {
+      printUsage(theArgs[0]);
+      return anArg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  GlfwOcctReplay aReplay;
+  if (!aReplay.perform(aParams))
+  {
+    std::cerr << aReplay.errorMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+  aReplay.dump(std::cout);
+  if (!aTimingsPath.empty() && !aReplay.writeTimings(aTimingsPath))
+  {
+    std::cerr << "Unable to write '" << aTimingsPath << "'" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+//! Parse batch mode arguments and render snapshots; returns the process exit code.
+int runBatch(const int theNbArgs, char** theArgs)
+{
+  OccImguiSnapshotBatch::Parameters aParams;
+  aParams.Executable = theArgs[0];
+  std::string aResultsPath; // set for worker processes started by the batch
+  for (int anArgIter = 2; anArgIter < theNbArgs; ++anArgIter)
+  {
+    const std::string anArg  = theArgs[anArgIter];
+    const bool        hasVal = anArgIter + 1 < theNbArgs;
+    if (anArg == "--list" && hasVal)
+    {
+      if (!OccImguiSnapshotBatch::readModelList(theArgs[++anArgIter], aParams.Snapshot.Models))
+      {
+        std::cerr << "Unable to read '" << theArgs[anArgIter] << "'" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    else if (anArg == "--views" && hasVal)
+    {
+      aParams.Snapshot.Presets.clear();
+      std::istringstream aViews(theArgs[++anArgIter]);
+      std::string        aView;
+      while (std::getline(aViews, aView, ','))
+      {
+        GlfwOcctSnapshot::Preset aPreset = GlfwOcctSnapshot::Preset_Iso;
+        if (!GlfwOcctSnapshot::presetFromName(aView, aPreset))
+        {
+          std::cerr << "Unknown view '" << aView << "'" << std::endl;
+          return EXIT_FAILURE;
+        }
+        aParams.Snapshot.Presets.push_back(aPreset);
+      }
+    }
+    else if (anArg == "--size" && hasVal)
+    {
+      const std::string aSize = theArgs[++anArgIter];
+      const size_t      aSep  = aSize.find('x');
+      if (aSep == std::string::npos)
+      {
+        printUsage(theArgs[0]);
+        return EXIT_FAILURE;
+      }
+      aParams.Snapshot.Width  = std::stoi(aSize.substr(0, aSep));
+      aParams.Snapshot.Height = std::stoi(aSize.substr(aSep + 1));
+    }
+    else if (anArg == "--msaa" && hasVal)
+    {
+      aParams.Snapshot.NbMsaaSamples = std::stoi(theArgs[++anArgIter]);
+    }
+    else if (anArg == "--output" && hasVal)
+    {
+      aParams.Snapshot.OutputDir = theArgs[++anArgIter];
+    }
+    else if (anArg == "--manifest" && hasVal)
+    {
+      aParams.ManifestPath = theArgs[++anArgIter];
+    }
+    else if (anArg == "--workers" && hasVal)
+    {
+      aParams.NbWorkers = std::stoi(theArgs[++anArgIter]);
+    }
+    else if (anArg == "--worker-results" && hasVal)
+    {
+      aResultsPath = theArgs[++anArgIter];
+    }
+    else if (!anArg.empty() && anArg.front() != '-')
+    {
+      aParams.Snapshot.Models.push_back({anArg, std::string()});
+    }
+    else
+    {
+      printUsage(theArgs[0]);
+      return anArg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+  }
+
+  if (!aResultsPath.empty())
+  {
+    return OccImguiSnapshotBatch::performWorker(aParams.Snapshot, aResultsPath);
+  }
+
+  OccImguiSnapshotBatch aBatch;
+  return aBatch.perform(aParams);
+}
+} // namespace
+
+int main(int theNbArgs, char** theArgs)
 {
   try
   {
+    if (theNbArgs > 1 && std::string(theArgs[1]) == "--batch")
+    {
+      return runBatch(theNbArgs, theArgs);
+    }
+    if (theNbArgs > 1 && std::string(theArgs[1]) == "--replay")
+    {
+      return runReplay(theNbArgs, theArgs);
+    }
+    if (theNbArgs > 1 && std::string(theArgs[1]) == "--help")
+    {
+      printUsage(theArgs[0]);
+      return EXIT_SUCCESS;
+    }
+
     GlfwOcctView anApp;
+    for (int anArgIter = 1; anArgIter < theNbArgs; ++anArgIter)
+    {
+      const std::string anArg = theArgs[anArgIter];
+      if (anArg == "--record" && anArgIter + 1 < theNbArgs)
+      {
+        anApp.setRecordPath(theArgs[++anArgIter]);
+      }
+      else if (anArg == "--render-thread")
+      {
+        anApp.setRenderThread(true);
+      }
+      else if (anArg == "--fps" && anArgIter + 1 < theNbArgs)
+      {
+        anApp.setTargetFrameRate(std::stod(theArgs[++anArgIter]));
+      }
+      else if (anArg == "--startup-timeline")
+      {
+        anApp.setStartupTimelinePrinted(true);
+      }
+      else if (!anArg.empty() && anArg.front() != '-')
+      {
+        anApp.openFile(anArg.c_str());
+      }
+      else
+      {
+        printUsage(theArgs[0]);
+        return EXIT_FAILURE;
+      }
+    }
     anApp.run();
   }
-  catch (const std::runtime_error& theError)
+  catch (const std::exception& theError)
   {
     std::cerr << theError.what() << std::endl;
     return EXIT_FAILURE;
@@ -0,0 +1,149 @@
+#include "occ_imgui/occ-imgui-adaptive-resolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+//! Frame times within this factor of the target keep the current scale,
+//! so that the scale does not oscillate around the target.
+constexpr double THE_ADAPTIVE_TOLERANCE = 1.2;
+
+//! Largest change of the scale per frame.
+constexpr double THE_ADAPTIVE_MAX_STEP = 1.5;
+
+//! Scales are rounded to multiples of this step to avoid reallocating offscreen buffers of the
+//! view for small changes.
+constexpr float THE_ADAPTIVE_SCALE_STEP = 1.0f / 16.0f;
+} // namespace
+
+// ================================================================
+// Function : setMinScale
+// Purpose  :
+// ================================================================
+void OccImguiAdaptiveResolution::setMinScale(const float theScale)
+{
+  myMinScale = std::clamp(theScale, THE_ADAPTIVE_SCALE_STEP, 1.0f);
+  myScale    = std::max(myScale, myMinScale);
+}
+
+// ================================================================
+// Function : setupView
+// Purpose  :
+// ================================================================
+void OccImguiAdaptiveResolution::setupView(const Handle(V3d_View)& theView) const
+{
+  Graphic3d_RenderingParams& aParams = theView->ChangeRenderingParams();
+  aParams.RenderResolutionScale      = 1.0f;
+  aParams.NbMsaaSamples              = myMsaaSamples;
+}
+
+// ================================================================
+// Function : update
+// Purpose  :
+// ================================================================
+bool OccImguiAdaptiveResolution::update(const bool   theIsInteracting,
+                                        const double theTime,
+                                        const double theFrameTime)
+{
+  if (!myIsEnabled)
+  {
+    const bool wasDegraded = myIsDegraded;
+    myIsDegraded           = false;
+    return wasDegraded;
+  }
+
+  if (!theIsInteracting)
+  {
+    // short pauses, e.g. between mouse wheel steps, keep the reduced quality
+    if (myIsDegraded && theTime - myInteractionTime >= myRefineDelay)
+    {
+      myIsDegraded = false;
+      return true;
+    }
+    return false;
+  }
+
+  myInteractionTime = theTime;
+  if (!myIsDegraded)
+  {
+    // the scale reached by the previous interaction is the best guess for the next one
+    myIsDegraded = true;
+    return true;
+  }
+  if (theFrameTime <= 0.0)
+  {
+    return false;
+  }
+
+  const double aRatio = myTargetFrameTime / theFrameTime;
+  if (aRatio * THE_ADAPTIVE_TOLERANCE >= 1.0 && aRatio <= THE_ADAPTIVE_TOLERANCE)
+  {
+    return false;
+  }
+
+  // rendering cost is roughly proportional to the number of pixels
+  const double aStep =
+    std::clamp(std::sqrt(aRatio), 1.0 / THE_ADAPTIVE_MAX_STEP, THE_ADAPTIVE_MAX_STEP);
+  float aScale = static_cast<float>(myScale * aStep);
+  aScale       = std::round(aScale / THE_ADAPTIVE_SCALE_STEP) * THE_ADAPTIVE_SCALE_STEP;
+  aScale       = std::clamp(aScale, myMinScale, 1.0f);
+  if (aScale == myScale)
+  {
+    return false;
+  }
+
+  myScale = aScale;
+  return true;
+}
+
+// ================================================================
+// Function : apply
+// Purpose  :
+// ================================================================
+void OccImguiAdaptiveResolution::apply(const Handle(V3d_View)& theView)
+{
+  if (myView != theView)
+  {
+    restoreView();
+  }
+  if (!myIsDegraded || theView.IsNull())
+  {
+    restoreView();
+    return;
+  }
+
+  // the camera is being changed anyway, so the view is redrawn without explicit invalidation
+  myView                             = theView;
+  Graphic3d_RenderingParams& aParams = theView->ChangeRenderingParams();
+  aParams.RenderResolutionScale      = myScale;
+  aParams.NbMsaaSamples              = 0;
+}
+
+// ================================================================
+// Function : release
+// Purpose  :
+// ================================================================
+void OccImguiAdaptiveResolution::release(const Handle(V3d_View)& theView)
+{
+  if (myView == theView)
+  {
+    myView.Nullify();
+  }
+}
+
+// ================================================================
+// Function : restoreView
+// Purpose  :
+// ================================================================
+void OccImguiAdaptiveResolution::restoreView()
+{
+  if (myView.IsNull())
+  {
+    return;
+  }
+
+  setupView(myView);
+  myView->Invalidate();
+  myView.Nullify();
+}
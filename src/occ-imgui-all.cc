@@ -0,0 +1,32 @@
+// This file #includes all occ-imgui implementation .cc files. The
+// purpose is to allow a user to build occ-imgui by compiling this
+// file alone.
+
+// The following lines pull in the real occ-imgui*.cc files.
+
+#include "occ-imgui-adaptive-resolution.cc"
+#include "occ-imgui-box-placeholder.cc"
+#include "occ-imgui-frame-pacer.cc"
+#include "occ-imgui-frame-stats.cc"
+#include "occ-imgui-glfw-occt-benchmark.cc"
+#include "occ-imgui-glfw-occt-replay.cc"
+#include "occ-imgui-glfw-occt-snapshot.cc"
+#include "occ-imgui-glfw-occt-view.cc"
+#include "occ-imgui-glfw-occt-window.cc"
+#include "occ-imgui-importer.cc"
+#include "occ-imgui-input-queue.cc"
+#include "occ-imgui-input-recording.cc"
+#include "occ-imgui-mapped-file.cc"
+#include "occ-imgui-memory-budget.cc"
+#include "occ-imgui-mesh-disk-cache.cc"
+#include "occ-imgui-mesh-lod-cache.cc"
+#include "occ-imgui-mesh-reader.cc"
+#include "occ-imgui-modeling.cc"
+#include "occ-imgui-png-writer.cc"
+#include "occ-imgui-profiler.cc"
+#include "occ-imgui-program-cache.cc"
+#include "occ-imgui-progress.cc"
+#include "occ-imgui-scene-index.cc"
+#include "occ-imgui-scene-lod.cc"
+#include "occ-imgui-snapshot-batch.cc"
+#include "occ-imgui-startup-timeline.cc"
@@ -0,0 +1,7 @@
+// This file #includes all occ-imgui implementation .cc files together
+// with the benchmark entry point. The purpose is to allow a user to
+// build occ-imgui-benchmark by compiling this file alone.
+
+#include "occ-imgui-all.cc"
+
+#include "benchmark.cc"
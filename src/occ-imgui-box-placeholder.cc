@@ -0,0 +1,72 @@
+#include "occ_imgui/occ-imgui-box-placeholder.h"
+
+#include <opencascade/Graphic3d_ArrayOfSegments.hxx>
+#include <opencascade/Prs3d_LineAspect.hxx>
+
+// ================================================================
+// Function : OccImguiBoxPlaceholder
+// Purpose  :
+// ================================================================
+OccImguiBoxPlaceholder::OccImguiBoxPlaceholder(const std::vector<Bnd_Box>& theBoxes)
+    : myBoxes(theBoxes)
+{
+  myDrawer->SetLineAspect(new Prs3d_LineAspect(Quantity_NOC_GRAY50, Aspect_TOL_DOT, 1.0));
+  SetInfiniteState(false);
+}
+
+// ================================================================
+// Function : Compute
+// Purpose  :
+// ================================================================
+void OccImguiBoxPlaceholder::Compute(const Handle(PrsMgr_PresentationManager)&,
+                                     const Handle(Prs3d_Presentation)& thePrs,
+                                     const Standard_Integer            theMode)
+{
+  if (theMode != 0)
+  {
+    return;
+  }
+
+  // corner i has max coordinates along the axes whose bit is set in i;
+  // edges connect corners differing in one bit
+  static const int THE_BOX_EDGES[12][2] = {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3},
+                                           {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+  Standard_Integer aNbBoxes = 0;
+  for (const Bnd_Box& aBox : myBoxes)
+  {
+    aNbBoxes += aBox.IsVoid() ? 0 : 1;
+  }
+  if (aNbBoxes == 0)
+  {
+    return;
+  }
+
+  Handle(Graphic3d_ArrayOfSegments) aSegments =
+    new Graphic3d_ArrayOfSegments(aNbBoxes * 8, aNbBoxes * 24);
+  for (const Bnd_Box& aBox : myBoxes)
+  {
+    if (aBox.IsVoid())
+    {
+      continue;
+    }
+
+    const gp_Pnt           aMin   = aBox.CornerMin();
+    const gp_Pnt           aMax   = aBox.CornerMax();
+    const Standard_Integer aFirst = aSegments->VertexNumber() + 1;
+    for (int aCornerIter = 0; aCornerIter < 8; ++aCornerIter)
+    {
+      aSegments->AddVertex(gp_Pnt((aCornerIter & 1) != 0 ? aMax.X() : aMin.X(),
+                                  (aCornerIter & 2) != 0 ? aMax.Y() : aMin.Y(),
+                                  (aCornerIter & 4) != 0 ? aMax.Z() : aMin.Z()));
+    }
+    for (const int* anEdge : THE_BOX_EDGES)
+    {
+      aSegments->AddEdges(aFirst + anEdge[0], aFirst + anEdge[1]);
+    }
+  }
+
+  Handle(Graphic3d_Group) aGroup = thePrs->NewGroup();
+  aGroup->SetGroupPrimitivesAspect(myDrawer->LineAspect()->Aspect());
+  aGroup->AddPrimitiveArray(aSegments);
+}
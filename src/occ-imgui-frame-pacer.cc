@@ -0,0 +1,158 @@
+#include "occ_imgui/occ-imgui-frame-pacer.h"
+
+#include "occ_imgui/occ-imgui-frame-stats.h"
+
+#include <algorithm>
+
+namespace
+{
+//! Number of the latest latency samples kept for percentiles.
+constexpr size_t THE_PACER_LATENCY_SAMPLES = 1024;
+
+//! Weight of the latest frame in smoothed frame work and rate.
+constexpr double THE_PACER_SMOOTHING = 0.1;
+
+//! Fraction of the refresh period the frame work has to drop below to wait for vsync again.
+constexpr double THE_PACER_VSYNC_RESUME = 0.8;
+
+//! Blend the value into the smoothed one, or start with the value.
+double smoothPacerValue(const double theSmoothed, const double theValue, const bool theIsFirst)
+{
+  return theIsFirst ? theValue : theSmoothed + (theValue - theSmoothed) * THE_PACER_SMOOTHING;
+}
+} // namespace
+
+// ================================================================
+// Function : setIdleRate
+// Purpose  :
+// ================================================================
+void OccImguiFramePacer::setIdleRate(const double theRate)
+{
+  myIdleRate = std::max(theRate, 0.1);
+}
+
+// ================================================================
+// Function : setRefreshRate
+// Purpose  :
+// ================================================================
+void OccImguiFramePacer::setRefreshRate(const double theRate)
+{
+  if (theRate > 0.0)
+  {
+    myRefreshRate = theRate;
+  }
+}
+
+// ================================================================
+// Function : addInput
+// Purpose  :
+// ================================================================
+void OccImguiFramePacer::addInput(const double theTime)
+{
+  myInputTime        = std::max(myInputTime, theTime);
+  myPendingInputTime = myPendingInputTime < 0.0 ? theTime : std::min(myPendingInputTime, theTime);
+}
+
+// ================================================================
+// Function : frameDelay
+// Purpose  :
+// ================================================================
+double OccImguiFramePacer::frameDelay(const double theTime) const
+{
+  const double anInterval = isIdle(theTime)    ? 1.0 / myIdleRate
+                            : myTargetRate > 0.0 ? 1.0 / myTargetRate
+                                                 : 0.0;
+  if (myFrameStart < 0.0 || anInterval <= 0.0)
+  {
+    return 0.0;
+  }
+  return std::max(myFrameStart + anInterval - theTime, 0.0);
+}
+
+// ================================================================
+// Function : beginFrame
+// Purpose  :
+// ================================================================
+void OccImguiFramePacer::beginFrame(const double theTime)
+{
+  myFrameStart = theTime;
+}
+
+// ================================================================
+// Function : endFrame
+// Purpose  :
+// ================================================================
+void OccImguiFramePacer::endFrame(const double theSwapStart, const double theSwapEnd)
+{
+  if (myPendingInputTime >= 0.0)
+  {
+    const double aLatency = (theSwapEnd - myPendingInputTime) * 1000.0;
+    if (myLatencies.size() < THE_PACER_LATENCY_SAMPLES)
+    {
+      myLatencies.push_back(aLatency);
+    }
+    else
+    {
+      myLatencies[myNextLatency] = aLatency;
+    }
+    myNextLatency      = (myNextLatency + 1) % THE_PACER_LATENCY_SAMPLES;
+    myPendingInputTime = -1.0;
+  }
+
+  const double aWork = myFrameStart >= 0.0 ? std::max(theSwapStart - myFrameStart, 0.0) : 0.0;
+  myFrameWork        = smoothPacerValue(myFrameWork, aWork, myLastSwap < 0.0);
+  if (myLastSwap >= 0.0 && theSwapEnd > myLastSwap)
+  {
+    myFrameRate =
+      smoothPacerValue(myFrameRate, 1.0 / (theSwapEnd - myLastSwap), myFrameRate <= 0.0);
+  }
+  myLastSwap = theSwapEnd;
+
+  // waiting for the next refresh after a late frame would halve the frame rate;
+  // late frames are swapped at once, vsync resumes once frames fit into the period again
+  if (!myIsAdaptiveSwap)
+  {
+    mySwapInterval = 1;
+  }
+  else if (myIsSwapTearSupported)
+  {
+    mySwapInterval = -1;
+  }
+  else
+  {
+    const double aPeriod = 1.0 / myRefreshRate;
+    if (mySwapInterval != 0 && myFrameWork > aPeriod)
+    {
+      mySwapInterval = 0;
+    }
+    else if (mySwapInterval == 0 && myFrameWork < aPeriod * THE_PACER_VSYNC_RESUME)
+    {
+      mySwapInterval = 1;
+    }
+  }
+}
+
+// ================================================================
+// Function : latencyPercentile
+// Purpose  :
+// ================================================================
+double OccImguiFramePacer::latencyPercentile(const double thePercent) const
+{
+  OccImguiFrameStats aStats;
+  aStats.reserve(myLatencies.size());
+  for (const double aLatency : myLatencies)
+  {
+    aStats.add(aLatency);
+  }
+  return aStats.percentile(thePercent);
+}
+
+// ================================================================
+// Function : resetLatencies
+// Purpose  :
+// ================================================================
+void OccImguiFramePacer::resetLatencies()
+{
+  myLatencies.clear();
+  myNextLatency = 0;
+}
@@ -0,0 +1,62 @@
+#include "occ_imgui/occ-imgui-frame-stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// ================================================================
+// Function : minimum
+// Purpose  :
+// ================================================================
+double OccImguiFrameStats::minimum() const
+{
+  return mySamples.empty() ? 0.0 : *std::min_element(mySamples.begin(), mySamples.end());
+}
+
+// ================================================================
+// Function : maximum
+// Purpose  :
+// ================================================================
+double OccImguiFrameStats::maximum() const
+{
+  return mySamples.empty() ? 0.0 : *std::max_element(mySamples.begin(), mySamples.end());
+}
+
+// ================================================================
+// Function : mean
+// Purpose  :
+// ================================================================
+double OccImguiFrameStats::mean() const
+{
+  if (mySamples.empty())
+  {
+    return 0.0;
+  }
+  return std::accumulate(mySamples.begin(), mySamples.end(), 0.0)
+         / static_cast<double>(mySamples.size());
+}
+
+// ================================================================
+// Function : percentile
+// Purpose  :
+// ================================================================
+double OccImguiFrameStats::percentile(const double thePercent) const
+{
+  if (mySamples.empty())
+  {
+    return 0.0;
+  }
+
+  // nearest-rank method: the smallest sample such that thePercent of the data is <= it
+  const double aPercent   = std::clamp(thePercent, 0.0, 100.0);
+  const size_t aNbSamples = mySamples.size();
+  const size_t aRank      = std::clamp<size_t>(
+    static_cast<size_t>(std::ceil(aPercent / 100.0 * static_cast<double>(aNbSamples))),
+    1,
+    aNbSamples);
+
+  std::vector<double> aSorted(mySamples);
+  const auto          aNth = aSorted.begin() + static_cast<std::ptrdiff_t>(aRank - 1);
+  std::nth_element(aSorted.begin(), aNth, aSorted.end());
+  return *aNth;
+}
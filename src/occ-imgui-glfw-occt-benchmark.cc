@@ -0,0 +1,169 @@
+#include "occ_imgui/occ-imgui-glfw-occt-benchmark.h"
+
+#include <GLFW/glfw3.h>
+
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/BRepPrimAPI_MakeBox.hxx>
+#include <opencascade/BRepPrimAPI_MakeCone.hxx>
+#include <opencascade/Graphic3d_Camera.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+//! Return milliseconds elapsed between two time points.
+double benchmarkMillis(const std::chrono::steady_clock::time_point& theFrom,
+                       const std::chrono::steady_clock::time_point& theTo)
+{
+  return std::chrono::duration<double, std::milli>(theTo - theFrom).count();
+}
+
+//! Print one row of the results table.
+void dumpBenchmarkRow(std::ostream&             theStream,
+                      const char*               theName,
+                      const OccImguiFrameStats& theStats)
+{
+  theStream << std::left << std::setw(18) << theName << std::right << std::fixed
+            << std::setprecision(3) << std::setw(10) << theStats.minimum() << std::setw(12)
+            << theStats.median() << std::setw(10) << theStats.percentile(99.0) << "\n";
+}
+} // namespace
+
+// ================================================================
+// Function : GlfwOcctBenchmark
+// Purpose  :
+// ================================================================
+GlfwOcctBenchmark::GlfwOcctBenchmark()
+{
+  setHeadless(true);
+}
+
+// ================================================================
+// Function : perform
+// Purpose  :
+// ================================================================
+bool GlfwOcctBenchmark::perform(const Parameters& theParams)
+{
+  myParams = theParams;
+  myFlushStats.reset();
+  myGuiStats.reset();
+  myFrameStats.reset();
+
+  initWindow(myParams.Width, myParams.Height, "OCCT IMGUI Benchmark");
+  initViewer();
+  if (myView.IsNull())
+  {
+    if (!myOcctWindow.IsNull())
+    {
+      myOcctWindow->Close();
+    }
+    glfwTerminate();
+    return false;
+  }
+
+  // the grid and the view cube are part of the measured scene
+  completeStartup();
+  initBenchmarkScene(myParams.NbShapes);
+  myView->MustBeResized();
+  myView->FitAll(0.01, false);
+  initGui();
+  myProfiler.setGlContext(glContext());
+
+  const size_t aNbFrames = static_cast<size_t>(std::max(myParams.NbFrames, 0));
+  myFlushStats.reserve(aNbFrames);
+  myGuiStats.reserve(aNbFrames);
+  myFrameStats.reserve(aNbFrames);
+  const int aNbTotalFrames = myParams.NbWarmupFrames + myParams.NbFrames;
+  for (int aFrameIter = 0; aFrameIter < aNbTotalFrames; ++aFrameIter)
+  {
+    myProfiler.beginFrame();
+    glfwPollEvents();
+    orbitCamera();
+
+    const auto aStart = std::chrono::steady_clock::now();
+    FlushViewEvents(myContext, myView, true);
+    if (myParams.ToSyncGpu)
+    {
+      finishGpu();
+    }
+
+    const auto aFlushed = std::chrono::steady_clock::now();
+    renderGui();
+    if (myParams.ToSyncGpu)
+    {
+      finishGpu();
+    }
+
+    const auto anEnd = std::chrono::steady_clock::now();
+    if (aFrameIter >= myParams.NbWarmupFrames)
+    {
+      myFlushStats.add(benchmarkMillis(aStart, aFlushed));
+      myGuiStats.add(benchmarkMillis(aFlushed, anEnd));
+      myFrameStats.add(benchmarkMillis(aStart, anEnd));
+    }
+  }
+
+  cleanup();
+  return true;
+}
+
+// ================================================================
+// Function : dump
+// Purpose  :
+// ================================================================
+void GlfwOcctBenchmark::dump(std::ostream& theStream) const
+{
+  theStream << "Scene: " << myParams.NbShapes << " shapes, " << myParams.Width << "x"
+            << myParams.Height << ", " << myFrameStats.size() << " frames"
+            << (myParams.ToSyncGpu ? " (GPU synchronized)" : "") << "\n";
+  theStream << std::left << std::setw(18) << "Stage" << std::right << std::setw(10) << "min, ms"
+            << std::setw(12) << "median, ms" << std::setw(10) << "p99, ms"
+            << "\n";
+  dumpBenchmarkRow(theStream, "FlushViewEvents", myFlushStats);
+  dumpBenchmarkRow(theStream, "renderGui", myGuiStats);
+  dumpBenchmarkRow(theStream, "Frame", myFrameStats);
+}
+
+// ================================================================
+// Function : initBenchmarkScene
+// Purpose  :
+// ================================================================
+void GlfwOcctBenchmark::initBenchmarkScene(const int theNbShapes) const
+{
+  if (myContext.IsNull())
+  {
+    return;
+  }
+
+  // lay out boxes and cones of the demo scene on a square grid
+  const int    aNbCols = std::max(1, static_cast<int>(std::ceil(std::sqrt(theNbShapes))));
+  const double aStep   = 100.0;
+  for (int aShapeIter = 0; aShapeIter < theNbShapes; ++aShapeIter)
+  {
+    gp_Ax2 anAxis;
+    anAxis.SetLocation(
+      gp_Pnt(aStep * (aShapeIter % aNbCols), aStep * (aShapeIter / aNbCols), 0.0));
+
+    Handle(AIS_Shape) aShape =
+      (aShapeIter % 2) == 0 ? new AIS_Shape(BRepPrimAPI_MakeBox(anAxis, 50, 50, 50).Shape())
+                            : new AIS_Shape(BRepPrimAPI_MakeCone(anAxis, 25, 0, 50).Shape());
+    myContext->Display(aShape, AIS_Shaded, 0, false);
+  }
+}
+
+// ================================================================
+// Function : orbitCamera
+// Purpose  :
+// ================================================================
+void GlfwOcctBenchmark::orbitCamera() const
+{
+  const Handle(Graphic3d_Camera)& aCamera = myView->Camera();
+
+  gp_Trsf aRotation;
+  aRotation.SetRotation(gp_Ax1(aCamera->Center(), gp::DZ()), M_PI / 180.0);
+  aCamera->Transform(aRotation);
+  myView->Invalidate();
+}
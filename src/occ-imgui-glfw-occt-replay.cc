@@ -0,0 +1,231 @@
+#include "occ_imgui/occ-imgui-glfw-occt-replay.h"
+
+#include <GLFW/glfw3.h>
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+//! Print one row of the results table.
+void dumpReplayRow(std::ostream& theStream, const char* theName, const OccImguiFrameStats& theStats)
+{
+  theStream << std::left << std::setw(18) << theName << std::right << std::setw(8)
+            << theStats.size() << std::fixed << std::setprecision(3) << std::setw(10)
+            << theStats.minimum() << std::setw(12) << theStats.median() << std::setw(10)
+            << theStats.percentile(99.0) << "\n";
+}
+} // namespace
+
+// ================================================================
+// Function : GlfwOcctReplay
+// Purpose  :
+// ================================================================
+GlfwOcctReplay::GlfwOcctReplay()
+{
+  setHeadless(true);
+}
+
+// ================================================================
+// Function : perform
+// Purpose  :
+// ================================================================
+bool GlfwOcctReplay::perform(const Parameters& theParams)
+{
+  myParams    = theParams;
+  myNextEvent = 0;
+  myFrames.clear();
+  myFrameStats.reset();
+  mySceneStats.reset();
+  myError.clear();
+  if (!myReplay.read(myParams.RecordingPath))
+  {
+    myError = "Unable to read recording '" + myParams.RecordingPath + "'";
+    return false;
+  }
+
+  const Graphic3d_Vec2i aSize = myReplay.windowSize();
+  initWindow(std::max(aSize.x(), 1), std::max(aSize.y(), 1), "OCCT IMGUI Replay");
+  initViewer();
+  if (myView.IsNull())
+  {
+    if (!myOcctWindow.IsNull())
+    {
+      myOcctWindow->Close();
+    }
+    glfwTerminate();
+    myError = "Unable to create an offscreen OpenGL viewer";
+    return false;
+  }
+
+  // window input is ignored from now on, the GUI and the view follow the replay clock
+  const double aStep = std::max(myParams.FrameStep, 1.0e-3);
+  myFrameClock       = 0.0;
+  myFrameClockStep   = aStep;
+
+  // the degraded resolution follows measured frame times, which differ from run to run
+  myAdaptiveResolution.setEnabled(false);
+  initDemoScene();
+  myView->MustBeResized();
+  initGui();
+  myProfiler.setGlContext(glContext());
+
+  // the recorded model is loaded before the clock starts
+  if (!myReplay.modelPath().empty())
+  {
+    openFile(myReplay.modelPath().c_str());
+    while (myImporter.isRunning() || myImporter.hasPendingObjects())
+    {
+      glfwWaitEventsTimeout(0.05);
+      renderFrame(myFrameClock);
+    }
+  }
+  for (int aFrameIter = 0; aFrameIter < myParams.NbWarmupFrames; ++aFrameIter)
+  {
+    renderFrame(myFrameClock);
+  }
+  if (myParams.ToSyncGpu)
+  {
+    finishGpu();
+  }
+
+  const double anEnd    = myReplay.duration() + std::max(myParams.TailTime, 0.0);
+  const size_t aNbSteps = static_cast<size_t>(anEnd / aStep) + 1;
+  myFrames.reserve(aNbSteps);
+  myFrameStats.reserve(aNbSteps);
+  for (size_t aFrameIter = 1; aFrameIter <= aNbSteps; ++aFrameIter)
+  {
+    myFrameClock = static_cast<double>(aFrameIter) * aStep;
+    glfwPollEvents();
+
+    FrameTiming aTiming;
+    aTiming.Time     = myFrameClock;
+    aTiming.NbEvents = feedEvents(myFrameClock);
+
+    const size_t aNbSceneFrames = myNbSceneFrames;
+    const auto   aStart         = std::chrono::steady_clock::now();
+    renderFrame(myFrameClock);
+    if (myParams.ToSyncGpu)
+    {
+      finishGpu();
+    }
+    aTiming.Millis =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - aStart).count();
+    aTiming.IsScene = myNbSceneFrames != aNbSceneFrames;
+
+    myFrames.push_back(aTiming);
+    myFrameStats.add(aTiming.Millis);
+    if (aTiming.IsScene)
+    {
+      mySceneStats.add(aTiming.Millis);
+    }
+  }
+
+  cleanup();
+  return true;
+}
+
+// ================================================================
+// Function : feedEvents
+// Purpose  :
+// ================================================================
+size_t GlfwOcctReplay::feedEvents(const double theTime)
+{
+  // ImGui receives the events as from its GLFW callbacks (which see no input in a hidden window),
+  // the view receives them through the input queue as from the callbacks of GlfwOcctView
+  ImGuiIO&                                          aIO      = ImGui::GetIO();
+  const std::vector<OccImguiInputRecording::Event>& anEvents = myReplay.events();
+  const size_t                                      aFirst   = myNextEvent;
+  for (; myNextEvent < anEvents.size() && anEvents[myNextEvent].Time <= theTime; ++myNextEvent)
+  {
+    const OccImguiInputRecording::Event& anEvent = anEvents[myNextEvent];
+
+    const ImVec2 aPos(static_cast<float>(anEvent.Position.x()),
+                      static_cast<float>(anEvent.Position.y()));
+    switch (anEvent.Type)
+    {
+      case OccImguiInputRecording::EventType_MouseMove: {
+        aIO.AddMousePosEvent(aPos.x, aPos.y);
+        myInputQueue.pushMouseMove(anEvent.Position);
+        break;
+      }
+      case OccImguiInputRecording::EventType_MouseButton: {
+        aIO.AddKeyEvent(ImGuiMod_Ctrl, (anEvent.Mods & GLFW_MOD_CONTROL) != 0);
+        aIO.AddKeyEvent(ImGuiMod_Shift, (anEvent.Mods & GLFW_MOD_SHIFT) != 0);
+        aIO.AddKeyEvent(ImGuiMod_Alt, (anEvent.Mods & GLFW_MOD_ALT) != 0);
+        aIO.AddMousePosEvent(aPos.x, aPos.y);
+        if (anEvent.Button >= 0 && anEvent.Button < ImGuiMouseButton_COUNT)
+        {
+          aIO.AddMouseButtonEvent(anEvent.Button, anEvent.Action == GLFW_PRESS);
+        }
+        myInputQueue.pushMouseButton(anEvent.Position,
+                                     anEvent.Button,
+                                     anEvent.Action,
+                                     anEvent.Mods);
+        break;
+      }
+      case OccImguiInputRecording::EventType_Scroll: {
+        aIO.AddMousePosEvent(aPos.x, aPos.y);
+        aIO.AddMouseWheelEvent(0.0f, static_cast<float>(anEvent.ScrollDelta));
+        myInputQueue.pushScroll(anEvent.Position, anEvent.ScrollDelta);
+        break;
+      }
+      case OccImguiInputRecording::EventType_Resize: {
+        glfwSetWindowSize(myOcctWindow->getGlfwWindow(),
+                          anEvent.Position.x(),
+                          anEvent.Position.y());
+        myInputQueue.pushResize(anEvent.Position, anEvent.Time);
+        break;
+      }
+      case OccImguiInputRecording::EventType_NB:
+        break;
+    }
+  }
+  return myNextEvent - aFirst;
+}
+
+// ================================================================
+// Function : dump
+// Purpose  :
+// ================================================================
+void GlfwOcctReplay::dump(std::ostream& theStream) const
+{
+  theStream << "Replay: " << myParams.RecordingPath << ", " << myReplay.events().size()
+            << " events over " << std::fixed << std::setprecision(2) << myReplay.duration()
+            << " s, " << myReplay.windowSize().x() << "x" << myReplay.windowSize().y() << ", "
+            << myFrames.size() << " frames of " << std::setprecision(3)
+            << myParams.FrameStep * 1000.0 << " ms"
+            << (myParams.ToSyncGpu ? " (GPU synchronized)" : "") << "\n";
+  if (!myReplay.modelPath().empty())
+  {
+    theStream << "Model: " << myReplay.modelPath() << "\n";
+  }
+  theStream << std::left << std::setw(18) << "Frames" << std::right << std::setw(8) << "count"
+            << std::setw(10) << "min, ms" << std::setw(12) << "median, ms" << std::setw(10)
+            << "p99, ms"
+            << "\n";
+  dumpReplayRow(theStream, "All", myFrameStats);
+  dumpReplayRow(theStream, "Scene redraws", mySceneStats);
+}
+
+// ================================================================
+// Function : writeTimings
+// Purpose  :
+// ================================================================
+bool GlfwOcctReplay::writeTimings(const std::string& thePath) const
+{
+  std::ofstream aFile(thePath);
+  aFile << "frame,time_s,events,scene,frame_ms\n" << std::fixed;
+  for (size_t aFrameIter = 0; aFrameIter < myFrames.size(); ++aFrameIter)
+  {
+    const FrameTiming& aTiming = myFrames[aFrameIter];
+    aFile << aFrameIter << "," << std::setprecision(4) << aTiming.Time << "," << aTiming.NbEvents
+          << "," << (aTiming.IsScene ? 1 : 0) << "," << std::setprecision(3) << aTiming.Millis
+          << "\n";
+  }
+  return aFile.good();
+}
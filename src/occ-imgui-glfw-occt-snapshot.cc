@@ -0,0 +1,312 @@
+#include "occ_imgui/occ-imgui-glfw-occt-snapshot.h"
+
+#include "occ_imgui/occ-imgui-png-writer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/Graphic3d_Camera.hxx>
+#include <opencascade/Image_PixMap.hxx>
+#include <opencascade/Message_ProgressRange.hxx>
+#include <opencascade/Standard_Failure.hxx>
+#include <opencascade/V3d_ImageDumpOptions.hxx>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+namespace
+{
+//! Return milliseconds elapsed between two time points.
+double snapshotMillis(const std::chrono::steady_clock::time_point& theFrom,
+                      const std::chrono::steady_clock::time_point& theTo)
+{
+  return std::chrono::duration<double, std::milli>(theTo - theFrom).count();
+}
+
+//! Write the string as a quoted JSON string.
+void dumpSnapshotString(std::ostream& theStream, const std::string& theString)
+{
+  theStream << '"';
+  for (const char aChar : theString)
+  {
+    switch (aChar)
+    {
+      case '"':
+        theStream << "\\\"";
+        break;
+      case '\\':
+        theStream << "\\\\";
+        break;
+      case '\n':
+        theStream << "\\n";
+        break;
+      case '\t':
+        theStream << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(aChar) < 0x20)
+        {
+          char aBuffer[8];
+          std::snprintf(aBuffer, sizeof(aBuffer), "\\u%04x", static_cast<unsigned>(aChar));
+          theStream << aBuffer;
+        }
+        else
+        {
+          theStream << aChar;
+        }
+        break;
+    }
+  }
+  theStream << '"';
+}
+
+//! Return view orientation of the preset.
+V3d_TypeOfOrientation snapshotOrientation(const GlfwOcctSnapshot::Preset thePreset)
+{
+  switch (thePreset)
+  {
+    case GlfwOcctSnapshot::Preset_Top:
+      return V3d_Zpos;
+    case GlfwOcctSnapshot::Preset_Bottom:
+      return V3d_Zneg;
+    case GlfwOcctSnapshot::Preset_Front:
+      return V3d_Yneg;
+    case GlfwOcctSnapshot::Preset_Back:
+      return V3d_Ypos;
+    case GlfwOcctSnapshot::Preset_Left:
+      return V3d_Xneg;
+    case GlfwOcctSnapshot::Preset_Right:
+      return V3d_Xpos;
+    case GlfwOcctSnapshot::Preset_Iso:
+    case GlfwOcctSnapshot::Preset_NB:
+      break;
+  }
+  return V3d_XposYnegZpos;
+}
+} // namespace
+
+// ================================================================
+// Function : presetName
+// Purpose  :
+// ================================================================
+const char* GlfwOcctSnapshot::presetName(const int thePreset)
+{
+  switch (thePreset)
+  {
+    case Preset_Iso:
+      return "iso";
+    case Preset_Top:
+      return "top";
+    case Preset_Bottom:
+      return "bottom";
+    case Preset_Front:
+      return "front";
+    case Preset_Back:
+      return "back";
+    case Preset_Left:
+      return "left";
+    case Preset_Right:
+      return "right";
+  }
+  return "";
+}
+
+// ================================================================
+// Function : presetFromName
+// Purpose  :
+// ================================================================
+bool GlfwOcctSnapshot::presetFromName(const std::string& theName, Preset& thePreset)
+{
+  for (int aPresetIter = 0; aPresetIter < Preset_NB; ++aPresetIter)
+  {
+    if (theName == presetName(aPresetIter))
+    {
+      thePreset = static_cast<Preset>(aPresetIter);
+      return true;
+    }
+  }
+  return false;
+}
+
+// ================================================================
+// Function : dumpResults
+// Purpose  :
+// ================================================================
+void GlfwOcctSnapshot::dumpResults(std::ostream& theStream, const std::vector<Result>& theResults)
+{
+  for (size_t aResIter = 0; aResIter < theResults.size(); ++aResIter)
+  {
+    const Result& aRes = theResults[aResIter];
+    theStream << (aResIter == 0 ? "" : ",\n") << "    {\"model\": ";
+    dumpSnapshotString(theStream, aRes.Model);
+    theStream << ", \"view\": \"" << presetName(aRes.View) << "\", \"image\": ";
+    dumpSnapshotString(theStream, aRes.Image);
+    theStream << ", \"ok\": " << (aRes.IsOk ? "true" : "false") << ", \"load_ms\": " << aRes.LoadMs
+              << ", \"mesh_ms\": " << aRes.MeshMs << ", \"render_ms\": " << aRes.RenderMs
+              << ", \"write_ms\": " << aRes.WriteMs;
+    if (!aRes.Error.empty())
+    {
+      theStream << ", \"error\": ";
+      dumpSnapshotString(theStream, aRes.Error);
+    }
+    theStream << "}";
+  }
+}
+
+// ================================================================
+// Function : GlfwOcctSnapshot
+// Purpose  :
+// ================================================================
+GlfwOcctSnapshot::GlfwOcctSnapshot()
+{
+  setHeadless(true);
+}
+
+// ================================================================
+// Function : nbFailed
+// Purpose  :
+// ================================================================
+size_t GlfwOcctSnapshot::nbFailed() const
+{
+  size_t aNbFailed = 0;
+  for (const Result& aRes : myResults)
+  {
+    aNbFailed += aRes.IsOk ? 0 : 1;
+  }
+  return aNbFailed;
+}
+
+// ================================================================
+// Function : perform
+// Purpose  :
+// ================================================================
+bool GlfwOcctSnapshot::perform(const Parameters& theParams)
+{
+  myParams = theParams;
+  myResults.clear();
+
+  initWindow(myParams.Width, myParams.Height, "OCCT IMGUI Snapshot");
+  initViewer();
+  if (myView.IsNull())
+  {
+    if (!myOcctWindow.IsNull())
+    {
+      myOcctWindow->Close();
+    }
+    glfwTerminate();
+    return false;
+  }
+
+  // only the model itself appears in snapshots
+  myContext->RemoveAll(false);
+  myContext->CurrentViewer()->DeactivateGrid();
+  myView->TriedronErase();
+  myView->Camera()->SetProjectionType(Graphic3d_Camera::Projection_Orthographic);
+  myView->ChangeRenderingParams().ToShowStats   = false;
+  myView->ChangeRenderingParams().NbMsaaSamples = myParams.NbMsaaSamples;
+  myView->MustBeResized();
+  initGui();
+
+  for (const Model& aModel : myParams.Models)
+  {
+    renderModel(aModel);
+  }
+
+  cleanup();
+  return true;
+}
+
+// ================================================================
+// Function : renderModel
+// Purpose  :
+// ================================================================
+void GlfwOcctSnapshot::renderModel(const Model& theModel)
+{
+  const size_t aFirstResult = myResults.size();
+  for (const Preset aPreset : myParams.Presets)
+  {
+    Result aRes;
+    aRes.Model = theModel.Path;
+    aRes.View  = aPreset;
+    aRes.Image = (std::filesystem::path(myParams.OutputDir)
+                  / (theModel.Name + "-" + presetName(aPreset) + ".png"))
+                   .string();
+    myResults.push_back(aRes);
+  }
+  if (aFirstResult == myResults.size())
+  {
+    return;
+  }
+
+  // the model is displayed without selection modes, as snapshots are never picked
+  Result&           aFirst = myResults[aFirstResult];
+  Handle(AIS_Shape) aShape;
+  std::string       anError;
+  try
+  {
+    const auto         aStart  = std::chrono::steady_clock::now();
+    const TopoDS_Shape aTopo   = OccImguiImporter::readShape(theModel.Path.c_str(),
+                                                             Message_ProgressRange());
+    const auto         aLoaded = std::chrono::steady_clock::now();
+    aFirst.LoadMs              = snapshotMillis(aStart, aLoaded);
+    if (aTopo.IsNull())
+    {
+      anError = "unable to read the file";
+    }
+    else
+    {
+      myMeshCache.mesh({aTopo}, OccImguiMeshLodCache::Level_Medium);
+      myMeshCache.activate(aTopo, OccImguiMeshLodCache::Level_Medium);
+      aShape = new AIS_Shape(aTopo);
+      aShape->Attributes()->SetAutoTriangulation(Standard_False);
+      myContext->Display(aShape, AIS_Shaded, -1, false);
+      aFirst.MeshMs = snapshotMillis(aLoaded, std::chrono::steady_clock::now());
+    }
+  }
+  catch (const Standard_Failure& theFailure)
+  {
+    anError = theFailure.GetMessageString();
+  }
+  if (!anError.empty())
+  {
+    for (size_t aResIter = aFirstResult; aResIter < myResults.size(); ++aResIter)
+    {
+      myResults[aResIter].Error = anError;
+    }
+    myMeshCache.clear();
+    return;
+  }
+
+  V3d_ImageDumpOptions anOptions;
+  anOptions.Width      = myParams.Width;
+  anOptions.Height     = myParams.Height;
+  anOptions.BufferType = Graphic3d_BT_RGB;
+  for (size_t aResIter = aFirstResult; aResIter < myResults.size(); ++aResIter)
+  {
+    Result&    aRes   = myResults[aResIter];
+    const auto aStart = std::chrono::steady_clock::now();
+    myView->SetProj(snapshotOrientation(aRes.View), false);
+    myView->FitAll(0.01, false);
+
+    Image_PixMap anImage;
+    if (!myView->ToPixMap(anImage, anOptions))
+    {
+      aRes.Error = "unable to render the view";
+      continue;
+    }
+
+    const auto aRendered = std::chrono::steady_clock::now();
+    aRes.RenderMs        = snapshotMillis(aStart, aRendered);
+    aRes.IsOk            = OccImguiPngWriter::write(anImage, aRes.Image);
+    aRes.WriteMs         = snapshotMillis(aRendered, std::chrono::steady_clock::now());
+    if (!aRes.IsOk)
+    {
+      aRes.Error = "unable to write the image";
+    }
+  }
+
+  // triangulations of the model are not needed anymore, the disk cache keeps them
+  myContext->Remove(aShape, false);
+  myMeshCache.clear();
+}
@@ -1,23 +1,92 @@
 #include "occ_imgui/occ-imgui-glfw-occt-view.h"
 
+#include "occ_imgui/occ-imgui-box-placeholder.h"
+
 #include <GLFW/glfw3.h>
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
+#include <imgui_internal.h>
 
+#include <opencascade/AIS_ConnectedInteractive.hxx>
 #include <opencascade/AIS_Shape.hxx>
 #include <opencascade/AIS_ViewCube.hxx>
 #include <opencascade/BRepPrimAPI_MakeBox.hxx>
 #include <opencascade/BRepPrimAPI_MakeCone.hxx>
+#include <opencascade/Graphic3d_Camera.hxx>
 #include <opencascade/Message.hxx>
 #include <opencascade/Message_Messenger.hxx>
+#include <opencascade/OpenGl_Context.hxx>
 #include <opencascade/OpenGl_GraphicDriver.hxx>
+#include <opencascade/OpenGl_View.hxx>
+#include <opencascade/OpenGl_Window.hxx>
 #include <opencascade/Graphic3d_GraphicDriver.hxx>
+#include <opencascade/OSD_Parallel.hxx>
+#include <opencascade/StdSelect_ViewerSelector3d.hxx>
+#include <opencascade/TopAbs.hxx>
 #include <opencascade/V3d_Viewer.hxx>
 
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <unordered_set>
+
 namespace
 {
+//! Time per frame spent on displaying imported objects, in milliseconds.
+constexpr double THE_IMPORT_FRAME_BUDGET_MS = 8.0;
+
+//! Number of imported objects fetched from the importer at once.
+constexpr size_t THE_IMPORT_BATCH_SIZE = 16;
+
+//! Tessellation error in pixels tolerated by automatic level selection.
+constexpr double THE_MESH_LEVEL_PIXEL_ERROR = 1.0;
+
+//! Minimal interval between automatic level updates while the camera moves, in seconds.
+constexpr double THE_MESH_LEVEL_UPDATE_INTERVAL = 0.25;
+
+//! Time without new resize events after which the window size is considered settled, in seconds.
+constexpr double THE_RESIZE_DEBOUNCE_TIME = 0.1;
+
+//! Minimal interval between hover detections, in seconds; slower detections stretch it further.
+constexpr double THE_HOVER_MIN_INTERVAL = 1.0 / 60.0;
+
+//! Magnification of detail views relative to the active view.
+constexpr double THE_DETAIL_VIEW_ZOOM = 4.0;
+
+//! Number of latest frames shown by profiler graphs.
+constexpr size_t THE_PROFILER_GRAPH_FRAMES = 240;
+
+//! Number of the largest shapes listed by the memory section.
+constexpr size_t THE_MEMORY_TABLE_ROWS = 16;
+
+//! Interval between retries of the event thread while the render command queue is full, in seconds.
+constexpr double THE_RENDER_BACKLOG_RETRY = 0.001;
+
+//! Time per frame spent on filtering and indexing objects of the "Scene" panel, in milliseconds.
+constexpr double THE_SCENE_INDEX_FRAME_BUDGET_MS = 2.0;
+
+//! Number of objects filtered or indexed between checks of the frame budget.
+constexpr size_t THE_SCENE_INDEX_BATCH_SIZE = 1024;
+
+//! Return the first selected object of the context, or NULL.
+const AIS_InteractiveObject* firstSelectedSceneObject(const Handle(AIS_InteractiveContext)& theCtx)
+{
+  theCtx->InitSelected();
+  return theCtx->MoreSelected() ? theCtx->SelectedInteractive().get() : nullptr;
+}
+
+//! Convert bytes into megabytes for display.
+double toMegabytes(const size_t theBytes)
+{
+  return static_cast<double>(theBytes) / (1024.0 * 1024.0);
+}
+
 //! Convert GLFW mouse button into Aspect_VKeyMouse.
 Aspect_VKeyMouse mouseButtonFromGlfw(const int theButton)
 {
@@ -55,13 +124,122 @@ Aspect_VKeyFlags keyFlagsFromGlfw(const int theFlags)
   }
   return aFlags;
 }
+
+//! Convert GLFW key into ImGuiKey; keys not used by ImGui widgets map to ImGuiKey_None.
+ImGuiKey imguiKeyFromGlfw(const int theKey)
+{
+  if (theKey >= GLFW_KEY_A && theKey <= GLFW_KEY_Z)
+  {
+    return static_cast<ImGuiKey>(ImGuiKey_A + (theKey - GLFW_KEY_A));
+  }
+  if (theKey >= GLFW_KEY_0 && theKey <= GLFW_KEY_9)
+  {
+    return static_cast<ImGuiKey>(ImGuiKey_0 + (theKey - GLFW_KEY_0));
+  }
+  if (theKey >= GLFW_KEY_F1 && theKey <= GLFW_KEY_F12)
+  {
+    return static_cast<ImGuiKey>(ImGuiKey_F1 + (theKey - GLFW_KEY_F1));
+  }
+  switch (theKey)
+  {
+    case GLFW_KEY_TAB:
+      return ImGuiKey_Tab;
+    case GLFW_KEY_LEFT:
+      return ImGuiKey_LeftArrow;
+    case GLFW_KEY_RIGHT:
+      return ImGuiKey_RightArrow;
+    case GLFW_KEY_UP:
+      return ImGuiKey_UpArrow;
+    case GLFW_KEY_DOWN:
+      return ImGuiKey_DownArrow;
+    case GLFW_KEY_PAGE_UP:
+      return ImGuiKey_PageUp;
+    case GLFW_KEY_PAGE_DOWN:
+      return ImGuiKey_PageDown;
+    case GLFW_KEY_HOME:
+      return ImGuiKey_Home;
+    case GLFW_KEY_END:
+      return ImGuiKey_End;
+    case GLFW_KEY_INSERT:
+      return ImGuiKey_Insert;
+    case GLFW_KEY_DELETE:
+      return ImGuiKey_Delete;
+    case GLFW_KEY_BACKSPACE:
+      return ImGuiKey_Backspace;
+    case GLFW_KEY_SPACE:
+      return ImGuiKey_Space;
+    case GLFW_KEY_ENTER:
+      return ImGuiKey_Enter;
+    case GLFW_KEY_KP_ENTER:
+      return ImGuiKey_KeypadEnter;
+    case GLFW_KEY_ESCAPE:
+      return ImGuiKey_Escape;
+    case GLFW_KEY_LEFT_CONTROL:
+      return ImGuiKey_LeftCtrl;
+    case GLFW_KEY_RIGHT_CONTROL:
+      return ImGuiKey_RightCtrl;
+    case GLFW_KEY_LEFT_SHIFT:
+      return ImGuiKey_LeftShift;
+    case GLFW_KEY_RIGHT_SHIFT:
+      return ImGuiKey_RightShift;
+    case GLFW_KEY_LEFT_ALT:
+      return ImGuiKey_LeftAlt;
+    case GLFW_KEY_RIGHT_ALT:
+      return ImGuiKey_RightAlt;
+    case GLFW_KEY_LEFT_SUPER:
+      return ImGuiKey_LeftSuper;
+    case GLFW_KEY_RIGHT_SUPER:
+      return ImGuiKey_RightSuper;
+  }
+  return ImGuiKey_None;
+}
+
+//! Return GLFW key modifiers after the key event; GLFW reports the state before it
+//! for the modifier keys themselves.
+int modifiersAfterGlfwKey(const int theKey, const int theAction, const int theMods)
+{
+  int aMod = 0;
+  switch (theKey)
+  {
+    case GLFW_KEY_LEFT_CONTROL:
+    case GLFW_KEY_RIGHT_CONTROL:
+      aMod = GLFW_MOD_CONTROL;
+      break;
+    case GLFW_KEY_LEFT_SHIFT:
+    case GLFW_KEY_RIGHT_SHIFT:
+      aMod = GLFW_MOD_SHIFT;
+      break;
+    case GLFW_KEY_LEFT_ALT:
+    case GLFW_KEY_RIGHT_ALT:
+      aMod = GLFW_MOD_ALT;
+      break;
+    case GLFW_KEY_LEFT_SUPER:
+    case GLFW_KEY_RIGHT_SUPER:
+      aMod = GLFW_MOD_SUPER;
+      break;
+  }
+  return theAction == GLFW_RELEASE ? (theMods & ~aMod) : (theMods | aMod);
+}
+
+//! Hand GLFW key modifiers over to ImGui.
+void addImguiKeyMods(ImGuiIO& theIO, const int theMods)
+{
+  theIO.AddKeyEvent(ImGuiMod_Ctrl, (theMods & GLFW_MOD_CONTROL) != 0);
+  theIO.AddKeyEvent(ImGuiMod_Shift, (theMods & GLFW_MOD_SHIFT) != 0);
+  theIO.AddKeyEvent(ImGuiMod_Alt, (theMods & GLFW_MOD_ALT) != 0);
+  theIO.AddKeyEvent(ImGuiMod_Super, (theMods & GLFW_MOD_SUPER) != 0);
+}
 } // namespace
 
 // ================================================================
 // Function : GlfwOcctView
 // Purpose  :
 // ================================================================
-GlfwOcctView::GlfwOcctView() = default;
+GlfwOcctView::GlfwOcctView()
+{
+  myMeshCache.setDiskCache(&myMeshDiskCache);
+  std::snprintf(myTracePath.data(), myTracePath.size(), "%s", "occ-imgui-trace.json");
+}
 
 // ================================================================
 // Function : ~GlfwOcctView
@@ -95,6 +273,7 @@ void GlfwOcctView::errorCallback(const int theError, const char* theDescription)
 // ================================================================
 void GlfwOcctView::run()
 {
+  myStartupTimeline.start();
   initWindow(1300, 900, "OCCT IMGUI");
   initViewer();
   initDemoScene();
@@ -104,18 +283,102 @@ void GlfwOcctView::run()
   }
 
   myView->MustBeResized();
-  myOcctWindow->Map();
-  initGui();
-  mainloop();
+  if (!myIsHeadless)
+  {
+    OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "show window");
+    myOcctWindow->Map();
+  }
+  if (!myRecordPath.empty())
+  {
+    // recording starts with the model given on the command line, so that replays load it too
+    int aWidth = 0, aHeight = 0;
+    glfwGetWindowSize(myOcctWindow->getGlfwWindow(), &aWidth, &aHeight);
+    myInputRecording.clear();
+    myInputRecording.setWindowSize(Graphic3d_Vec2i(aWidth, aHeight));
+    myInputRecording.setModelPath(myPendingImport.ToCString());
+    myRecordStartTime = glfwGetTime();
+  }
+
+  // wake up the frame loop as soon as background threads have results for the GUI thread
+  myImporter.setWakeupCallback([this]() { wakeup(); });
+  myModeling.setWakeupCallback([this]() { wakeup(); });
+  myMeshCache.setWakeupCallback([this]() { wakeup(); });
+  if (!myPendingImport.IsEmpty())
+  {
+    openFile(myPendingImport);
+    myPendingImport.Clear();
+  }
+
+  // frame pacing follows the refresh rate of the primary monitor
+  if (const GLFWvidmode* aMode = glfwGetVideoMode(glfwGetPrimaryMonitor()); aMode != nullptr)
+  {
+    myFramePacer.setRefreshRate(aMode->refreshRate);
+  }
+  const bool hasSwapTear = glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE
+                           || glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE;
+  myFramePacer.setSwapTearSupported(hasSwapTear);
+
+  if (!hasRenderThread())
+  {
+    initGui();
+    myProfiler.setGlContext(glContext());
+    mainloop();
+    cleanup();
+    return;
+  }
+
+  // the render thread takes the OpenGL context over until it stops;
+  // GLFW events can only be processed by the main thread
+  glfwGetWindowSize(myOcctWindow->getGlfwWindow(), &myWindowSize.x(), &myWindowSize.y());
+  glfwGetFramebufferSize(myOcctWindow->getGlfwWindow(),
+                         &myFramebufferSize.x(),
+                         &myFramebufferSize.y());
+  glfwMakeContextCurrent(nullptr);
+  myToStopRender = false;
+  myRenderThread = std::thread([this]() { renderLoop(); });
+  eventLoop();
+
+  myToStopRender = true;
+  wakeup();
+  myRenderThread.join();
+  glfwMakeContextCurrent(myOcctWindow->getGlfwWindow());
   cleanup();
 }
 
+// ================================================================
+// Function : openFile
+// Purpose  :
+// ================================================================
+void GlfwOcctView::openFile(const TCollection_AsciiString& thePath)
+{
+  if (myContext.IsNull())
+  {
+    myPendingImport = thePath;
+    return;
+  }
+
+  if (!OccImguiImporter::isSupportedFile(thePath))
+  {
+    Message::DefaultMessenger()->Send(TCollection_AsciiString("Unsupported file format '")
+                                        + thePath + "'",
+                                      Message_Fail);
+    return;
+  }
+
+  if (myImporter.start(thePath))
+  {
+    myNbImportedObjects = 0;
+    myIsImportFitted    = false;
+  }
+}
+
 // ================================================================
 // Function : initWindow
 // Purpose  :
 // ================================================================
 void GlfwOcctView::initWindow(const int theWidth, const int theHeight, const char* theTitle)
 {
+  OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "window");
   glfwSetErrorCallback(GlfwOcctView::errorCallback);
   glfwInit();
 
@@ -133,7 +396,16 @@ void GlfwOcctView::initWindow(const int theWidth, const int theHeight, const cha
     // glfwWindowHint(GLFW_DECORATED, GL_FALSE);
   }
 
+  // headless mode keeps the window hidden; with an X server (e.g. Xvfb) and software Mesa
+  // (LIBGL_ALWAYS_SOFTWARE=1) this is enough to render on machines without a GPU or display
+  glfwWindowHint(GLFW_VISIBLE, myIsHeadless ? GLFW_FALSE : GLFW_TRUE);
+
   myOcctWindow = new GlfwOcctWindow(theWidth, theHeight, theTitle);
+  if (myOcctWindow->getGlfwWindow() == nullptr)
+  {
+    return;
+  }
+  myOcctWindow->SetVirtual(myIsHeadless);
   glfwSetWindowUserPointer(myOcctWindow->getGlfwWindow(), this);
 
   // window callback
@@ -144,6 +416,15 @@ void GlfwOcctView::initWindow(const int theWidth, const int theHeight, const cha
   glfwSetScrollCallback(myOcctWindow->getGlfwWindow(), onMouseScrollCallback);
   glfwSetMouseButtonCallback(myOcctWindow->getGlfwWindow(), onMouseButtonCallback);
   glfwSetCursorPosCallback(myOcctWindow->getGlfwWindow(), onMouseMoveCallback);
+
+  // without a render thread, the GLFW backend of ImGui installs its own keyboard callbacks
+  if (hasRenderThread())
+  {
+    glfwSetKeyCallback(myOcctWindow->getGlfwWindow(), onKeyCallback);
+    glfwSetCharCallback(myOcctWindow->getGlfwWindow(), onCharCallback);
+    glfwSetWindowFocusCallback(myOcctWindow->getGlfwWindow(), onFocusCallback);
+    glfwSetCursorEnterCallback(myOcctWindow->getGlfwWindow(), onCursorEnterCallback);
+  }
 }
 
 // ================================================================
@@ -157,9 +438,12 @@ void GlfwOcctView::initViewer()
     return;
   }
 
+  OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "viewer");
   Handle(OpenGl_GraphicDriver) aGraphicDriver =
     new OpenGl_GraphicDriver(myOcctWindow->GetDisplay(), false);
   aGraphicDriver->SetBuffersNoSwap(true);
+  // the offscreen framebuffer is blended by ImGui, so the background should be opaque
+  aGraphicDriver->ChangeOptions().buffersOpaqueAlpha = true;
 
   // Cast to base driver type expected by V3d_Viewer constructor
   const Handle(Graphic3d_GraphicDriver) aBaseDriver = aGraphicDriver;
@@ -167,37 +451,260 @@ void GlfwOcctView::initViewer()
   aViewer->SetDefaultLights();
   aViewer->SetLightOn();
   aViewer->SetDefaultTypeOfView(V3d_PERSPECTIVE);
-  aViewer->ActivateGrid(Aspect_GT_Rectangular, Aspect_GDM_Lines);
-
-  myView = aViewer->CreateView();
-  // myView->SetImmediateUpdate(false);
-  myView->SetWindow(myOcctWindow, myOcctWindow->NativeGlContext());
-  myView->ChangeRenderingParams().ToShowStats = true;
 
   myContext = new AIS_InteractiveContext(aViewer);
+  setActiveViewPanel(addViewPanel(ViewKind_Perspective));
+
+  // selection BVHs of displayed objects are built by worker threads in background,
+  // instead of on the GUI thread by the first detection under the cursor
+  myContext->MainSelector()->SetToPrebuildBVH(
+    Standard_True,
+    std::max(OSD_Parallel::NbLogicalProcessors() - 1, 1));
+
+  // the grid and the view cube are not needed to show the first frame, see completeStartup()
+  myIsStartupPending = true;
+}
+
+// ================================================================
+// Function : completeStartup
+// Purpose  :
+// ================================================================
+void GlfwOcctView::completeStartup()
+{
+  if (!myIsStartupPending || myContext.IsNull())
+  {
+    return;
+  }
+
+  myIsStartupPending = false;
+  {
+    OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "grid");
+    myContext->CurrentViewer()->ActivateGrid(Aspect_GT_Rectangular, Aspect_GDM_Lines);
+  }
+  {
+    // face labels of the cube need a system font, looked up and rasterized on first display
+    OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "view cube");
+    Handle(AIS_ViewCube)           aCube = new AIS_ViewCube();
+    aCube->SetSize(55);
+    aCube->SetFontHeight(12);
+    aCube->SetAxesLabels("", "", "");
+    aCube->SetTransformPersistence(new Graphic3d_TransformPers(Graphic3d_TMF_TriedronPers,
+                                                               Aspect_TOTP_LEFT_LOWER,
+                                                               Graphic3d_Vec2i(100, 100)));
+    aCube->SetViewAnimation(this->ViewAnimation());
+    aCube->SetFixedAnimationLoop(false);
+    myContext->Display(aCube, false);
+  }
+  if (!myView.IsNull())
+  {
+    OccImguiStartupTimeline::Scope       aScope(myStartupTimeline, "diagnostics");
+    TColStd_IndexedDataMapOfStringString aRendInfo;
+    myView->DiagnosticInformation(aRendInfo, Graphic3d_DiagnosticInfo_Basic);
+    TCollection_AsciiString aGlInfo;
+    for (TColStd_IndexedDataMapOfStringString::Iterator aValueIter(aRendInfo); aValueIter.More();
+         aValueIter.Next())
+    {
+      if (!aGlInfo.IsEmpty())
+      {
+        aGlInfo += "\n";
+      }
+      aGlInfo += TCollection_AsciiString("  ") + aValueIter.Key() + ": " + aValueIter.Value();
+    }
+    Message::DefaultMessenger()->Send(TCollection_AsciiString("OpenGL info:\n") + aGlInfo,
+                                      Message_Info);
+  }
+  invalidateViews();
+
+  if (myToPrintStartupTimeline)
+  {
+    myStartupTimeline.dump(std::cout);
+    std::cout.flush();
+  }
+}
+
+// ================================================================
+// Function : viewKindName
+// Purpose  :
+// ================================================================
+const char* GlfwOcctView::viewKindName(const int theKind)
+{
+  switch (theKind)
+  {
+    case ViewKind_Perspective:
+      return "Perspective";
+    case ViewKind_Top:
+      return "Top";
+    case ViewKind_Front:
+      return "Front";
+    case ViewKind_Side:
+      return "Side";
+    case ViewKind_Detail:
+      return "Detail";
+  }
+  return "";
+}
+
+// ================================================================
+// Function : addViewPanel
+// Purpose  :
+// ================================================================
+GlfwOcctView::ViewPanel* GlfwOcctView::addViewPanel(const ViewKind theKind)
+{
+  // the view renders into an offscreen framebuffer shown by the panel;
+  // the neutral window shares the native handle of GLFW window but is sized to the panel
+  Standard_Integer aWidth = 0, aHeight = 0;
+  myOcctWindow->Size(aWidth, aHeight);
+  std::unique_ptr<ViewPanel> aPanel = std::make_unique<ViewPanel>();
+  aPanel->Kind                      = theKind;
+  aPanel->Window                    = new Aspect_NeutralWindow();
+  aPanel->Window->SetNativeHandle(myOcctWindow->NativeHandle());
+  aPanel->Window->SetSize(aWidth, aHeight);
+  aPanel->Window->SetVirtual(myIsHeadless);
+
+  // the first panel keeps the window name of the default layout
+  aPanel->Title = myViewPanels.empty() ? std::string("3D View")
+                                       : std::string(viewKindName(theKind)) + " View "
+                                           + std::to_string(myNbCreatedViews);
+  ++myNbCreatedViews;
+
+  // all views share the viewer, the context and the OpenGL context,
+  // so presentations are uploaded to the GPU only once
+  aPanel->View                  = myContext->CurrentViewer()->CreateView();
+  const Handle(V3d_View)& aView = aPanel->View;
+  aView->SetWindow(aPanel->Window, myOcctWindow->NativeGlContext());
+
+  // every view has its own OCCT context sharing the OpenGL one, and may link further programs
+  if (const Handle(OpenGl_View) aGlView = Handle(OpenGl_View)::DownCast(aView->View());
+      !aGlView.IsNull() && !aGlView->GlWindow().IsNull())
+  {
+    myProgramCache.install(aGlView->GlWindow()->GetGlContext());
+  }
+  aView->ChangeRenderingParams().ToShowStats = myViewPanels.empty();
+  aView->TriedronDisplay(Aspect_TOTP_LEFT_LOWER, Quantity_NOC_GOLD, 0.08, V3d_WIREFRAME);
+  mySceneLod.setupView(aView);
+  myAdaptiveResolution.setupView(aView);
+  switch (theKind)
+  {
+    case ViewKind_Perspective:
+      break;
+    case ViewKind_Top:
+    case ViewKind_Front:
+    case ViewKind_Side: {
+      aView->Camera()->SetProjectionType(Graphic3d_Camera::Projection_Orthographic);
+      aView->SetProj(theKind == ViewKind_Top     ? V3d_Zpos
+                     : theKind == ViewKind_Front ? V3d_Yneg
+                                                 : V3d_Xpos,
+                     false);
+      aView->FitAll(0.01, false);
+      break;
+    }
+    case ViewKind_Detail: {
+      if (!myView.IsNull())
+      {
+        aView->Camera()->Copy(myView->Camera());
+      }
+      aView->Camera()->SetScale(aView->Camera()->Scale() / THE_DETAIL_VIEW_ZOOM);
+      break;
+    }
+    case ViewKind_NB:
+      break;
+  }
+
+  myViewPanels.push_back(std::move(aPanel));
+  return myViewPanels.back().get();
+}
+
+// ================================================================
+// Function : releaseViewPanel
+// Purpose  :
+// ================================================================
+void GlfwOcctView::releaseViewPanel(ViewPanel& thePanel)
+{
+  if (!thePanel.Fbo.IsNull())
+  {
+    thePanel.View->View()->SetFBO(Handle(Standard_Transient)());
+    thePanel.Fbo->Release(glContext().get());
+    thePanel.Fbo.Nullify();
+  }
+  if (!thePanel.View.IsNull())
+  {
+    myAdaptiveResolution.release(thePanel.View);
+    thePanel.View->Remove();
+    thePanel.View.Nullify();
+  }
+}
+
+// ================================================================
+// Function : setActiveViewPanel
+// Purpose  :
+// ================================================================
+void GlfwOcctView::setActiveViewPanel(ViewPanel* thePanel)
+{
+  myActivePanel = thePanel;
+  myView        = thePanel != nullptr ? thePanel->View : Handle(V3d_View)();
+}
 
-  Handle(AIS_ViewCube) aCube = new AIS_ViewCube();
-  aCube->SetSize(55);
-  aCube->SetFontHeight(12);
-  aCube->SetAxesLabels("", "", "");
-  aCube->SetTransformPersistence(new Graphic3d_TransformPers(Graphic3d_TMF_TriedronPers,
-                                                             Aspect_TOTP_LEFT_LOWER,
-                                                             Graphic3d_Vec2i(100, 100)));
-  aCube->SetViewAnimation(this->ViewAnimation());
-  aCube->SetFixedAnimationLoop(false);
-  myContext->Display(aCube, false);
+// ================================================================
+// Function : setViewPanelVisible
+// Purpose  :
+// ================================================================
+void GlfwOcctView::setViewPanelVisible(ViewPanel& thePanel, const bool theIsVisible)
+{
+  if (thePanel.IsVisible == theIsVisible)
+  {
+    return;
+  }
+
+  thePanel.IsVisible               = theIsVisible;
+  const Handle(V3d_Viewer) aViewer = thePanel.View->Viewer();
+  if (theIsVisible)
+  {
+    aViewer->SetViewOn(thePanel.View);
+    thePanel.View->Invalidate();
+  }
+  else
+  {
+    aViewer->SetViewOff(thePanel.View);
+  }
+}
+
+// ================================================================
+// Function : invalidateViews
+// Purpose  :
+// ================================================================
+void GlfwOcctView::invalidateViews()
+{
+  if (!myContext.IsNull())
+  {
+    myContext->CurrentViewer()->Invalidate();
+  }
 }
 
-void GlfwOcctView::initGui() const
+void GlfwOcctView::initGui()
 {
+  OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "gui");
   IMGUI_CHECKVERSION();
   ImGui::CreateContext();
 
   ImGuiIO& aIO = ImGui::GetIO();
   aIO.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-  aIO.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+  if (myIsHeadless || !myRecordPath.empty())
+  {
+    // platform windows cannot be hidden (nor recorded), and a stored layout would make runs
+    // non-reproducible
+    aIO.IniFilename = nullptr;
+  }
+  else if (!hasRenderThread())
+  {
+    aIO.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
+  }
 
-  ImGui_ImplGlfw_InitForOpenGL(myOcctWindow->getGlfwWindow(), true);
+  // the GLFW backend queries the window on every frame, which is restricted to the main thread;
+  // the render thread feeds window events to ImGui itself, see applyRenderCommands()
+  if (!hasRenderThread())
+  {
+    ImGui_ImplGlfw_InitForOpenGL(myOcctWindow->getGlfwWindow(), true);
+  }
   ImGui_ImplOpenGL3_Init("#version 330 core");
 
   // Setup Dear ImGui style.
@@ -206,64 +713,178 @@ void GlfwOcctView::initGui() const
 
 void GlfwOcctView::renderGui()
 {
-  ImGui_ImplOpenGL3_NewFrame();
-  ImGui_ImplGlfw_NewFrame();
-  ImGui::NewFrame();
+  {
+    OccImguiProfiler::Scope aBuildScope(myProfiler, OccImguiProfiler::Stage_GuiBuild);
+    ImGui_ImplOpenGL3_NewFrame();
+    if (hasRenderThread())
+    {
+      newGuiPlatformFrame();
+    }
+    else
+    {
+      ImGui_ImplGlfw_NewFrame();
+    }
+    if (myFrameClock >= 0.0 && myFrameClockStep > 0.0)
+    {
+      // GUI animations and double clicks follow the replay clock
+      ImGui::GetIO().DeltaTime = static_cast<float>(myFrameClockStep);
+    }
+    ImGui::NewFrame();
+    ++myNbGuiFrames;
+    buildGui();
+    ImGui::Render();
+  }
 
-  // Create main dockspace
-  const ImGuiID dockspaceId = ImGui::GetID("MainDockSpace");
-  ImGui::DockSpace(dockspaceId, ImVec2(0.0f, 0.0f), ImGuiDockNodeFlags_PassthruCentralNode);
+  {
+    OccImguiProfiler::Scope aRenderScope(myProfiler, OccImguiProfiler::Stage_GuiRender, true);
+    // OCCT no longer paints the window itself, only the offscreen framebuffer of the panel
+    if (const Handle(OpenGl_Context) aGlCtx = glContext(); !aGlCtx.IsNull())
+    {
+      Graphic3d_Vec2i aSize = myFramebufferSize;
+      if (!hasRenderThread())
+      {
+        glfwGetFramebufferSize(myOcctWindow->getGlfwWindow(), &aSize.x(), &aSize.y());
+      }
+      aGlCtx->core11fwd->glViewport(0, 0, aSize.x(), aSize.y());
+      aGlCtx->core11fwd->glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+      aGlCtx->core11fwd->glClear(GL_COLOR_BUFFER_BIT);
+    }
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  }
 
-  // 3D View Window - set to dock into the main area by default
-  ImGui::SetNextWindowDockID(dockspaceId, ImGuiCond_FirstUseEver);
-  if (ImGui::Begin("3D View", nullptr, ImGuiWindowFlags_NoScrollbar))
+  // Handle multi-viewport rendering
+  if (const ImGuiIO& io = ImGui::GetIO(); io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
   {
-    // Get the available content region
-    const ImVec2 viewportSize = ImGui::GetContentRegionAvail();
+    OccImguiProfiler::Scope aPlatformScope(myProfiler, OccImguiProfiler::Stage_PlatformWindows);
+    GLFWwindow*             backup_current_context = glfwGetCurrentContext();
+    ImGui::UpdatePlatformWindows();
+    ImGui::RenderPlatformWindowsDefault();
+    glfwMakeContextCurrent(backup_current_context);
+  }
 
-    // Store viewport dimensions for resize tracking
-    const bool viewportResized = myViewportWidth != static_cast<int>(viewportSize.x)
-                                 || myViewportHeight != static_cast<int>(viewportSize.y);
+  OccImguiProfiler::Scope aSwapScope(myProfiler, OccImguiProfiler::Stage_Swap);
+  if (!myIsHeadless && myFramePacer.swapInterval() != mySwapInterval)
+  {
+    mySwapInterval = myFramePacer.swapInterval();
+    glfwSwapInterval(mySwapInterval);
+  }
+  const double aSwapStart = glfwGetTime();
+  glfwSwapBuffers(myOcctWindow->getGlfwWindow());
+  myFramePacer.endFrame(aSwapStart, glfwGetTime());
 
-    if (viewportResized && viewportSize.x > 0 && viewportSize.y > 0)
+  if (!myStartupTimeline.hasFirstFrame())
+  {
+    myStartupTimeline.markFirstFrame(myStartupTimeline.elapsedMs());
+    if (!myIsHeadless)
     {
-      myViewportWidth  = static_cast<int>(viewportSize.x);
-      myViewportHeight = static_cast<int>(viewportSize.y);
-      if (!myView.IsNull())
-      {
-        // Trigger viewport resize in OCCT
-        myView->Window()->DoResize();
-        myView->MustBeResized();
-      }
+      char aMessage[256] = {};
+      std::snprintf(aMessage,
+                    sizeof(aMessage),
+                    "First frame presented after %.0f ms; shader programs: %zu restored, "
+                    "%zu linked, %zu rejected",
+                    myStartupTimeline.firstFrameMs(),
+                    myProgramCache.nbLoaded(),
+                    myProgramCache.nbLinked(),
+                    myProgramCache.nbRejected());
+      Message::DefaultMessenger()->Send(aMessage, Message_Info);
     }
+  }
+}
+
+// ================================================================
+// Function : buildGui
+// Purpose  :
+// ================================================================
+void GlfwOcctView::buildGui()
+{
+  // Create main dockspace covering the whole window; on first use (no stored layout)
+  // put the 3D view into the central area and the panels into a column on the left
+  const ImGuiID dockspaceId = ImGui::GetID("MainDockSpace");
+  if (ImGui::DockBuilderGetNode(dockspaceId) == nullptr)
+  {
+    ImGui::DockBuilderAddNode(dockspaceId, ImGuiDockNodeFlags_DockSpace);
+    ImGui::DockBuilderSetNodeSize(dockspaceId, ImGui::GetMainViewport()->Size);
+    ImGuiID aViewNodeId  = dockspaceId;
+    ImGuiID aPanelNodeId =
+      ImGui::DockBuilderSplitNode(aViewNodeId, ImGuiDir_Left, 0.25f, nullptr, &aViewNodeId);
+    ImGui::DockBuilderDockWindow("Controls", aPanelNodeId);
+    ImGui::DockBuilderDockWindow("Settings", aPanelNodeId);
+    ImGui::DockBuilderDockWindow("Scene", aPanelNodeId);
+    ImGui::DockBuilderDockWindow("3D View", aViewNodeId);
+    ImGui::DockBuilderFinish(dockspaceId);
+  }
+  ImGui::DockSpaceOverViewport(dockspaceId, ImGui::GetMainViewport());
 
-    // Draw the OCCT viewport as an invisible item to occupy space
-    // The OCCT view renders directly to the framebuffer behind ImGui
-    ImGui::Dummy(viewportSize);
+  for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+  {
+    renderViewPanel(*aPanel);
+  }
 
-    // Display debug info
-    ImGui::SetCursorPosY(ImGui::GetWindowPos().y + 10);
-    ImGui::SetCursorPosX(ImGui::GetWindowPos().x + 10);
-    ImGui::TextColored(ImVec4(0.0f, 1.0f, 0.0f, 1.0f),
-                       "3D View: %.0f x %.0f",
-                       viewportSize.x,
-                       viewportSize.y);
+  // views of closed panels are released, the main panel cannot be closed
+  for (size_t aPanelIter = myViewPanels.size(); aPanelIter-- > 1;)
+  {
+    if (!myViewPanels[aPanelIter]->IsOpen)
+    {
+      if (myActivePanel == myViewPanels[aPanelIter].get())
+      {
+        setActiveViewPanel(myViewPanels.front().get());
+      }
+      releaseViewPanel(*myViewPanels[aPanelIter]);
+      myViewPanels.erase(myViewPanels.begin() + static_cast<std::ptrdiff_t>(aPanelIter));
+    }
   }
-  ImGui::End();
 
   // Settings/Demo Window (dockable)
-  ImGui::SetNextWindowDockID(dockspaceId, ImGuiCond_FirstUseEver);
   if (ImGui::Begin("Settings"))
   {
+    renderTessellationSettings();
+    renderCullingSettings();
+    renderQualitySettings();
+    renderPacingSettings();
+    renderMemorySettings();
+
     if (ImGui::CollapsingHeader("Rendering Stats", ImGuiTreeNodeFlags_DefaultOpen))
     {
       if (!myView.IsNull())
       {
         const Graphic3d_RenderingParams& aParams = myView->ChangeRenderingParams();
         ImGui::Text("Stats Enabled: %s", aParams.ToShowStats ? "Yes" : "No");
+        ImGui::Text("Scene redraws: %zu / GUI frames: %zu", myNbSceneFrames, myNbGuiFrames);
+        for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+        {
+          ImGui::BulletText("%s: %zu redraws%s",
+                            aPanel->Title.c_str(),
+                            aPanel->NbRedraws,
+                            aPanel->IsVisible ? "" : " (hidden)");
+        }
+        ImGui::Text("Input events: %zu received / %zu applied",
+                    myInputQueue.nbReceived(),
+                    myInputQueue.nbApplied());
+        ImGui::Text("Hover detection: %.2f ms", myHoverDuration * 1000.0);
+        ImGui::Text("First frame after %.0f ms", myStartupTimeline.firstFrameMs());
+        for (const OccImguiStartupTimeline::Phase& aPhase : myStartupTimeline.phases())
+        {
+          ImGui::BulletText("%s: %.1f ms%s",
+                            aPhase.Name.c_str(),
+                            aPhase.DurationMs,
+                            myStartupTimeline.isDeferred(aPhase) ? " (deferred)" : "");
+        }
+        if (myProgramCache.isInstalled())
+        {
+          ImGui::Text("Shader programs: %zu restored / %zu linked / %zu rejected",
+                      myProgramCache.nbLoaded(),
+                      myProgramCache.nbLinked(),
+                      myProgramCache.nbRejected());
+        }
+        else
+        {
+          ImGui::TextDisabled("Shader program cache unsupported by the driver");
+        }
       }
     }
 
+    renderProfilerSettings();
+
     ImGui::Separator();
     if (ImGui::CollapsingHeader("ImGui Demo", ImGuiTreeNodeFlags_DefaultOpen))
     {
@@ -277,7 +898,6 @@ void GlfwOcctView::renderGui()
   ImGui::End();
 
   // Control Panel (dockable)
-  ImGui::SetNextWindowDockID(dockspaceId, ImGuiCond_FirstUseEver);
   if (ImGui::Begin("Controls"))
   {
     ImGui::Text("OpenCASCADE Viewer");
@@ -300,123 +920,1803 @@ void GlfwOcctView::renderGui()
       }
     }
 
+    if (ImGui::Button("Add View...", ImVec2(-1, 0)))
+    {
+      ImGui::OpenPopup("AddViewPopup");
+    }
+    if (ImGui::BeginPopup("AddViewPopup"))
+    {
+      for (int aKind = 0; aKind < ViewKind_NB; ++aKind)
+      {
+        if (ImGui::MenuItem(viewKindName(aKind)) && !myContext.IsNull())
+        {
+          addViewPanel(static_cast<ViewKind>(aKind));
+        }
+      }
+      ImGui::EndPopup();
+    }
+
+    ImGui::Separator();
+    renderImportControls();
+
+    ImGui::Separator();
+    renderModelingControls();
+
     ImGui::Separator();
     ImGui::TextWrapped("Use mouse to interact with the 3D view:");
     ImGui::BulletText("Left click + drag: Rotate");
     ImGui::BulletText("Right click + drag: Pan");
     ImGui::BulletText("Scroll: Zoom");
+    ImGui::TextWrapped("Input goes to the view under the cursor; Reset View and Zoom Fit "
+                       "apply to the last one used.");
   }
   ImGui::End();
 
-  ImGui::Render();
+  renderScenePanel();
+}
 
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+// ================================================================
+// Function : renderViewPanel
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderViewPanel(ViewPanel& thePanel)
+{
+  // new panels open as tabs next to the main one
+  const bool isMainPanel = &thePanel == myViewPanels.front().get();
+  if (!isMainPanel && myViewDockId != 0)
+  {
+    ImGui::SetNextWindowDockID(myViewDockId, ImGuiCond_FirstUseEver);
+  }
 
-  // Handle multi-viewport rendering
-  if (const ImGuiIO& io = ImGui::GetIO(); io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
+  thePanel.IsHovered = false;
+  ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
+  const bool isVisible = ImGui::Begin(thePanel.Title.c_str(),
+                                      isMainPanel ? nullptr : &thePanel.IsOpen,
+                                      ImGuiWindowFlags_NoScrollbar);
+  ImGui::PopStyleVar();
+  if (isMainPanel)
   {
-    GLFWwindow* backup_current_context = glfwGetCurrentContext();
-    ImGui::UpdatePlatformWindows();
-    ImGui::RenderPlatformWindowsDefault();
-    glfwMakeContextCurrent(backup_current_context);
+    myViewDockId = ImGui::GetWindowDockID();
+  }
+
+  // views of hidden tabs and collapsed windows are deactivated and never redrawn;
+  // the framebuffer is resized by updateViewFramebuffer() right before the next redraw
+  const ImVec2 viewportSize = isVisible ? ImGui::GetContentRegionAvail() : ImVec2(0.0f, 0.0f);
+  setViewPanelVisible(thePanel, viewportSize.x >= 1.0f && viewportSize.y >= 1.0f);
+  if (!thePanel.IsVisible)
+  {
+    ImGui::End();
+    return;
+  }
+
+  const ImGuiIO& aIO = ImGui::GetIO();
+  thePanel.Size      = Graphic3d_Vec2i(static_cast<int>(viewportSize.x),
+                                  static_cast<int>(viewportSize.y));
+  thePanel.Scale     = Graphic3d_Vec2(aIO.DisplayFramebufferScale.x, aIO.DisplayFramebufferScale.y);
+  if (!myInputQueue.hasPendingResize()
+      && (thePanel.Fbo.IsNull()
+          || thePanel.Fbo->GetVPSize()
+               != Graphic3d_Vec2i(static_cast<int>(viewportSize.x * thePanel.Scale.x()),
+                                  static_cast<int>(viewportSize.y * thePanel.Scale.y()))))
+  {
+    // one more frame to redraw the scene into the resized framebuffer
+    myToWaitEvents = false;
+  }
+
+  // invisible button captures mouse input so that dragging in the view never moves the window
+  ImGui::InvisibleButton("##3DViewInput",
+                         viewportSize,
+                         ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight
+                           | ImGuiButtonFlags_MouseButtonMiddle);
+  thePanel.IsHovered = ImGui::IsItemHovered();
+
+  // positions are absolute in multi-viewport mode, GLFW reports them relative to the window
+  const ImVec2 aPanelMin = ImGui::GetItemRectMin();
+  const ImVec2 aPanelMax = ImGui::GetItemRectMax();
+  thePanel.Origin =
+    Graphic3d_Vec2i(static_cast<int>(aPanelMin.x - ImGui::GetMainViewport()->Pos.x),
+                    static_cast<int>(aPanelMin.y - ImGui::GetMainViewport()->Pos.y));
+
+  if (!thePanel.Fbo.IsNull() && !thePanel.Fbo->ColorTexture().IsNull())
+  {
+    // OpenGL textures are stored bottom-up
+    ImGui::GetWindowDrawList()->AddImage(
+      static_cast<ImTextureID>(thePanel.Fbo->ColorTexture()->TextureId()),
+      aPanelMin,
+      aPanelMax,
+      ImVec2(0.0f, 1.0f),
+      ImVec2(1.0f, 0.0f));
+  }
+
+  // Display debug info, highlighted for the view receiving input
+  ImGui::SetCursorScreenPos(ImVec2(aPanelMin.x + 10, aPanelMin.y + 10));
+  ImGui::TextColored(myActivePanel == &thePanel ? ImVec4(0.0f, 1.0f, 0.0f, 1.0f)
+                                                : ImVec4(0.6f, 0.6f, 0.6f, 1.0f),
+                     "%s: %.0f x %.0f",
+                     viewKindName(thePanel.Kind),
+                     viewportSize.x,
+                     viewportSize.y);
+  ImGui::End();
+}
+
+// ================================================================
+// Function : updateViewFramebuffer
+// Purpose  :
+// ================================================================
+void GlfwOcctView::updateViewFramebuffer(ViewPanel& thePanel)
+{
+  // while the window is being resized the last image is stretched over the panel,
+  // the framebuffer is reallocated once for the final size
+  const Handle(OpenGl_Context) aGlCtx = glContext();
+  if (aGlCtx.IsNull() || !thePanel.IsVisible || thePanel.Size.x() <= 0 || thePanel.Size.y() <= 0
+      || myInputQueue.hasPendingResize())
+  {
+    return;
+  }
+
+  const Graphic3d_Vec2i aSize(
+    static_cast<int>(static_cast<float>(thePanel.Size.x()) * thePanel.Scale.x()),
+    static_cast<int>(static_cast<float>(thePanel.Size.y()) * thePanel.Scale.y()));
+  if (!thePanel.Fbo.IsNull() && thePanel.Fbo->GetVPSize() == aSize)
+  {
+    return;
+  }
+
+  if (thePanel.Fbo.IsNull())
+  {
+    thePanel.Fbo = new OpenGl_FrameBuffer();
+    thePanel.View->View()->SetFBO(thePanel.Fbo);
+  }
+
+  if (!thePanel.Fbo->InitLazy(aGlCtx, aSize, GL_RGBA8, GL_DEPTH24_STENCIL8))
+  {
+    Message::DefaultMessenger()->Send("Error: unable to allocate offscreen framebuffer",
+                                      Message_Fail);
+    thePanel.View->View()->SetFBO(Handle(Standard_Transient)());
+    thePanel.Fbo.Nullify();
+    return;
+  }
+
+  thePanel.Window->SetSize(aSize.x(), aSize.y());
+  thePanel.View->MustBeResized();
+  thePanel.View->Invalidate();
+}
+
+// ================================================================
+// Function : toViewPosition
+// Purpose  :
+// ================================================================
+Graphic3d_Vec2i GlfwOcctView::toViewPosition(const Graphic3d_Vec2i& theWindowPos) const
+{
+  if (myActivePanel == nullptr)
+  {
+    return theWindowPos;
+  }
+
+  const Graphic3d_Vec2 aPos =
+    Graphic3d_Vec2(theWindowPos - myActivePanel->Origin) * myActivePanel->Scale;
+  return Graphic3d_Vec2i(static_cast<int>(aPos.x()), static_cast<int>(aPos.y()));
+}
+
+// ================================================================
+// Function : renderImportControls
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderImportControls()
+{
+  const bool isImporting = myImporter.isRunning();
+  ImGui::SetNextItemWidth(-1);
+  ImGui::InputTextWithHint("##ImportPath",
+                           "STEP, IGES, BREP, STL, OBJ or glTF file",
+                           myImportPath.data(),
+                           myImportPath.size());
+
+  ImGui::BeginDisabled(isImporting || myImportPath[0] == '\0');
+  if (ImGui::Button("Open", ImVec2(-1, 0)))
+  {
+    openFile(myImportPath.data());
+  }
+  ImGui::EndDisabled();
+
+  switch (myImporter.state())
+  {
+    case OccImguiImporter::State_Running: {
+      const TCollection_AsciiString aStep = myImporter.stepName();
+      ImGui::ProgressBar(static_cast<float>(myImporter.progress()),
+                         ImVec2(-1, 0),
+                         aStep.IsEmpty() ? nullptr : aStep.ToCString());
+      if (ImGui::Button("Cancel", ImVec2(-1, 0)))
+      {
+        myImporter.cancel();
+      }
+      break;
+    }
+    case OccImguiImporter::State_Finished:
+      ImGui::Text("Imported %zu objects", myNbImportedObjects);
+      if (myImporter.nbInstances() != 0)
+      {
+        ImGui::Text("%zu instances of %zu shared parts",
+                    myImporter.nbInstances(),
+                    myImporter.nbPrototypes());
+      }
+      break;
+    case OccImguiImporter::State_Cancelled:
+      ImGui::Text("Import cancelled");
+      break;
+    case OccImguiImporter::State_Failed:
+      ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f),
+                         "%s",
+                         myImporter.errorMessage().ToCString());
+      break;
+    case OccImguiImporter::State_Idle:
+      break;
+  }
+}
+
+// ================================================================
+// Function : displayImportedObjects
+// Purpose  :
+// ================================================================
+void GlfwOcctView::displayImportedObjects()
+{
+  if (myContext.IsNull() || !myImporter.hasPendingObjects())
+  {
+    return;
+  }
+
+  // hand objects over to the context in batches until the frame budget is spent,
+  // the rest waits for the next frame; placeholder boxes of all parts come first
+  // and are replaced chunk by chunk, largest parts first
+  const auto aStart = std::chrono::steady_clock::now();
+
+  std::vector<OccImguiImporter::ImportedObject> aBatch;
+  while (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - aStart)
+             .count()
+           < THE_IMPORT_FRAME_BUDGET_MS
+         && myImporter.fetch(aBatch, THE_IMPORT_BATCH_SIZE) != 0)
+  {
+    for (const OccImguiImporter::ImportedObject& anObject : aBatch)
+    {
+      if (Handle(OccImguiBoxPlaceholder)::DownCast(anObject.Object))
+      {
+        // placeholders are not selectable
+        myContext->Display(anObject.Object, 0, -1, false);
+      }
+      else if (!anObject.Object.IsNull())
+      {
+        myContext->Display(anObject.Object, AIS_Shaded, 0, false);
+        addSceneObject(anObject.Object);
+        ++myNbImportedObjects;
+      }
+      if (!anObject.Placeholder.IsNull())
+      {
+        myContext->Remove(anObject.Placeholder, false);
+      }
+    }
+    aBatch.clear();
+  }
+  mySceneLod.invalidate();
+
+  // parts arrive with the coarse level only, finer ones are requested as the view calls for them
+  myToUpdateMeshLevels = true;
+
+  if (!myIsImportFitted)
+  {
+    myView->FitAll(0.01, false);
+    myIsImportFitted = true;
+  }
+  invalidateViews();
+}
+
+// ================================================================
+// Function : renderModelingControls
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderModelingControls()
+{
+  if (ImGui::BeginCombo("Operation", OccImguiModeling::operationName(myModelingOperation)))
+  {
+    for (int anOp = 0; anOp < OccImguiModeling::Operation_NB; ++anOp)
+    {
+      if (ImGui::Selectable(OccImguiModeling::operationName(anOp), anOp == myModelingOperation))
+      {
+        myModelingOperation = anOp;
+      }
+    }
+    ImGui::EndCombo();
+  }
+
+  const bool isBoolean = OccImguiModeling::isBoolean(myModelingOperation);
+  if (!isBoolean)
+  {
+    ImGui::InputDouble(myModelingOperation == OccImguiModeling::Operation_Fillet ? "Radius"
+                                                                                 : "Distance",
+                       &myModelingValue,
+                       0.5,
+                       5.0,
+                       "%.2f");
+  }
+
+  // the first selected shape is the object of Booleans, the others are tools;
+  // fillets and offsets start one task per selected shape
+  std::vector<Handle(AIS_Shape)> aSelected;
+  if (!myContext.IsNull())
+  {
+    for (myContext->InitSelected(); myContext->MoreSelected(); myContext->NextSelected())
+    {
+      if (Handle(AIS_Shape) aShape = Handle(AIS_Shape)::DownCast(myContext->SelectedInteractive());
+          !aShape.IsNull() && !myModeling.isBusy(aShape))
+      {
+        aSelected.push_back(aShape);
+      }
+    }
+  }
+
+  const size_t aNbRequired = isBoolean ? 2 : 1;
+  ImGui::BeginDisabled(aSelected.size() < aNbRequired);
+  if (ImGui::Button("Apply to Selection", ImVec2(-1, 0)))
+  {
+    const OccImguiModeling::Operation anOp =
+      static_cast<OccImguiModeling::Operation>(myModelingOperation);
+    if (isBoolean)
+    {
+      myModeling.start(anOp,
+                       aSelected.front(),
+                       std::vector<Handle(AIS_Shape)>(aSelected.begin() + 1, aSelected.end()),
+                       0.0);
+    }
+    else
+    {
+      for (const Handle(AIS_Shape)& aShape : aSelected)
+      {
+        myModeling.start(anOp, aShape, {}, myModelingValue);
+      }
+    }
+  }
+  ImGui::EndDisabled();
+  if (aSelected.size() < aNbRequired)
+  {
+    ImGui::TextDisabled(isBoolean ? "Select the object, then the tools" : "Select shapes");
+  }
+
+  const double aNow =
+    std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  for (const std::unique_ptr<OccImguiModeling::Task>& aTask : myModeling.tasks())
+  {
+    ImGui::PushID(aTask.get());
+    const TCollection_AsciiString aStep = aTask->Progress->stepName();
+    ImGui::Text("%s, %.1f s",
+                OccImguiModeling::operationName(aTask->Op),
+                aNow - aTask->StartTime);
+    ImGui::ProgressBar(static_cast<float>(aTask->Progress->GetPosition()),
+                       ImVec2(-1, 0),
+                       aStep.IsEmpty() ? nullptr : aStep.ToCString());
+    if (ImGui::Button("Cancel", ImVec2(-1, 0)))
+    {
+      aTask->Progress->requestCancel();
+    }
+    ImGui::PopID();
+  }
+  if (!myModelingMessage.IsEmpty())
+  {
+    ImGui::TextWrapped("%s", myModelingMessage.ToCString());
+  }
+}
+
+// ================================================================
+// Function : applyModelingResults
+// Purpose  :
+// ================================================================
+void GlfwOcctView::applyModelingResults()
+{
+  std::vector<std::unique_ptr<OccImguiModeling::Task>> aTasks;
+  if (myContext.IsNull() || myModeling.fetch(aTasks) == 0)
+  {
+    return;
+  }
+
+  char aMessage[256] = {};
+  for (const std::unique_ptr<OccImguiModeling::Task>& aTask : aTasks)
+  {
+    const char* anOpName = OccImguiModeling::operationName(aTask->Op);
+    switch (aTask->State)
+    {
+      case OccImguiModeling::Status_Finished: {
+        // the medium level has been meshed by the task, so the target changes within this frame;
+        // the level matching the zoom follows with the next level update, tools are consumed;
+        // levels of the replaced shape and of the tools are no longer reachable
+        const TopoDS_Shape aReplacedShape = aTask->Target->Shape();
+        aTask->Target->SetShape(aTask->Result);
+        applyMeshLevel(aTask->Target, OccImguiMeshLodCache::Level_Medium);
+        if (aReplacedShape.TShape() != aTask->Result.TShape())
+        {
+          myMeshCache.erase(aReplacedShape);
+        }
+        myToUpdateMeshLevels = true;
+        if (const auto anId = mySceneObjectIds.find(aTask->Target.get());
+            anId != mySceneObjectIds.end())
+        {
+          mySceneIndex.invalidate(anId->second);
+        }
+        for (const Handle(AIS_Shape)& aTool : aTask->Tools)
+        {
+          myContext->Remove(aTool, false);
+          removeSceneObject(aTool);
+        }
+        std::snprintf(aMessage, sizeof(aMessage), "%s done in %.1f s", anOpName, aTask->Duration);
+        break;
+      }
+      case OccImguiModeling::Status_Cancelled:
+        std::snprintf(aMessage, sizeof(aMessage), "%s cancelled", anOpName);
+        break;
+      case OccImguiModeling::Status_Failed:
+        std::snprintf(aMessage, sizeof(aMessage), "%s", aTask->Error.ToCString());
+        break;
+      case OccImguiModeling::Status_Running:
+        break;
+    }
+  }
+  myModelingMessage = aMessage;
+  mySceneLod.invalidate();
+  invalidateViews();
+}
+
+// ================================================================
+// Function : renderScenePanel
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderScenePanel()
+{
+  myIsScenePanelVisible = ImGui::Begin("Scene");
+  if (!myIsScenePanelVisible || myContext.IsNull())
+  {
+    ImGui::End();
+    return;
+  }
+
+  ImGui::SetNextItemWidth(-1.0f);
+  ImGui::InputTextWithHint("##SceneFilter",
+                           "Filter by name or type",
+                           mySceneFilter.data(),
+                           mySceneFilter.size());
+  mySceneIndex.setFilter(mySceneFilter.data());
+
+  // objects are matched and indexed within the frame budget, further matches show up
+  // over the next frames
+  const auto aStart     = std::chrono::steady_clock::now();
+  bool       isComplete = false;
+  do
+  {
+    isComplete = mySceneIndex.update(THE_SCENE_INDEX_BATCH_SIZE);
+  } while (!isComplete
+           && std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - aStart)
+                  .count()
+                < THE_SCENE_INDEX_FRAME_BUDGET_MS);
+
+  const std::vector<size_t>& aRows = mySceneIndex.rows();
+  ImGui::TextDisabled("%zu of %zu objects%s",
+                      aRows.size(),
+                      mySceneIndex.nbObjects(),
+                      mySceneIndex.isFiltering() ? ", filtering..." : "");
+
+  // follow selection changes made in the 3D view by scrolling to the first selected object
+  int aScrollRow = -1;
+  if (const AIS_InteractiveObject* aSelected = firstSelectedSceneObject(myContext);
+      aSelected != mySceneSelection)
+  {
+    mySceneSelection = aSelected;
+    if (const auto anId = mySceneObjectIds.find(aSelected); anId != mySceneObjectIds.end())
+    {
+      if (const auto aRow = std::lower_bound(aRows.begin(), aRows.end(), anId->second);
+          aRow != aRows.end() && *aRow == anId->second)
+      {
+        aScrollRow = static_cast<int>(aRow - aRows.begin());
+      }
+    }
+  }
+
+  Handle(AIS_InteractiveObject) aClicked;
+  bool                          isFitClicked = false;
+  if (ImGui::BeginTable("SceneTable",
+                        3,
+                        ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg
+                          | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable))
+  {
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Name");
+    ImGui::TableSetupColumn("Type");
+    ImGui::TableSetupColumn("State", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableHeadersRow();
+
+    // only visible rows are submitted, names and types are fetched when first shown
+    ImGuiListClipper aClipper;
+    aClipper.Begin(static_cast<int>(aRows.size()));
+    if (aScrollRow >= 0)
+    {
+      aClipper.IncludeItemByIndex(aScrollRow);
+    }
+    while (aClipper.Step())
+    {
+      for (int aRow = aClipper.DisplayStart; aRow < aClipper.DisplayEnd; ++aRow)
+      {
+        const size_t                         anId     = aRows[static_cast<size_t>(aRow)];
+        const Handle(AIS_InteractiveObject)& anObject = mySceneObjects[anId];
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::PushID(static_cast<int>(anId));
+        if (ImGui::Selectable(mySceneIndex.name(anId).c_str(),
+                              myContext->IsSelected(anObject),
+                              ImGuiSelectableFlags_SpanAllColumns
+                                | ImGuiSelectableFlags_AllowDoubleClick))
+        {
+          aClicked     = anObject;
+          isFitClicked = ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left);
+        }
+        ImGui::PopID();
+        if (aRow == aScrollRow)
+        {
+          ImGui::SetScrollHereY(0.5f);
+        }
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(mySceneIndex.attributes(anId).c_str());
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(myContext->IsDisplayed(anObject) ? "shown" : "hidden");
+      }
+    }
+    ImGui::EndTable();
+  }
+  ImGui::End();
+
+  // a click replaces the selection, Ctrl+click toggles the object, double click zooms to it
+  if (!aClicked.IsNull() && myContext->IsDisplayed(aClicked))
+  {
+    if (!ImGui::GetIO().KeyCtrl)
+    {
+      myContext->ClearSelected(false);
+    }
+    myContext->AddOrRemoveSelected(aClicked, false);
+    if (isFitClicked && !myView.IsNull())
+    {
+      myContext->FitSelected(myView, 0.01, false);
+    }
+    mySceneSelection = firstSelectedSceneObject(myContext);
+    invalidateViews();
+  }
+}
+
+// ================================================================
+// Function : addSceneObject
+// Purpose  :
+// ================================================================
+void GlfwOcctView::addSceneObject(const Handle(AIS_InteractiveObject)& theObject)
+{
+  mySceneObjectIds[theObject.get()] = mySceneIndex.add();
+  mySceneObjects.push_back(theObject);
+}
+
+// ================================================================
+// Function : removeSceneObject
+// Purpose  :
+// ================================================================
+void GlfwOcctView::removeSceneObject(const Handle(AIS_InteractiveObject)& theObject)
+{
+  const auto anId = mySceneObjectIds.find(theObject.get());
+  if (anId == mySceneObjectIds.end())
+  {
+    return;
+  }
+
+  mySceneIndex.remove(anId->second);
+  mySceneObjects[anId->second].Nullify();
+  mySceneObjectIds.erase(anId);
+
+  // prototypes of connected instances stay shared by the remaining instances
+  if (const Handle(AIS_Shape) aShape = Handle(AIS_Shape)::DownCast(theObject); !aShape.IsNull())
+  {
+    myMeshCache.erase(aShape->Shape());
+  }
+}
+
+// ================================================================
+// Function : sceneObjectText
+// Purpose  :
+// ================================================================
+void GlfwOcctView::sceneObjectText(const size_t theId,
+                                   std::string& theName,
+                                   std::string& theAttributes) const
+{
+  // imported parts carry no names, objects are named by their kind and listing order
+  const Handle(AIS_InteractiveObject)& anObject = mySceneObjects[theId];
+  const std::string                    aNumber  = std::to_string(theId + 1);
+  Handle(AIS_Shape)                    aShape   = Handle(AIS_Shape)::DownCast(anObject);
+
+  const Handle(AIS_ConnectedInteractive) anInstance =
+    Handle(AIS_ConnectedInteractive)::DownCast(anObject);
+  if (!anInstance.IsNull())
+  {
+    theName = "Instance " + aNumber;
+    aShape  = Handle(AIS_Shape)::DownCast(anInstance->ConnectedTo());
+  }
+  else if (!aShape.IsNull())
+  {
+    theName = "Shape " + aNumber;
+  }
+  else
+  {
+    theName = std::string(anObject->DynamicType()->Name()) + " " + aNumber;
+  }
+
+  if (!aShape.IsNull())
+  {
+    theAttributes = aShape->Shape().IsNull()
+                      ? "EMPTY"
+                      : TopAbs::ShapeTypeToString(aShape->Shape().ShapeType());
+  }
+  if (!anInstance.IsNull())
+  {
+    theAttributes += theAttributes.empty() ? "instance" : ", instance";
+  }
+}
+
+// ================================================================
+// Function : renderTessellationSettings
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderTessellationSettings()
+{
+  if (!ImGui::CollapsingHeader("Tessellation", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    return;
+  }
+
+  if (ImGui::Checkbox("Select level by zoom", &myIsAutoMeshLevel))
+  {
+    myToUpdateMeshLevels = true;
+  }
+
+  ImGui::BeginDisabled(myIsAutoMeshLevel);
+  if (ImGui::BeginCombo("Quality", OccImguiMeshLodCache::levelName(myMeshLevel)))
+  {
+    for (int aLevel = 0; aLevel < OccImguiMeshLodCache::Level_NB; ++aLevel)
+    {
+      if (ImGui::Selectable(OccImguiMeshLodCache::levelName(aLevel), aLevel == myMeshLevel))
+      {
+        myMeshLevel          = aLevel;
+        myToUpdateMeshLevels = true;
+      }
+    }
+    ImGui::EndCombo();
+  }
+  ImGui::EndDisabled();
+
+  ImGui::Text("Disk cache: %.1f / %.0f MB, %llu hits, %llu misses",
+              double(myMeshDiskCache.size()) / (1024.0 * 1024.0),
+              double(myMeshDiskCache.sizeLimit()) / (1024.0 * 1024.0),
+              static_cast<unsigned long long>(myMeshDiskCache.nbHits()),
+              static_cast<unsigned long long>(myMeshDiskCache.nbMisses()));
+  if (ImGui::Button("Clear disk cache"))
+  {
+    myMeshDiskCache.clear();
+  }
+}
+
+// ================================================================
+// Function : renderCullingSettings
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderCullingSettings()
+{
+  if (!ImGui::CollapsingHeader("Culling", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    return;
+  }
+
+  bool isProxyEnabled = mySceneLod.isEnabled();
+  if (ImGui::Checkbox("Bounding box proxies", &isProxyEnabled))
+  {
+    mySceneLod.setEnabled(isProxyEnabled);
+  }
+
+  ImGui::BeginDisabled(!isProxyEnabled);
+  float aProxySize = mySceneLod.proxySize();
+  if (ImGui::SliderFloat("Proxy size, px", &aProxySize, 1.0f, 64.0f, "%.0f"))
+  {
+    mySceneLod.setProxySize(aProxySize);
+  }
+  ImGui::EndDisabled();
+
+  float aCullingSize = mySceneLod.cullingSize();
+  if (ImGui::SliderFloat("Culling size, px", &aCullingSize, 0.0f, 16.0f, "%.0f"))
+  {
+    mySceneLod.setCullingSize(aCullingSize);
+    for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+    {
+      mySceneLod.setupView(aPanel->View);
+    }
+    invalidateViews();
+  }
+  ImGui::Text("Bounding box proxies: %zu", mySceneLod.nbProxies());
+}
+
+// ================================================================
+// Function : renderQualitySettings
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderQualitySettings()
+{
+  if (!ImGui::CollapsingHeader("Quality", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    return;
+  }
+
+  static const int   THE_MSAA_SAMPLES[] = {0, 2, 4, 8};
+  static const char* THE_MSAA_NAMES[]   = {"Off", "2x", "4x", "8x"};
+  int                aMsaaIndex         = 0;
+  for (int anIndex = 0; anIndex < IM_ARRAYSIZE(THE_MSAA_SAMPLES); ++anIndex)
+  {
+    if (THE_MSAA_SAMPLES[anIndex] == myAdaptiveResolution.msaaSamples())
+    {
+      aMsaaIndex = anIndex;
+    }
+  }
+  if (ImGui::Combo("MSAA", &aMsaaIndex, THE_MSAA_NAMES, IM_ARRAYSIZE(THE_MSAA_NAMES)))
+  {
+    myAdaptiveResolution.setMsaaSamples(THE_MSAA_SAMPLES[aMsaaIndex]);
+    for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+    {
+      myAdaptiveResolution.setupView(aPanel->View);
+    }
+    invalidateViews();
+  }
+
+  // replays keep the full resolution, which otherwise depends on the speed of the machine
+  bool isAdaptive = myAdaptiveResolution.isEnabled();
+  ImGui::BeginDisabled(myFrameClock >= 0.0);
+  if (ImGui::Checkbox("Adaptive resolution", &isAdaptive))
+  {
+    myAdaptiveResolution.setEnabled(isAdaptive);
+  }
+  ImGui::EndDisabled();
+  ImGui::SetItemTooltip("Render at reduced resolution without MSAA while the camera moves");
+
+  ImGui::BeginDisabled(!isAdaptive);
+  float aTargetTime = static_cast<float>(myAdaptiveResolution.targetFrameTime() * 1000.0);
+  if (ImGui::SliderFloat("Target frame time, ms", &aTargetTime, 5.0f, 100.0f, "%.1f"))
+  {
+    myAdaptiveResolution.setTargetFrameTime(aTargetTime / 1000.0);
+  }
+  float aMinScale = myAdaptiveResolution.minScale();
+  if (ImGui::SliderFloat("Min resolution scale", &aMinScale, 0.25f, 1.0f, "%.2f"))
+  {
+    myAdaptiveResolution.setMinScale(aMinScale);
+  }
+  ImGui::EndDisabled();
+  ImGui::Text("Interactive scale: %.2f%s",
+              myAdaptiveResolution.scale(),
+              myAdaptiveResolution.isDegraded() ? " (active)" : "");
+}
+
+// ================================================================
+// Function : renderPacingSettings
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderPacingSettings()
+{
+  if (!ImGui::CollapsingHeader("Frame Pacing", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    return;
+  }
+
+  float aTargetRate = static_cast<float>(myFramePacer.targetRate());
+  if (ImGui::SliderFloat("Frame rate limit",
+                         &aTargetRate,
+                         0.0f,
+                         240.0f,
+                         aTargetRate > 0.0f ? "%.0f fps" : "unlimited"))
+  {
+    myFramePacer.setTargetRate(aTargetRate);
+  }
+  float anIdleRate = static_cast<float>(myFramePacer.idleRate());
+  if (ImGui::SliderFloat("Idle frame rate", &anIdleRate, 0.5f, 30.0f, "%.1f fps"))
+  {
+    myFramePacer.setIdleRate(anIdleRate);
+  }
+  ImGui::SetItemTooltip("Limit of continuous rendering (animations, imports, progress) after "
+                        "%.0f s without input",
+                        myFramePacer.idleDelay());
+
+  bool isAdaptiveSwap = myFramePacer.isAdaptiveSwap();
+  if (ImGui::Checkbox("Adaptive vsync", &isAdaptiveSwap))
+  {
+    myFramePacer.setAdaptiveSwap(isAdaptiveSwap);
+  }
+  ImGui::SetItemTooltip("Swap frames missing the display refresh without waiting for the next one");
+
+  ImGui::Text("%.1f fps, %.2f ms per frame, swap interval %d%s",
+              myFramePacer.frameRate(),
+              myFramePacer.frameWork() * 1000.0,
+              myFramePacer.swapInterval(),
+              myFramePacer.isIdle(glfwGetTime()) ? " (idle)" : "");
+  ImGui::Text("Input to present: p50 %.1f, p90 %.1f, p99 %.1f ms",
+              myFramePacer.latencyPercentile(50.0),
+              myFramePacer.latencyPercentile(90.0),
+              myFramePacer.latencyPercentile(99.0));
+  ImGui::SetItemTooltip("From the oldest input event of a frame to the return of its buffer swap, "
+                        "over the latest %zu frames with input",
+                        myFramePacer.nbLatencies());
+  if (ImGui::Button("Reset latencies"))
+  {
+    myFramePacer.resetLatencies();
+  }
+}
+
+// ================================================================
+// Function : renderMemorySettings
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderMemorySettings()
+{
+  if (!ImGui::CollapsingHeader("Memory"))
+  {
+    return;
+  }
+
+  const OccImguiMemoryBudget::Stats& aStats = myMemoryBudget.stats();
+  if (aStats.HeapBytes != size_t(-1))
+  {
+    ImGui::Text("Process heap: %.1f MB", toMegabytes(aStats.HeapBytes));
+  }
+  if (aStats.WorkingSetBytes != size_t(-1))
+  {
+    ImGui::Text("Working set: %.1f MB", toMegabytes(aStats.WorkingSetBytes));
+  }
+  ImGui::Text("Shape buffers: %.1f MB, triangulations: %.1f MB",
+              toMegabytes(aStats.GpuBytes),
+              toMegabytes(aStats.MeshBytes));
+  if (aStats.GpuFreeBytes != 0)
+  {
+    ImGui::Text("Free video memory: %.1f MB", toMegabytes(aStats.GpuFreeBytes));
+  }
+  if (!myMemoryBudget.gpuInfo().IsEmpty() && ImGui::TreeNode("OpenGL memory info"))
+  {
+    ImGui::TextUnformatted(myMemoryBudget.gpuInfo().ToCString());
+    ImGui::TreePop();
+  }
+
+  bool isEnabled = myMemoryBudget.isEnabled();
+  if (ImGui::Checkbox("Memory budget", &isEnabled))
+  {
+    myMemoryBudget.setEnabled(isEnabled);
+  }
+  ImGui::SetItemTooltip("Drop buffers and detailed tessellation of hidden or off-screen shapes "
+                        "while over the budget");
+
+  ImGui::BeginDisabled(!isEnabled);
+  int aBudgetMb = static_cast<int>(myMemoryBudget.budget() >> 20);
+  if (ImGui::SliderInt("Budget, MB", &aBudgetMb, 64, 16384, "%d", ImGuiSliderFlags_Logarithmic))
+  {
+    myMemoryBudget.setBudget(static_cast<size_t>(aBudgetMb) << 20);
+  }
+  ImGui::EndDisabled();
+  ImGui::Text("Evicted shapes: %zu (%zu evictions)", aStats.NbEvicted, aStats.NbEvictions);
+
+  const std::vector<OccImguiMemoryBudget::ShapeMemory>& aShapes = myMemoryBudget.shapes();
+  if (aShapes.empty()
+      || !ImGui::BeginTable("##ShapeMemory",
+                            4,
+                            ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg
+                              | ImGuiTableFlags_SizingStretchProp))
+  {
+    return;
+  }
+
+  ImGui::TableSetupColumn("Shape");
+  ImGui::TableSetupColumn("GPU, MB");
+  ImGui::TableSetupColumn("Mesh, MB");
+  ImGui::TableSetupColumn("State");
+  ImGui::TableHeadersRow();
+  const size_t aNbRows = std::min(aShapes.size(), THE_MEMORY_TABLE_ROWS);
+  for (size_t aShapeIter = 0; aShapeIter < aNbRows; ++aShapeIter)
+  {
+    const OccImguiMemoryBudget::ShapeMemory& aShape = aShapes[aShapeIter];
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::Text("%s #%zu",
+                TopAbs::ShapeTypeToString(aShape.Shape->Shape().ShapeType()),
+                aShapeIter + 1);
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", toMegabytes(aShape.GpuBytes));
+    ImGui::TableNextColumn();
+    ImGui::Text("%.2f", toMegabytes(aShape.MeshBytes));
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(aShape.IsEvicted   ? "evicted"
+                           : aShape.IsHidden  ? "hidden"
+                           : aShape.IsVisible ? "visible"
+                                              : "off-screen");
+  }
+  ImGui::EndTable();
+}
+
+// ================================================================
+// Function : renderProfilerSettings
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderProfilerSettings()
+{
+  if (!ImGui::CollapsingHeader("Profiler"))
+  {
+    return;
+  }
+
+  bool isEnabled = myProfiler.isEnabled();
+  if (ImGui::Checkbox("Record", &isEnabled))
+  {
+    myProfiler.setEnabled(isEnabled);
+  }
+  ImGui::SameLine();
+  ImGui::TextDisabled(myProfiler.hasGpuTimer() ? "(GPU timer queries)" : "(no GPU timer)");
+
+  // per-stage milliseconds of the latest complete frames (the current one is still running);
+  // GPU results arrive a few frames late, so their graphs end slightly earlier
+  const size_t aNbGraphs = OccImguiProfiler::Stage_NB * 2;
+  myProfilerGraphs.assign(aNbGraphs * THE_PROFILER_GRAPH_FRAMES, 0.0f);
+  myProfilerSamples.clear();
+  myProfiler.snapshot(myProfilerSamples, THE_PROFILER_GRAPH_FRAMES * aNbGraphs);
+  const uint64_t aLastFrame = myProfiler.frameIndex() - 1;
+  for (const OccImguiProfiler::Sample& aSample : myProfilerSamples)
+  {
+    if (aSample.Frame > aLastFrame || aLastFrame - aSample.Frame >= THE_PROFILER_GRAPH_FRAMES)
+    {
+      continue;
+    }
+
+    const size_t aGraph = static_cast<size_t>(aSample.StageId) * 2 + (aSample.IsGpu ? 1 : 0);
+    const size_t aFrame =
+      THE_PROFILER_GRAPH_FRAMES - 1 - static_cast<size_t>(aLastFrame - aSample.Frame);
+    myProfilerGraphs[aGraph * THE_PROFILER_GRAPH_FRAMES + aFrame] +=
+      static_cast<float>(aSample.DurationUs / 1000.0);
+  }
+
+  for (int aStage = 0; aStage < OccImguiProfiler::Stage_NB; ++aStage)
+  {
+    ImGui::PushID(aStage);
+    ImGui::TextUnformatted(OccImguiProfiler::stageName(aStage));
+    for (int aGpu = 0; aGpu < (OccImguiProfiler::isGpuStage(aStage) ? 2 : 1); ++aGpu)
+    {
+      const size_t aGraph  = static_cast<size_t>(aStage * 2 + aGpu);
+      const float* aValues = myProfilerGraphs.data() + aGraph * THE_PROFILER_GRAPH_FRAMES;
+      char anOverlay[64];
+      std::snprintf(anOverlay,
+                    sizeof(anOverlay),
+                    "%s %.2f ms",
+                    aGpu == 0 ? "CPU" : "GPU",
+                    aValues[THE_PROFILER_GRAPH_FRAMES - 1]);
+      ImGui::PushID(aGpu);
+      ImGui::PlotLines("##Graph",
+                       aValues,
+                       static_cast<int>(THE_PROFILER_GRAPH_FRAMES),
+                       0,
+                       anOverlay,
+                       0.0f,
+                       FLT_MAX,
+                       ImVec2(-1.0f, 40.0f));
+      ImGui::PopID();
+    }
+    ImGui::PopID();
+  }
+
+  ImGui::SetNextItemWidth(-1);
+  ImGui::InputText("##TracePath", myTracePath.data(), myTracePath.size());
+  if (ImGui::Button("Export Chrome trace", ImVec2(-1, 0)))
+  {
+    std::ofstream aStream(myTracePath.data(), std::ios::out | std::ios::trunc);
+    myProfiler.exportChromeTrace(aStream);
+    myTraceStatus = aStream.good()
+                      ? TCollection_AsciiString("Saved ") + myTracePath.data()
+                      : TCollection_AsciiString("Unable to write ") + myTracePath.data();
+  }
+  if (!myTraceStatus.IsEmpty())
+  {
+    ImGui::TextWrapped("%s", myTraceStatus.ToCString());
+  }
+}
+
+// ================================================================
+// Function : desiredMeshLevel
+// Purpose  :
+// ================================================================
+int GlfwOcctView::desiredMeshLevel(const TopoDS_Shape& theShape, const double thePixelSize)
+{
+  if (!myIsAutoMeshLevel)
+  {
+    return myMeshLevel;
+  }
+
+  // coarsest level whose chordal error stays below a pixel on screen
+  for (int aLevel = OccImguiMeshLodCache::Level_Coarse; aLevel < OccImguiMeshLodCache::Level_Fine;
+       ++aLevel)
+  {
+    if (myMeshCache.deflection(theShape, aLevel) <= thePixelSize * THE_MESH_LEVEL_PIXEL_ERROR)
+    {
+      return aLevel;
+    }
+  }
+  return OccImguiMeshLodCache::Level_Fine;
+}
+
+// ================================================================
+// Function : applyMeshLevel
+// Purpose  :
+// ================================================================
+bool GlfwOcctView::applyMeshLevel(const Handle(AIS_Shape)& theShape, const int theLevel)
+{
+  // imported meshes have a single triangulation, displayed at any level
+  if (!myMeshCache.isMeshOnly(theShape->Shape())
+      && myMeshCache.activeLevel(theShape->Shape()) != theLevel
+      && !myMeshCache.activate(theShape->Shape(), theLevel))
+  {
+    if (myFrameClock < 0.0)
+    {
+      myMeshCache.requestAsync(theShape->Shape(), theLevel, theShape);
+      return false;
+    }
+
+    // replays mesh on the spot, so that levels are swapped on the same frames on every run
+    myMeshCache.mesh({theShape->Shape()}, theLevel);
+    if (!myMeshCache.activate(theShape->Shape(), theLevel))
+    {
+      return false;
+    }
+  }
+
+  // the cache owns the triangulation from now on, AIS_Shape should never re-mesh on its own;
+  // prototypes of connected instances are not displayed but still own computed presentations
+  theShape->Attributes()->SetAutoTriangulation(Standard_False);
+  if (myContext->IsDisplayed(theShape) || !theShape->Presentations().IsEmpty())
+  {
+    myContext->Redisplay(theShape, false);
+  }
+  return true;
+}
+
+// ================================================================
+// Function : updateMeshLevels
+// Purpose  :
+// ================================================================
+void GlfwOcctView::updateMeshLevels(const double theTime)
+{
+  if (myContext.IsNull())
+  {
+    return;
+  }
+
+  // levels meshed in background since the last frame; instances of the same part share
+  // the triangulation, so all of them have to be redisplayed once a level is attached
+  std::vector<OccImguiMeshLodCache::ReadyLevel> aReadyLevels;
+  std::unordered_set<const TopoDS_TShape*>      aSwappedShapes;
+  myMeshCache.takeReady(aReadyLevels);
+  const double aPixelSize = finestPixelSize();
+  for (const OccImguiMeshLodCache::ReadyLevel& aReady : aReadyLevels)
+  {
+    // shapes erased from the cache meanwhile have no level to attach
+    if (myMeshCache.hasLevel(aReady.Shape, aReady.Level)
+        && desiredMeshLevel(aReady.Shape, aPixelSize) == aReady.Level
+        && myMeshCache.activate(aReady.Shape, aReady.Level))
+    {
+      aSwappedShapes.insert(aReady.Shape.TShape().get());
+    }
+  }
+
+  // re-evaluate levels after quality changes or, in automatic mode, after zooming any view
+  const bool isCameraChanged = myIsAutoMeshLevel && aPixelSize != myMeshLevelPixelSize
+                               && theTime - myMeshLevelUpdateTime >= THE_MESH_LEVEL_UPDATE_INTERVAL;
+  if (!myToUpdateMeshLevels && !isCameraChanged && aSwappedShapes.empty())
+  {
+    return;
+  }
+
+  myToUpdateMeshLevels  = false;
+  myMeshLevelPixelSize  = aPixelSize;
+  myMeshLevelUpdateTime = theTime;
+
+  // connected instances are updated through their shared prototype, visited only once
+  bool                                 isChanged = false;
+  AIS_ListOfInteractive                aDisplayed;
+  std::unordered_set<const AIS_Shape*> aVisitedPrototypes;
+  myContext->DisplayedObjects(aDisplayed);
+  for (AIS_ListOfInteractive::Iterator anObjIter(aDisplayed); anObjIter.More(); anObjIter.Next())
+  {
+    Handle(AIS_Shape) aShape = Handle(AIS_Shape)::DownCast(anObjIter.Value());
+    if (const Handle(AIS_ConnectedInteractive) anInstance =
+          Handle(AIS_ConnectedInteractive)::DownCast(anObjIter.Value());
+        !anInstance.IsNull())
+    {
+      aShape = Handle(AIS_Shape)::DownCast(anInstance->ConnectedTo());
+      if (!aShape.IsNull() && !aVisitedPrototypes.insert(aShape.get()).second)
+      {
+        continue;
+      }
+    }
+    if (aShape.IsNull() || myMemoryBudget.isEvicted(aShape)
+        || myMeshCache.isMeshOnly(aShape->Shape()))
+    {
+      // evicted shapes are rebuilt by updateMemoryBudget() once they enter a view,
+      // imported meshes have no levels to swap
+      continue;
+    }
+
+    const TopoDS_TShape* aTShape = aShape->Shape().TShape().get();
+    if (aSwappedShapes.count(aTShape) != 0)
+    {
+      aShape->Attributes()->SetAutoTriangulation(Standard_False);
+      myContext->Redisplay(aShape, false);
+      isChanged = true;
+      continue;
+    }
+
+    const int aLevel = desiredMeshLevel(aShape->Shape(), aPixelSize);
+    if (myMeshCache.activeLevel(aShape->Shape()) != aLevel && applyMeshLevel(aShape, aLevel))
+    {
+      aSwappedShapes.insert(aTShape);
+      isChanged = true;
+    }
+  }
+
+  if (isChanged)
+  {
+    invalidateViews();
+  }
+}
+
+// ================================================================
+// Function : updateMemoryBudget
+// Purpose  :
+// ================================================================
+void GlfwOcctView::updateMemoryBudget(const double theTime)
+{
+  std::vector<Handle(AIS_Shape)> aRestored;
+  bool isChanged = myMemoryBudget.update(myContext,
+                                         visibleViews(),
+                                         myMeshCache,
+                                         glContext(),
+                                         theTime,
+                                         THE_MESH_LEVEL_UPDATE_INTERVAL,
+                                         aRestored);
+
+  // restored shapes show the coarse level until the desired one is read back or meshed again
+  const double aPixelSize = finestPixelSize();
+  for (const Handle(AIS_Shape)& aShape : aRestored)
+  {
+    if (!applyMeshLevel(aShape, desiredMeshLevel(aShape->Shape(), aPixelSize)))
+    {
+      myContext->Redisplay(aShape, false);
+    }
+    isChanged = true;
+  }
+  if (isChanged)
+  {
+    invalidateViews();
+  }
+}
+
+// ================================================================
+// Function : visibleViews
+// Purpose  :
+// ================================================================
+std::vector<Handle(V3d_View)> GlfwOcctView::visibleViews() const
+{
+  std::vector<Handle(V3d_View)> aViews;
+  for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+  {
+    if (aPanel->IsVisible)
+    {
+      aViews.push_back(aPanel->View);
+    }
+  }
+  return aViews;
+}
+
+// ================================================================
+// Function : finestPixelSize
+// Purpose  :
+// ================================================================
+double GlfwOcctView::finestPixelSize() const
+{
+  double aPixelSize = -1.0;
+  for (const Handle(V3d_View)& aView : visibleViews())
+  {
+    const double aViewPixelSize = aView->Convert(1);
+    if (aViewPixelSize > 0.0 && (aPixelSize < 0.0 || aViewPixelSize < aPixelSize))
+    {
+      aPixelSize = aViewPixelSize;
+    }
+  }
+  return aPixelSize > 0.0 ? aPixelSize : myView->Convert(1);
+}
+
+// ================================================================
+// Function : initDemoScene
+// Purpose  :
+// ================================================================
+void GlfwOcctView::initDemoScene()
+{
+  if (myContext.IsNull())
+  {
+    return;
+  }
+
+  OccImguiStartupTimeline::Scope aScope(myStartupTimeline, "demo scene");
+  gp_Ax2                         anAxis;
+  anAxis.SetLocation(gp_Pnt(0.0, 0.0, 0.0));
+  Handle(AIS_Shape) aBox = new AIS_Shape(BRepPrimAPI_MakeBox(anAxis, 50, 50, 50).Shape());
+  anAxis.SetLocation(gp_Pnt(25.0, 125.0, 0.0));
+  Handle(AIS_Shape) aCone = new AIS_Shape(BRepPrimAPI_MakeCone(anAxis, 25, 0, 50).Shape());
+
+  // mesh explicitly (in parallel) instead of lazily on first display
+  myMeshCache.mesh({aBox->Shape(), aCone->Shape()}, OccImguiMeshLodCache::Level_Medium);
+  for (const Handle(AIS_Shape)& aShape : {aBox, aCone})
+  {
+    applyMeshLevel(aShape, OccImguiMeshLodCache::Level_Medium);
+    myContext->Display(aShape, AIS_Shaded, 0, false);
+    addSceneObject(aShape);
+  }
+}
+
+// ================================================================
+// Function : isCameraGesture
+// Purpose  :
+// ================================================================
+bool GlfwOcctView::isCameraGesture() const
+{
+  switch (myMouseActiveGesture)
+  {
+    case AIS_MouseGesture_Zoom:
+    case AIS_MouseGesture_ZoomWindow:
+    case AIS_MouseGesture_Pan:
+    case AIS_MouseGesture_RotateOrbit:
+    case AIS_MouseGesture_RotateView:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// ================================================================
+// Function : isCameraInteraction
+// Purpose  :
+// ================================================================
+bool GlfwOcctView::isCameraInteraction() const
+{
+  // wheel steps are queued into the UI buffer until FlushViewEvents()
+  return isCameraGesture() || !myUI.ZoomActions.IsEmpty() || !ViewAnimation()->IsStopped();
+}
+
+// ================================================================
+// Function : handleDynamicHighlight
+// Purpose  :
+// ================================================================
+void GlfwOcctView::handleDynamicHighlight(const Handle(AIS_InteractiveContext)& theCtx,
+                                          const Handle(V3d_View)&               theView)
+{
+  // nothing is highlighted while the camera is being rotated, panned or zoomed;
+  // the pending detection runs on the first frame after the gesture
+  myIsHoverPending = false;
+  if (isCameraGesture())
+  {
+    return;
+  }
+
+  // the interval grows with the cost of detection, so that hovering heavy scenes
+  // never takes more than about half of the frame time; replays keep the fixed interval
+  const double aTime          = frameTime();
+  const double aDetectionTime = myFrameClock >= 0.0 ? 0.0 : myHoverDuration;
+  if (myGL.MoveTo.ToHilight
+      && aTime - myHoverTime < std::max(THE_HOVER_MIN_INTERVAL, aDetectionTime))
+  {
+    myIsHoverPending = true;
+    return;
+  }
+
+  const bool   isHover = myGL.MoveTo.ToHilight;
+  const double aStart  = glfwGetTime();
+  AIS_ViewController::handleDynamicHighlight(theCtx, theView);
+  if (isHover)
+  {
+    myHoverDuration = glfwGetTime() - aStart;
+    myHoverTime     = aTime + aDetectionTime;
+  }
+}
+
+// ================================================================
+// Function : handleViewRedraw
+// Purpose  :
+// ================================================================
+void GlfwOcctView::handleViewRedraw(const Handle(AIS_InteractiveContext)& theCtx,
+                                    const Handle(V3d_View)&               theView)
+{
+  // the base implementation redraws every active view of the viewer that has been invalidated
+  // (plus theView while animating), so views whose camera and content are unchanged keep
+  // their last image; views of hidden panels are not active
+  bool                       isSceneDirty = false;
+  Handle(OpenGl_FrameBuffer) aBoundFbo;
+  for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+  {
+    updateViewFramebuffer(*aPanel);
+    if (aPanel->IsVisible
+        && (aPanel->View->IsInvalidated() || aPanel->View->IsInvalidatedImmediate()
+            || (myToAskNextFrame && aPanel->View == theView)))
+    {
+      ++aPanel->NbRedraws;
+      isSceneDirty = true;
+      aBoundFbo    = aPanel->Fbo;
+    }
+  }
+  if (!isSceneDirty)
+  {
+    myToWaitEvents = true;
+    return;
+  }
+
+  AIS_ViewController::handleViewRedraw(theCtx, theView);
+  ++myNbSceneFrames;
+  if (!aBoundFbo.IsNull())
+  {
+    // ImGui renders into the window framebuffer
+    aBoundFbo->UnbindBuffer(glContext());
+  }
+  myToWaitEvents = !myToAskNextFrame;
+}
+
+// ================================================================
+// Function : glContext
+// Purpose  :
+// ================================================================
+Handle(OpenGl_Context) GlfwOcctView::glContext() const
+{
+  if (myView.IsNull())
+  {
+    return Handle(OpenGl_Context)();
+  }
+
+  const Handle(OpenGl_GraphicDriver) aDriver =
+    Handle(OpenGl_GraphicDriver)::DownCast(myView->Viewer()->Driver());
+  return !aDriver.IsNull() ? aDriver->GetSharedContext() : Handle(OpenGl_Context)();
+}
+
+// ================================================================
+// Function : finishGpu
+// Purpose  :
+// ================================================================
+void GlfwOcctView::finishGpu() const
+{
+  if (const Handle(OpenGl_Context) aGlCtx = glContext(); !aGlCtx.IsNull())
+  {
+    aGlCtx->core11fwd->glFinish();
+  }
+}
+
+// ================================================================
+// Function : mainloop
+// Purpose  :
+// ================================================================
+void GlfwOcctView::mainloop()
+{
+  while (!glfwWindowShouldClose(myOcctWindow->getGlfwWindow()))
+  {
+    // glfwPollEvents() for continuous rendering (immediate return if there are no new events)
+    // and glfwWaitEvents() for rendering on demand (something actually happened in the viewer)
+    myProfiler.beginFrame();
+    {
+      OccImguiProfiler::Scope anEventsScope(myProfiler, OccImguiProfiler::Stage_Events);
+      const double            aTimeout = eventTimeout();
+      if (aTimeout == 0.0)
+      {
+        glfwPollEvents();
+      }
+      else if (aTimeout < 0.0)
+      {
+        glfwWaitEvents();
+      }
+      else
+      {
+        glfwWaitEventsTimeout(aTimeout);
+      }
+
+      // frames never start earlier than the frame rate limit allows, events are still processed
+      for (double aDelay = myFramePacer.frameDelay(glfwGetTime()); aDelay > 0.0;
+           aDelay        = myFramePacer.frameDelay(glfwGetTime()))
+      {
+        glfwWaitEventsTimeout(aDelay);
+      }
+    }
+    if (!myView.IsNull())
+    {
+      renderFrame(frameTime());
+    }
   }
+}
 
-  glfwSwapBuffers(myOcctWindow->getGlfwWindow());
+// ================================================================
+// Function : eventTimeout
+// Purpose  :
+// ================================================================
+double GlfwOcctView::eventTimeout() const
+{
+  // polling for continuous rendering, waiting for rendering on demand
+  // (something actually happened in the viewer); the "Scene" panel indexes objects over frames,
+  // and startup completes right after the first frame
+  if (!myToWaitEvents || myIsStartupPending || myImporter.hasPendingObjects()
+      || (myIsScenePanelVisible && !mySceneIndex.isComplete()))
+  {
+    return 0.0;
+  }
+  if (myInputQueue.hasPendingResize())
+  {
+    // wake up once the window size has settled
+    return THE_RESIZE_DEBOUNCE_TIME;
+  }
+  if (myIsHoverPending)
+  {
+    // throttled hover detection resumes once its interval has passed
+    return THE_HOVER_MIN_INTERVAL;
+  }
+  if (myAdaptiveResolution.isDegraded())
+  {
+    // full quality is restored once the camera has been still for a moment
+    return myAdaptiveResolution.refineDelay();
+  }
+  if (myImporter.isRunning() || !myModeling.tasks().empty())
+  {
+    // keep refreshing progress bars while the importer or modeling tasks are busy
+    return 0.1;
+  }
+  return -1.0;
 }
 
 // ================================================================
-// Function : initDemoScene
+// Function : eventLoop
 // Purpose  :
 // ================================================================
-void GlfwOcctView::initDemoScene() const
+void GlfwOcctView::eventLoop()
 {
-  if (myContext.IsNull())
+  // frames never hold up event processing, so the window stays responsive during heavy redraws
+  while (!glfwWindowShouldClose(myOcctWindow->getGlfwWindow()))
+  {
+    if (flushRenderBacklog())
+    {
+      glfwWaitEvents();
+    }
+    else
+    {
+      glfwWaitEventsTimeout(THE_RENDER_BACKLOG_RETRY);
+    }
+  }
+}
+
+// ================================================================
+// Function : renderLoop
+// Purpose  :
+// ================================================================
+void GlfwOcctView::renderLoop()
+{
+  glfwMakeContextCurrent(myOcctWindow->getGlfwWindow());
+  initGui();
+  myProfiler.setGlContext(glContext());
+  while (!myToStopRender)
+  {
+    myProfiler.beginFrame();
+    {
+      OccImguiProfiler::Scope anEventsScope(myProfiler, OccImguiProfiler::Stage_Events);
+      waitRenderCommands(eventTimeout());
+
+      // the wakeup flag is cleared before queued events and background results are taken,
+      // so that anything arriving later wakes up the next wait
+      myIsRenderWoken = false;
+      applyRenderCommands();
+
+      // events arriving meanwhile are queued for the next frame
+      if (const double aDelay = myFramePacer.frameDelay(glfwGetTime()); aDelay > 0.0)
+      {
+        waitRenderCommands(aDelay, true);
+      }
+    }
+    if (!myToStopRender && !myView.IsNull())
+    {
+      renderFrame(frameTime());
+    }
+  }
+  glfwMakeContextCurrent(nullptr);
+}
+
+// ================================================================
+// Function : pushRenderCommand
+// Purpose  :
+// ================================================================
+void GlfwOcctView::pushRenderCommand(const RenderCommand& theCommand)
+{
+  if (!flushRenderBacklog() || !myRenderCommands.push(theCommand))
+  {
+    myRenderBacklog.push_back(theCommand);
+  }
+  wakeup();
+}
+
+// ================================================================
+// Function : flushRenderBacklog
+// Purpose  :
+// ================================================================
+bool GlfwOcctView::flushRenderBacklog()
+{
+  while (!myRenderBacklog.empty())
+  {
+    if (!myRenderCommands.push(myRenderBacklog.front()))
+    {
+      return false;
+    }
+    myRenderBacklog.pop_front();
+    wakeup();
+  }
+  return true;
+}
+
+// ================================================================
+// Function : waitRenderCommands
+// Purpose  :
+// ================================================================
+void GlfwOcctView::waitRenderCommands(const double theTimeout, const bool theIsPacing)
+{
+  if (theTimeout == 0.0)
   {
     return;
   }
 
-  myView->TriedronDisplay(Aspect_TOTP_LEFT_LOWER, Quantity_NOC_GOLD, 0.08, V3d_WIREFRAME);
+  const auto isWokenUp = [this, theIsPacing]() {
+    return myToStopRender.load() || (!theIsPacing && myIsRenderWoken.load());
+  };
 
-  gp_Ax2 anAxis;
-  anAxis.SetLocation(gp_Pnt(0.0, 0.0, 0.0));
-  Handle(AIS_Shape) aBox = new AIS_Shape(BRepPrimAPI_MakeBox(anAxis, 50, 50, 50).Shape());
-  myContext->Display(aBox, AIS_Shaded, 0, false);
-  anAxis.SetLocation(gp_Pnt(25.0, 125.0, 0.0));
-  Handle(AIS_Shape) aCone = new AIS_Shape(BRepPrimAPI_MakeCone(anAxis, 25, 0, 50).Shape());
-  myContext->Display(aCone, AIS_Shaded, 0, false);
+  std::unique_lock<std::mutex> aLock(myRenderMutex);
+  myIsRenderSleeping = true;
+  if (theTimeout < 0.0)
+  {
+    myRenderCondition.wait(aLock, isWokenUp);
+  }
+  else
+  {
+    myRenderCondition.wait_for(aLock, std::chrono::duration<double>(theTimeout), isWokenUp);
+  }
+  myIsRenderSleeping = false;
+}
 
-  TCollection_AsciiString aGlInfo;
+// ================================================================
+// Function : wakeup
+// Purpose  :
+// ================================================================
+void GlfwOcctView::wakeup()
+{
+  if (!hasRenderThread())
+  {
+    glfwPostEmptyEvent();
+    return;
+  }
+
+  // the mutex is taken only while the render thread sleeps (or is about to);
+  // the flag set before the check is seen by its wait otherwise
+  myIsRenderWoken = true;
+  if (myIsRenderSleeping)
   {
-    TColStd_IndexedDataMapOfStringString aRendInfo;
-    myView->DiagnosticInformation(aRendInfo, Graphic3d_DiagnosticInfo_Basic);
-    for (TColStd_IndexedDataMapOfStringString::Iterator aValueIter(aRendInfo); aValueIter.More();
-         aValueIter.Next())
     {
-      if (!aGlInfo.IsEmpty())
-      {
-        aGlInfo += "\n";
+      std::lock_guard<std::mutex> aLock(myRenderMutex);
+    }
+    myRenderCondition.notify_one();
+  }
+}
+
+// ================================================================
+// Function : applyRenderCommands
+// Purpose  :
+// ================================================================
+void GlfwOcctView::applyRenderCommands()
+{
+  // ImGui receives the events as from its GLFW callbacks,
+  // the view receives them through the input queue as without a render thread
+  ImGuiIO&      aIO = ImGui::GetIO();
+  RenderCommand aCommand;
+  while (myRenderCommands.pop(aCommand))
+  {
+    const ImVec2 aPos(static_cast<float>(aCommand.Position.x()),
+                      static_cast<float>(aCommand.Position.y()));
+    switch (aCommand.Type)
+    {
+      case RenderCommand_MouseMove: {
+        aIO.AddMousePosEvent(aPos.x, aPos.y);
+        myInputQueue.pushMouseMove(aCommand.Position);
+        myFramePacer.addInput(aCommand.Time);
+        break;
+      }
+      case RenderCommand_MouseButton: {
+        addImguiKeyMods(aIO, aCommand.Mods);
+        aIO.AddMousePosEvent(aPos.x, aPos.y);
+        if (aCommand.Code >= 0 && aCommand.Code < ImGuiMouseButton_COUNT)
+        {
+          aIO.AddMouseButtonEvent(aCommand.Code, aCommand.Action == GLFW_PRESS);
+        }
+        myInputQueue.pushMouseButton(aCommand.Position,
+                                     aCommand.Code,
+                                     aCommand.Action,
+                                     aCommand.Mods);
+        myFramePacer.addInput(aCommand.Time);
+        break;
+      }
+      case RenderCommand_Scroll: {
+        aIO.AddMousePosEvent(aPos.x, aPos.y);
+        aIO.AddMouseWheelEvent(static_cast<float>(aCommand.ScrollDelta.x()),
+                               static_cast<float>(aCommand.ScrollDelta.y()));
+        myInputQueue.pushScroll(aCommand.Position, aCommand.ScrollDelta.y());
+        myFramePacer.addInput(aCommand.Time);
+        break;
+      }
+      case RenderCommand_Key: {
+        addImguiKeyMods(aIO, aCommand.Mods);
+        if (const ImGuiKey aKey = imguiKeyFromGlfw(aCommand.Code); aKey != ImGuiKey_None)
+        {
+          aIO.AddKeyEvent(aKey, aCommand.Action != GLFW_RELEASE);
+        }
+        myFramePacer.addInput(aCommand.Time);
+        break;
+      }
+      case RenderCommand_Char: {
+        aIO.AddInputCharacter(static_cast<unsigned int>(aCommand.Code));
+        myFramePacer.addInput(aCommand.Time);
+        break;
+      }
+      case RenderCommand_Focus: {
+        aIO.AddFocusEvent(aCommand.Code != 0);
+        break;
+      }
+      case RenderCommand_CursorEnter: {
+        if (aCommand.Code == 0)
+        {
+          aIO.AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+        }
+        break;
+      }
+      case RenderCommand_Resize: {
+        myWindowSize      = aCommand.Position;
+        myFramebufferSize = aCommand.FramebufferSize;
+        myInputQueue.pushResize(aCommand.Position, aCommand.Time);
+        break;
       }
-      aGlInfo += TCollection_AsciiString("  ") + aValueIter.Key() + ": " + aValueIter.Value();
     }
   }
-  Message::DefaultMessenger()->Send(TCollection_AsciiString("OpenGL info:\n") + aGlInfo,
-                                    Message_Info);
 }
 
 // ================================================================
-// Function : handleViewRedraw
+// Function : newGuiPlatformFrame
 // Purpose  :
 // ================================================================
-void GlfwOcctView::handleViewRedraw(const Handle(AIS_InteractiveContext)& theCtx,
-                                    const Handle(V3d_View)&               theView)
+void GlfwOcctView::newGuiPlatformFrame()
 {
-  AIS_ViewController::handleViewRedraw(theCtx, theView);
-  myToWaitEvents = !myToAskNextFrame;
+  ImGuiIO& aIO    = ImGui::GetIO();
+  aIO.DisplaySize = ImVec2(static_cast<float>(myWindowSize.x()),
+                           static_cast<float>(myWindowSize.y()));
+  if (myWindowSize.x() > 0 && myWindowSize.y() > 0)
+  {
+    aIO.DisplayFramebufferScale =
+      ImVec2(static_cast<float>(myFramebufferSize.x()) / static_cast<float>(myWindowSize.x()),
+             static_cast<float>(myFramebufferSize.y()) / static_cast<float>(myWindowSize.y()));
+  }
+
+  const double aTime = frameTime();
+  aIO.DeltaTime =
+    myGuiTime > 0.0 ? std::max(static_cast<float>(aTime - myGuiTime), 1.0e-4f) : 1.0f / 60.0f;
+  myGuiTime = aTime;
 }
 
 // ================================================================
-// Function : mainloop
+// Function : renderFrame
 // Purpose  :
 // ================================================================
-void GlfwOcctView::mainloop()
+void GlfwOcctView::renderFrame(const double theTime)
 {
-  while (!glfwWindowShouldClose(myOcctWindow->getGlfwWindow()))
+  const double aRenderStart = glfwGetTime();
+  myFramePacer.beginFrame(aRenderStart);
   {
-    // glfwPollEvents() for continuous rendering (immediate return if there are no new events)
-    // and glfwWaitEvents() for rendering on demand (something actually happened in the viewer)
-    if (myToWaitEvents)
+    OccImguiProfiler::Scope anUpdateScope(myProfiler, OccImguiProfiler::Stage_Update);
+    if (myIsStartupPending && myStartupTimeline.hasFirstFrame())
     {
-      glfwWaitEvents();
+      completeStartup();
     }
-    else
+    applyInputEvents();
+    displayImportedObjects();
+    applyModelingResults();
+    updateMeshLevels(theTime);
+    updateMemoryBudget(theTime);
+    if (mySceneLod.update(myContext, visibleViews(), theTime, THE_MESH_LEVEL_UPDATE_INTERVAL))
     {
-      glfwPollEvents();
+      invalidateViews();
     }
-    if (!myView.IsNull())
+    if (myAdaptiveResolution.update(isCameraInteraction(), theTime, myDegradedFrameTime))
     {
-      myView->InvalidateImmediate(); // redraw view even if it wasn't modified
-      FlushViewEvents(myContext, myView, true);
-
-      renderGui();
+      myAdaptiveResolution.apply(myView);
     }
   }
+
+  // the scene is redrawn only when invalidated by input, animations or scene changes;
+  // GUI-only frames composite the last image of the offscreen framebuffer
+  const size_t aNbSceneFrames = myNbSceneFrames;
+  {
+    OccImguiProfiler::Scope aSceneScope(myProfiler, OccImguiProfiler::Stage_Scene, true);
+    FlushViewEvents(myContext, myView, true);
+  }
+  renderGui();
+
+  // the swap waits for the GPU, so the whole frame reflects the cost of the redraw
+  myDegradedFrameTime = myAdaptiveResolution.isDegraded() && myNbSceneFrames != aNbSceneFrames
+                          ? glfwGetTime() - aRenderStart
+                          : 0.0;
+}
+
+// ================================================================
+// Function : frameTime
+// Purpose  :
+// ================================================================
+double GlfwOcctView::frameTime() const
+{
+  return myFrameClock >= 0.0 ? myFrameClock : glfwGetTime();
 }
 
 // ================================================================
 // Function : cleanup
 // Purpose  :
 // ================================================================
-void GlfwOcctView::cleanup() const
+void GlfwOcctView::cleanup()
 {
+  // Stop the importer before GLFW goes away as its wakeup callback posts GLFW events.
+  myImporter.cancel();
+  myImporter.wait();
+  myImporter.setWakeupCallback(nullptr);
+  myModeling.cancel();
+  myModeling.wait();
+  myModeling.setWakeupCallback(nullptr);
+
+  if (!myRecordPath.empty())
+  {
+    if (myInputRecording.write(myRecordPath))
+    {
+      Message::DefaultMessenger()->Send(TCollection_AsciiString("Recorded ")
+                                          + int(myInputRecording.events().size())
+                                          + " input events into '" + myRecordPath.c_str() + "'",
+                                        Message_Info);
+    }
+    else
+    {
+      Message::DefaultMessenger()->Send(TCollection_AsciiString("Unable to write '")
+                                          + myRecordPath.c_str() + "'",
+                                        Message_Fail);
+    }
+  }
+  myMeshCache.setWakeupCallback(nullptr);
+
   // Cleanup IMGUI.
   ImGui_ImplOpenGL3_Shutdown();
-  ImGui_ImplGlfw_Shutdown();
+  if (!hasRenderThread())
+  {
+    ImGui_ImplGlfw_Shutdown();
+  }
   ImGui::DestroyContext();
 
-  if (!myView.IsNull())
+  myProfiler.releaseGlResources();
+  // the main panel goes last, as its view provides the OpenGL context to the others
+  if (!myViewPanels.empty())
+  {
+    setActiveViewPanel(myViewPanels.front().get());
+  }
+  for (size_t aPanelIter = myViewPanels.size(); aPanelIter-- > 0;)
   {
-    myView->Remove();
+    releaseViewPanel(*myViewPanels[aPanelIter]);
   }
+  myViewPanels.clear();
+  setActiveViewPanel(nullptr);
   if (!myOcctWindow.IsNull())
   {
     myOcctWindow->Close();
@@ -425,20 +2725,110 @@ void GlfwOcctView::cleanup() const
   glfwTerminate();
 }
 
+// ================================================================
+// Function : applyInputEvents
+// Purpose  :
+// ================================================================
+void GlfwOcctView::applyInputEvents()
+{
+  Graphic3d_Vec2i aWindowSize;
+  if (myInputQueue.takeResize(frameTime(), THE_RESIZE_DEBOUNCE_TIME, aWindowSize)
+      && aWindowSize.x() != 0 && aWindowSize.y() != 0)
+  {
+    // the panel (and the offscreen framebuffer with it) follows the new layout of ImGui
+    if (hasRenderThread())
+    {
+      myOcctWindow->SetSize(aWindowSize);
+    }
+    else
+    {
+      myOcctWindow->DoResize();
+    }
+  }
+
+  // the panel under the cursor receives input, unless a gesture is in progress
+  if (PressedMouseButtons() == Aspect_VKeyMouse_NONE)
+  {
+    for (const std::unique_ptr<ViewPanel>& aPanel : myViewPanels)
+    {
+      if (aPanel->IsHovered)
+      {
+        setActiveViewPanel(aPanel.get());
+        break;
+      }
+    }
+  }
+
+  const bool isViewHovered = myActivePanel != nullptr && myActivePanel->IsHovered;
+  myInputEvents.clear();
+  myInputQueue.takeEvents(myInputEvents);
+  for (const OccImguiInputQueue::Event& anEvent : myInputEvents)
+  {
+    // gestures started within the panel continue outside of it until the button is released
+    if (!isViewHovered && PressedMouseButtons() == Aspect_VKeyMouse_NONE)
+    {
+      continue;
+    }
+
+    const Graphic3d_Vec2i aPos = toViewPosition(anEvent.Position);
+    switch (anEvent.Type)
+    {
+      case OccImguiInputQueue::EventType_MouseMove: {
+        UpdateMousePosition(aPos, PressedMouseButtons(), LastMouseFlags(), false);
+        break;
+      }
+      case OccImguiInputQueue::EventType_MouseButton: {
+        const Aspect_VKeyMouse aButton = mouseButtonFromGlfw(anEvent.Button);
+        const Aspect_VKeyFlags aFlags  = keyFlagsFromGlfw(anEvent.Mods);
+        if (anEvent.Action == GLFW_PRESS)
+        {
+          PressMouseButton(aPos, aButton, aFlags, false);
+        }
+        else
+        {
+          ReleaseMouseButton(aPos, aButton, aFlags, false);
+        }
+        break;
+      }
+      case OccImguiInputQueue::EventType_Scroll: {
+        UpdateZoom(Aspect_ScrollDelta(aPos, static_cast<int>(anEvent.ScrollDelta * 8.0)));
+        break;
+      }
+    }
+  }
+}
+
 // ================================================================
 // Function : onResize
 // Purpose  :
 // ================================================================
 void GlfwOcctView::onResize(const int theWidth, const int theHeight)
 {
-  if (theWidth != 0 && theHeight != 0 && !myView.IsNull())
+  if (myFrameClock >= 0.0)
   {
-    myView->Window()->DoResize();
-    myView->MustBeResized();
-    myView->Invalidate();
-    FlushViewEvents(myContext, myView, true);
-    renderGui();
+    return;
+  }
+
+  // window and framebuffer size callbacks both end up here and are merged by the queue;
+  // the window size is recorded, as replays set the window size
+  OccImguiInputRecording::Event anEvent;
+  anEvent.Type = OccImguiInputRecording::EventType_Resize;
+  glfwGetWindowSize(myOcctWindow->getGlfwWindow(), &anEvent.Position.x(), &anEvent.Position.y());
+  recordInput(anEvent);
+  if (hasRenderThread())
+  {
+    // the render thread cannot query sizes, both are passed with the event
+    RenderCommand aCommand;
+    aCommand.Type     = RenderCommand_Resize;
+    aCommand.Position = anEvent.Position;
+    aCommand.Time     = glfwGetTime();
+    glfwGetFramebufferSize(myOcctWindow->getGlfwWindow(),
+                           &aCommand.FramebufferSize.x(),
+                           &aCommand.FramebufferSize.y());
+    pushRenderCommand(aCommand);
+    return;
   }
+  myInputQueue.pushResize(Graphic3d_Vec2i(theWidth, theHeight), glfwGetTime());
 }
 
 // ================================================================
@@ -447,11 +2837,28 @@ void GlfwOcctView::onResize(const int theWidth, const int theHeight)
 // ================================================================
 void GlfwOcctView::onMouseScroll(const double theOffsetX, const double theOffsetY)
 {
-  if (const ImGuiIO& aIO = ImGui::GetIO(); !myView.IsNull() && !aIO.WantCaptureMouse)
+  if (myFrameClock >= 0.0)
+  {
+    return;
+  }
+
+  OccImguiInputRecording::Event anEvent;
+  anEvent.Type        = OccImguiInputRecording::EventType_Scroll;
+  anEvent.Position    = myOcctWindow->CursorPosition();
+  anEvent.ScrollDelta = theOffsetY;
+  recordInput(anEvent);
+  if (hasRenderThread())
   {
-    UpdateZoom(
-      Aspect_ScrollDelta(myOcctWindow->CursorPosition(), static_cast<int>(theOffsetY * 8.0)));
+    RenderCommand aCommand;
+    aCommand.Type        = RenderCommand_Scroll;
+    aCommand.Position    = anEvent.Position;
+    aCommand.ScrollDelta = Graphic3d_Vec2d(theOffsetX, theOffsetY);
+    aCommand.Time        = glfwGetTime();
+    pushRenderCommand(aCommand);
+    return;
   }
+  myInputQueue.pushScroll(anEvent.Position, theOffsetY);
+  myFramePacer.addInput(glfwGetTime());
 }
 
 // ================================================================
@@ -460,20 +2867,32 @@ void GlfwOcctView::onMouseScroll(const double theOffsetX, const double theOffset
 // ================================================================
 void GlfwOcctView::onMouseButton(const int theButton, const int theAction, const int theMods)
 {
-  if (const ImGuiIO& aIO = ImGui::GetIO(); myView.IsNull() || aIO.WantCaptureMouse)
+  if (myFrameClock >= 0.0)
   {
     return;
   }
 
-  const Graphic3d_Vec2i aPos = myOcctWindow->CursorPosition();
-  if (theAction == GLFW_PRESS)
-  {
-    PressMouseButton(aPos, mouseButtonFromGlfw(theButton), keyFlagsFromGlfw(theMods), false);
-  }
-  else
+  OccImguiInputRecording::Event anEvent;
+  anEvent.Type     = OccImguiInputRecording::EventType_MouseButton;
+  anEvent.Position = myOcctWindow->CursorPosition();
+  anEvent.Button   = theButton;
+  anEvent.Action   = theAction;
+  anEvent.Mods     = theMods;
+  recordInput(anEvent);
+  if (hasRenderThread())
   {
-    ReleaseMouseButton(aPos, mouseButtonFromGlfw(theButton), keyFlagsFromGlfw(theMods), false);
+    RenderCommand aCommand;
+    aCommand.Type     = RenderCommand_MouseButton;
+    aCommand.Position = anEvent.Position;
+    aCommand.Code     = theButton;
+    aCommand.Action   = theAction;
+    aCommand.Mods     = theMods;
+    aCommand.Time     = glfwGetTime();
+    pushRenderCommand(aCommand);
+    return;
   }
+  myInputQueue.pushMouseButton(anEvent.Position, theButton, theAction, theMods);
+  myFramePacer.addInput(glfwGetTime());
 }
 
 // ================================================================
@@ -482,18 +2901,91 @@ void GlfwOcctView::onMouseButton(const int theButton, const int theAction, const
 // ================================================================
 void GlfwOcctView::onMouseMove(const int thePosX, const int thePosY)
 {
-  if (myView.IsNull())
+  if (myFrameClock >= 0.0)
   {
     return;
   }
 
-  if (const ImGuiIO& aIO = ImGui::GetIO(); aIO.WantCaptureMouse)
+  OccImguiInputRecording::Event anEvent;
+  anEvent.Type     = OccImguiInputRecording::EventType_MouseMove;
+  anEvent.Position = Graphic3d_Vec2i(thePosX, thePosY);
+  recordInput(anEvent);
+  if (hasRenderThread())
   {
-    // myView->Redraw();
+    RenderCommand aCommand;
+    aCommand.Type     = RenderCommand_MouseMove;
+    aCommand.Position = anEvent.Position;
+    aCommand.Time     = glfwGetTime();
+    pushRenderCommand(aCommand);
+    return;
   }
-  else
+  myInputQueue.pushMouseMove(anEvent.Position);
+  myFramePacer.addInput(glfwGetTime());
+}
+
+// ================================================================
+// Function : onKey
+// Purpose  :
+// ================================================================
+void GlfwOcctView::onKey(const int theKey, const int theAction, const int theMods)
+{
+  RenderCommand aCommand;
+  aCommand.Type   = RenderCommand_Key;
+  aCommand.Code   = theKey;
+  aCommand.Action = theAction;
+  aCommand.Mods   = modifiersAfterGlfwKey(theKey, theAction, theMods);
+  aCommand.Time   = glfwGetTime();
+  pushRenderCommand(aCommand);
+}
+
+// ================================================================
+// Function : onChar
+// Purpose  :
+// ================================================================
+void GlfwOcctView::onChar(const unsigned int theCodepoint)
+{
+  RenderCommand aCommand;
+  aCommand.Type = RenderCommand_Char;
+  aCommand.Code = static_cast<int>(theCodepoint);
+  aCommand.Time = glfwGetTime();
+  pushRenderCommand(aCommand);
+}
+
+// ================================================================
+// Function : onFocus
+// Purpose  :
+// ================================================================
+void GlfwOcctView::onFocus(const bool theIsFocused)
+{
+  RenderCommand aCommand;
+  aCommand.Type = RenderCommand_Focus;
+  aCommand.Code = theIsFocused ? 1 : 0;
+  aCommand.Time = glfwGetTime();
+  pushRenderCommand(aCommand);
+}
+
+// ================================================================
+// Function : onCursorEnter
+// Purpose  :
+// ================================================================
+void GlfwOcctView::onCursorEnter(const bool theIsEntered)
+{
+  RenderCommand aCommand;
+  aCommand.Type = RenderCommand_CursorEnter;
+  aCommand.Code = theIsEntered ? 1 : 0;
+  aCommand.Time = glfwGetTime();
+  pushRenderCommand(aCommand);
+}
+
+// ================================================================
+// Function : recordInput
+// Purpose  :
+// ================================================================
+void GlfwOcctView::recordInput(OccImguiInputRecording::Event theEvent)
+{
+  if (myRecordStartTime >= 0.0)
   {
-    const Graphic3d_Vec2i aNewPos(thePosX, thePosY);
-    UpdateMousePosition(aNewPos, PressedMouseButtons(), LastMouseFlags(), false);
+    theEvent.Time = glfwGetTime() - myRecordStartTime;
+    myInputRecording.add(theEvent);
   }
 }
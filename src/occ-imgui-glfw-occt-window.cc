@@ -91,7 +91,8 @@ Aspect_RenderingContext GlfwOcctWindow::NativeGlContext() const
 // ================================================================
 Standard_Boolean GlfwOcctWindow::IsMapped() const
 {
-  return glfwGetWindowAttrib(myGlfwWindow, GLFW_VISIBLE) != 0;
+  // virtual (headless) windows are never shown but still have to be rendered
+  return IsVirtual() || glfwGetWindowAttrib(myGlfwWindow, GLFW_VISIBLE) != 0;
 }
 
 // ================================================================
@@ -118,7 +119,7 @@ void GlfwOcctWindow::Unmap() const
 // ================================================================
 Aspect_TypeOfResize GlfwOcctWindow::DoResize()
 {
-  if (glfwGetWindowAttrib(myGlfwWindow, GLFW_VISIBLE) == 1)
+  if (IsMapped())
   {
     int anXPos = 0, anYPos = 0, aWidth = 0, aHeight = 0;
     glfwGetWindowPos(myGlfwWindow, &anXPos, &anYPos);
@@ -0,0 +1,456 @@
+#include "occ_imgui/occ-imgui-importer.h"
+
+#include "occ_imgui/occ-imgui-box-placeholder.h"
+#include "occ_imgui/occ-imgui-mesh-reader.h"
+
+#include <opencascade/AIS_ConnectedInteractive.hxx>
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/BRep_Builder.hxx>
+#include <opencascade/BRepBndLib.hxx>
+#include <opencascade/BRepTools.hxx>
+#include <opencascade/IGESControl_Reader.hxx>
+#include <opencascade/Message.hxx>
+#include <opencascade/Message_Messenger.hxx>
+#include <opencascade/Message_ProgressScope.hxx>
+#include <opencascade/OSD_Parallel.hxx>
+#include <opencascade/STEPControl_Reader.hxx>
+#include <opencascade/Standard_Failure.hxx>
+#include <opencascade/TopoDS_Iterator.hxx>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+//! Maximal number of parts meshed in parallel before they are queued for display;
+//! chunks grow up to this size from a single part, so that the largest parts show up first.
+constexpr size_t THE_IMPORT_CHUNK_SIZE = 64;
+
+//! Minimal number of occurrences of a TShape to display its parts as connected instances.
+constexpr size_t THE_IMPORT_MIN_INSTANCES = 2;
+
+//! Supported file formats.
+enum ImportFormat
+{
+  ImportFormat_Unknown,
+  ImportFormat_STEP,
+  ImportFormat_IGES,
+  ImportFormat_BREP,
+  ImportFormat_Mesh //!< STL, OBJ or glTF, see OccImguiMeshReader
+};
+
+//! Detect file format from the file extension.
+ImportFormat importFormatFromPath(const TCollection_AsciiString& thePath)
+{
+  const Standard_Integer aDotPos = thePath.SearchFromEnd(".");
+  if (aDotPos <= 0)
+  {
+    return ImportFormat_Unknown;
+  }
+
+  TCollection_AsciiString anExt = thePath.SubString(aDotPos + 1, thePath.Length());
+  anExt.LowerCase();
+  if (anExt == "step" || anExt == "stp")
+  {
+    return ImportFormat_STEP;
+  }
+  if (anExt == "iges" || anExt == "igs")
+  {
+    return ImportFormat_IGES;
+  }
+  if (anExt == "brep" || anExt == "brp" || anExt == "rle")
+  {
+    return ImportFormat_BREP;
+  }
+  return OccImguiMeshReader::isSupportedFile(thePath) ? ImportFormat_Mesh : ImportFormat_Unknown;
+}
+
+//! Read and transfer a STEP or IGES file.
+TopoDS_Shape readXdeShape(XSControl_Reader&              theReader,
+                          const TCollection_AsciiString& thePath,
+                          const Message_ProgressRange&   theProgress)
+{
+  Message_ProgressScope aPS(theProgress, "Reading file", 2);
+  if (theReader.ReadFile(thePath.ToCString()) != IFSelect_RetDone)
+  {
+    return TopoDS_Shape();
+  }
+
+  aPS.Next();
+  theReader.TransferRoots(aPS.Next());
+  return theReader.OneShape();
+}
+
+//! Collect leaf (non-compound) sub-shapes of an assembly keeping their accumulated locations.
+void collectImportedParts(const TopoDS_Shape& theShape, std::vector<TopoDS_Shape>& theParts)
+{
+  if (theShape.IsNull())
+  {
+    return;
+  }
+  if (theShape.ShapeType() != TopAbs_COMPOUND)
+  {
+    theParts.push_back(theShape);
+    return;
+  }
+  for (TopoDS_Iterator aSubIter(theShape); aSubIter.More(); aSubIter.Next())
+  {
+    collectImportedParts(aSubIter.Value(), theParts);
+  }
+}
+} // namespace
+
+// ================================================================
+// Function : ~OccImguiImporter
+// Purpose  :
+// ================================================================
+OccImguiImporter::~OccImguiImporter()
+{
+  cancel();
+  wait();
+}
+
+// ================================================================
+// Function : isSupportedFile
+// Purpose  :
+// ================================================================
+bool OccImguiImporter::isSupportedFile(const TCollection_AsciiString& thePath)
+{
+  return importFormatFromPath(thePath) != ImportFormat_Unknown;
+}
+
+// ================================================================
+// Function : readShape
+// Purpose  :
+// ================================================================
+TopoDS_Shape OccImguiImporter::readShape(const TCollection_AsciiString& thePath,
+                                         const Message_ProgressRange&   theProgress)
+{
+  switch (importFormatFromPath(thePath))
+  {
+    case ImportFormat_STEP: {
+      STEPControl_Reader aReader;
+      return readXdeShape(aReader, thePath, theProgress);
+    }
+    case ImportFormat_IGES: {
+      IGESControl_Reader aReader;
+      return readXdeShape(aReader, thePath, theProgress);
+    }
+    case ImportFormat_BREP: {
+      TopoDS_Shape aShape;
+      BRep_Builder aBuilder;
+      BRepTools::Read(aShape, thePath.ToCString(), aBuilder, theProgress);
+      return aShape;
+    }
+    case ImportFormat_Mesh:
+      return OccImguiMeshReader::readShape(thePath, theProgress);
+    case ImportFormat_Unknown:
+      break;
+  }
+  return TopoDS_Shape();
+}
+
+// ================================================================
+// Function : start
+// Purpose  :
+// ================================================================
+bool OccImguiImporter::start(const TCollection_AsciiString& thePath)
+{
+  if (isRunning())
+  {
+    return false;
+  }
+
+  // objects queued by the previous import (remaining parts, or removals of placeholders left
+  // behind by cancellation) are kept, so that they are still fetched before the new ones
+  wait();
+  {
+    std::lock_guard<std::mutex> aLock(myMutex);
+    myError.Clear();
+  }
+
+  myFilePath     = thePath;
+  myProgress     = new OccImguiProgress();
+  myNbParts      = 0;
+  myNbInstances  = 0;
+  myNbPrototypes = 0;
+  myState        = State_Running;
+  myThread       = std::thread(&OccImguiImporter::perform, this, thePath, myProgress);
+  return true;
+}
+
+// ================================================================
+// Function : cancel
+// Purpose  :
+// ================================================================
+void OccImguiImporter::cancel()
+{
+  if (!myProgress.IsNull())
+  {
+    myProgress->requestCancel();
+  }
+}
+
+// ================================================================
+// Function : wait
+// Purpose  :
+// ================================================================
+void OccImguiImporter::wait()
+{
+  if (myThread.joinable())
+  {
+    myThread.join();
+  }
+}
+
+// ================================================================
+// Function : errorMessage
+// Purpose  :
+// ================================================================
+TCollection_AsciiString OccImguiImporter::errorMessage() const
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  return myError;
+}
+
+// ================================================================
+// Function : hasPendingObjects
+// Purpose  :
+// ================================================================
+bool OccImguiImporter::hasPendingObjects() const
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  return !myQueue.empty();
+}
+
+// ================================================================
+// Function : fetch
+// Purpose  :
+// ================================================================
+size_t OccImguiImporter::fetch(std::vector<ImportedObject>& theObjects,
+                               const size_t                 theMaxNbObjects)
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  const size_t                aNbObjects = std::min(theMaxNbObjects, myQueue.size());
+  for (size_t anObjIter = 0; anObjIter < aNbObjects; ++anObjIter)
+  {
+    theObjects.push_back(myQueue.front());
+    myQueue.pop_front();
+  }
+  return aNbObjects;
+}
+
+// ================================================================
+// Function : perform
+// Purpose  :
+// ================================================================
+void OccImguiImporter::perform(const TCollection_AsciiString&  thePath,
+                               const Handle(OccImguiProgress)& theProgress)
+{
+  State aResult = State_Finished;
+  try
+  {
+    Message_ProgressScope aPS(theProgress->Start(), "Importing", 10);
+    const TopoDS_Shape    aShape = readShape(thePath, aPS.Next(4));
+    if (theProgress->isCancelRequested())
+    {
+      aResult = State_Cancelled;
+    }
+    else if (aShape.IsNull())
+    {
+      std::lock_guard<std::mutex> aLock(myMutex);
+      myError = TCollection_AsciiString("Unable to read file '") + thePath + "'";
+      aResult = State_Failed;
+    }
+    else
+    {
+      std::vector<TopoDS_Shape> aParts;
+      collectImportedParts(aShape, aParts);
+      meshAndQueue(std::move(aParts), aPS.Next(6));
+      aResult = theProgress->isCancelRequested() ? State_Cancelled : State_Finished;
+    }
+  }
+  catch (const Standard_Failure& theFailure)
+  {
+    std::lock_guard<std::mutex> aLock(myMutex);
+    myError = TCollection_AsciiString("Import failed: ") + theFailure.GetMessageString();
+    aResult = State_Failed;
+  }
+  catch (const std::exception& theError)
+  {
+    std::lock_guard<std::mutex> aLock(myMutex);
+    myError = TCollection_AsciiString("Import failed: ") + theError.what();
+    aResult = State_Failed;
+  }
+
+  if (aResult == State_Failed)
+  {
+    Message::DefaultMessenger()->Send(errorMessage(), Message_Fail);
+  }
+  myState = aResult;
+  if (myWakeup)
+  {
+    myWakeup();
+  }
+}
+
+// ================================================================
+// Function : meshAndQueue
+// Purpose  :
+// ================================================================
+void OccImguiImporter::meshAndQueue(std::vector<TopoDS_Shape>    theParts,
+                                    const Message_ProgressRange& theProgress)
+{
+  Message_ProgressScope aPS(theProgress,
+                            "Meshing",
+                            static_cast<Standard_Real>(std::max<size_t>(theParts.size(), 1)));
+
+  // bounding boxes order the parts and stand in for them until they are meshed;
+  // existing triangulations (of imported meshes) are preferred over the geometry
+  std::vector<Bnd_Box> aBoxes(theParts.size());
+  OSD_Parallel::For(0, static_cast<int>(theParts.size()), [&](const int theIndex) {
+    BRepBndLib::Add(theParts[static_cast<size_t>(theIndex)],
+                    aBoxes[static_cast<size_t>(theIndex)],
+                    true);
+  });
+
+  // the largest parts first, as they dominate the view
+  std::vector<size_t> anOrder(theParts.size());
+  std::iota(anOrder.begin(), anOrder.end(), size_t(0));
+  std::stable_sort(anOrder.begin(),
+                   anOrder.end(),
+                   [&aBoxes](const size_t theLeft, const size_t theRight) {
+                     const Bnd_Box& aLeft  = aBoxes[theLeft];
+                     const Bnd_Box& aRight = aBoxes[theRight];
+                     return (aLeft.IsVoid() ? 0.0 : aLeft.SquareExtent())
+                          > (aRight.IsVoid() ? 0.0 : aRight.SquareExtent());
+                   });
+  {
+    std::vector<TopoDS_Shape> aSortedParts;
+    std::vector<Bnd_Box>      aSortedBoxes;
+    aSortedParts.reserve(theParts.size());
+    aSortedBoxes.reserve(theParts.size());
+    for (const size_t anIndex : anOrder)
+    {
+      aSortedParts.push_back(theParts[anIndex]);
+      aSortedBoxes.push_back(aBoxes[anIndex]);
+    }
+    theParts.swap(aSortedParts);
+    aBoxes.swap(aSortedBoxes);
+  }
+
+  // chunks double in size, so that the first parts are displayed right away;
+  // placeholders of all chunks are queued before meshing starts
+  std::vector<std::pair<size_t, size_t>>      aChunks;
+  std::vector<Handle(OccImguiBoxPlaceholder)> aPlaceholders;
+  for (size_t aChunkStart = 0, aChunkSize = 1; aChunkStart < theParts.size();
+       aChunkStart += aChunkSize, aChunkSize = std::min(aChunkSize * 2, THE_IMPORT_CHUNK_SIZE))
+  {
+    const size_t aChunkEnd = std::min(aChunkStart + aChunkSize, theParts.size());
+    aChunks.emplace_back(aChunkStart, aChunkEnd);
+    aPlaceholders.push_back(new OccImguiBoxPlaceholder(
+      std::vector<Bnd_Box>(aBoxes.begin() + static_cast<std::ptrdiff_t>(aChunkStart),
+                           aBoxes.begin() + static_cast<std::ptrdiff_t>(aChunkEnd))));
+  }
+  {
+    std::lock_guard<std::mutex> aLock(myMutex);
+    for (const Handle(OccImguiBoxPlaceholder)& aPlaceholder : aPlaceholders)
+    {
+      myQueue.push_back(ImportedObject{aPlaceholder, nullptr});
+    }
+  }
+  if (myWakeup)
+  {
+    myWakeup();
+  }
+
+  // instanced parts share their TShape and thus the triangulation; each TShape is meshed once
+  std::unordered_set<const TopoDS_TShape*>                          aMeshedShapes;
+  std::unordered_map<const TopoDS_TShape*, size_t>                  aNbOccurrences;
+  std::map<std::pair<const TopoDS_TShape*, int>, Handle(AIS_Shape)> aPrototypes;
+  for (const TopoDS_Shape& aPart : theParts)
+  {
+    ++aNbOccurrences[aPart.TShape().get()];
+  }
+
+  for (size_t aChunkIter = 0; aChunkIter < aChunks.size() && aPS.More(); ++aChunkIter)
+  {
+    const size_t aChunkStart = aChunks[aChunkIter].first;
+    const size_t aChunkEnd   = aChunks[aChunkIter].second;
+
+    std::vector<TopoDS_Shape> aShapesToMesh;
+    for (size_t aPartIter = aChunkStart; aPartIter < aChunkEnd; ++aPartIter)
+    {
+      if (aMeshedShapes.insert(theParts[aPartIter].TShape().get()).second)
+      {
+        aShapesToMesh.push_back(theParts[aPartIter]);
+      }
+    }
+
+    // only the cheap coarse level is meshed up front; finer levels are meshed in background
+    // by the viewer for parts whose size on screen calls for them
+    myMeshCache.mesh(aShapesToMesh, OccImguiMeshLodCache::Level_Coarse);
+    for (const TopoDS_Shape& aShape : aShapesToMesh)
+    {
+      myMeshCache.activate(aShape, OccImguiMeshLodCache::Level_Coarse);
+    }
+
+    std::vector<ImportedObject> aChunkObjects;
+    aChunkObjects.reserve(aChunkEnd - aChunkStart);
+    for (size_t aPartIter = aChunkStart; aPartIter < aChunkEnd; ++aPartIter)
+    {
+      const TopoDS_Shape& aPart = theParts[aPartIter];
+      if (aNbOccurrences[aPart.TShape().get()] < THE_IMPORT_MIN_INSTANCES)
+      {
+        // triangulation is managed by the mesh cache, AIS_Shape should never re-mesh on its own
+        Handle(AIS_Shape) aPrs = new AIS_Shape(aPart);
+        aPrs->Attributes()->SetAutoTriangulation(Standard_False);
+        aChunkObjects.push_back(ImportedObject{aPrs, nullptr});
+        continue;
+      }
+
+      // repeated parts reference one unlocated prototype, which is never displayed itself;
+      // its presentation is computed once and drawn by every instance with its own transformation
+      Handle(AIS_Shape)& aPrototype =
+        aPrototypes[std::make_pair(aPart.TShape().get(), static_cast<int>(aPart.Orientation()))];
+      if (aPrototype.IsNull())
+      {
+        aPrototype = new AIS_Shape(aPart.Located(TopLoc_Location()));
+        aPrototype->Attributes()->SetAutoTriangulation(Standard_False);
+        ++myNbPrototypes;
+      }
+
+      Handle(AIS_ConnectedInteractive) anInstance = new AIS_ConnectedInteractive();
+      anInstance->Connect(aPrototype, aPart.Location().Transformation());
+      aChunkObjects.push_back(ImportedObject{anInstance, nullptr});
+      ++myNbInstances;
+    }
+
+    // the placeholder of the chunk goes away together with its last part
+    aChunkObjects.back().Placeholder = aPlaceholders[aChunkIter];
+    aPlaceholders[aChunkIter].Nullify();
+    {
+      std::lock_guard<std::mutex> aLock(myMutex);
+      myQueue.insert(myQueue.end(), aChunkObjects.begin(), aChunkObjects.end());
+    }
+    myNbParts += aChunkObjects.size();
+    if (myWakeup)
+    {
+      myWakeup();
+    }
+    aPS.Next(static_cast<Standard_Real>(aChunkEnd - aChunkStart));
+  }
+
+  // placeholders of chunks left behind by cancellation are removed as well
+  std::lock_guard<std::mutex> aLock(myMutex);
+  for (const Handle(OccImguiBoxPlaceholder)& aPlaceholder : aPlaceholders)
+  {
+    if (!aPlaceholder.IsNull())
+    {
+      myQueue.push_back(ImportedObject{nullptr, aPlaceholder});
+    }
+  }
+}
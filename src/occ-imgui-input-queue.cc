@@ -0,0 +1,102 @@
+#include "occ_imgui/occ-imgui-input-queue.h"
+
+// ================================================================
+// Function : pushMouseMove
+// Purpose  :
+// ================================================================
+void OccImguiInputQueue::pushMouseMove(const Graphic3d_Vec2i& thePos)
+{
+  ++myNbReceived;
+  if (!myEvents.empty() && myEvents.back().Type == EventType_MouseMove)
+  {
+    myEvents.back().Position = thePos;
+    return;
+  }
+
+  Event anEvent;
+  anEvent.Type     = EventType_MouseMove;
+  anEvent.Position = thePos;
+  myEvents.push_back(anEvent);
+}
+
+// ================================================================
+// Function : pushMouseButton
+// Purpose  :
+// ================================================================
+void OccImguiInputQueue::pushMouseButton(const Graphic3d_Vec2i& thePos,
+                                         const int              theButton,
+                                         const int              theAction,
+                                         const int              theMods)
+{
+  ++myNbReceived;
+  Event anEvent;
+  anEvent.Type     = EventType_MouseButton;
+  anEvent.Position = thePos;
+  anEvent.Button   = theButton;
+  anEvent.Action   = theAction;
+  anEvent.Mods     = theMods;
+  myEvents.push_back(anEvent);
+}
+
+// ================================================================
+// Function : pushScroll
+// Purpose  :
+// ================================================================
+void OccImguiInputQueue::pushScroll(const Graphic3d_Vec2i& thePos, const double theDelta)
+{
+  ++myNbReceived;
+  if (!myEvents.empty() && myEvents.back().Type == EventType_Scroll)
+  {
+    myEvents.back().Position = thePos;
+    myEvents.back().ScrollDelta += theDelta;
+    return;
+  }
+
+  Event anEvent;
+  anEvent.Type        = EventType_Scroll;
+  anEvent.Position    = thePos;
+  anEvent.ScrollDelta = theDelta;
+  myEvents.push_back(anEvent);
+}
+
+// ================================================================
+// Function : pushResize
+// Purpose  :
+// ================================================================
+void OccImguiInputQueue::pushResize(const Graphic3d_Vec2i& theSize, const double theTime)
+{
+  ++myNbReceived;
+  myResizeSize = theSize;
+  myResizeTime = theTime;
+  myHasResize  = true;
+}
+
+// ================================================================
+// Function : takeEvents
+// Purpose  :
+// ================================================================
+void OccImguiInputQueue::takeEvents(std::vector<Event>& theEvents)
+{
+  myNbApplied += myEvents.size();
+  theEvents.insert(theEvents.end(), myEvents.begin(), myEvents.end());
+  myEvents.clear();
+}
+
+// ================================================================
+// Function : takeResize
+// Purpose  :
+// ================================================================
+bool OccImguiInputQueue::takeResize(const double     theTime,
+                                    const double     theDelay,
+                                    Graphic3d_Vec2i& theSize)
+{
+  if (!myHasResize || theTime - myResizeTime < theDelay)
+  {
+    return false;
+  }
+
+  ++myNbApplied;
+  theSize     = myResizeSize;
+  myHasResize = false;
+  return true;
+}
@@ -0,0 +1,225 @@
+#include "occ_imgui/occ-imgui-input-recording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+//! File signature followed by the format version.
+constexpr uint8_t THE_RECORDING_SIGNATURE[8] = {'O', 'C', 'C', 'I', 'R', 'E', 'C', 1};
+
+//! Append a 32-bit little-endian value.
+void appendRecordingUInt32(std::vector<uint8_t>& theData, const uint32_t theValue)
+{
+  theData.push_back(static_cast<uint8_t>(theValue));
+  theData.push_back(static_cast<uint8_t>(theValue >> 8));
+  theData.push_back(static_cast<uint8_t>(theValue >> 16));
+  theData.push_back(static_cast<uint8_t>(theValue >> 24));
+}
+
+//! Append a 32-bit little-endian signed value.
+void appendRecordingInt32(std::vector<uint8_t>& theData, const int theValue)
+{
+  appendRecordingUInt32(theData, static_cast<uint32_t>(theValue));
+}
+
+//! Reader of little-endian values with bounds checks.
+struct RecordingReader
+{
+  const uint8_t* Data   = nullptr;
+  size_t         Size   = 0;
+  size_t         Offset = 0;
+  bool           IsOk   = true;
+
+  //! Read one byte.
+  uint8_t byte()
+  {
+    if (Offset + 1 > Size)
+    {
+      IsOk = false;
+      return 0;
+    }
+    return Data[Offset++];
+  }
+
+  //! Read a 32-bit value.
+  uint32_t uint32()
+  {
+    if (Offset + 4 > Size)
+    {
+      IsOk = false;
+      return 0;
+    }
+    const uint32_t aValue = uint32_t(Data[Offset]) | (uint32_t(Data[Offset + 1]) << 8)
+                          | (uint32_t(Data[Offset + 2]) << 16)
+                          | (uint32_t(Data[Offset + 3]) << 24);
+    Offset += 4;
+    return aValue;
+  }
+
+  //! Read a 32-bit signed value.
+  int int32() { return static_cast<int>(uint32()); }
+};
+} // namespace
+
+// ================================================================
+// Function : add
+// Purpose  :
+// ================================================================
+void OccImguiInputRecording::add(const Event& theEvent)
+{
+  const double aLastTime = duration();
+  myEvents.push_back(theEvent);
+  myEvents.back().Time = std::max(theEvent.Time, aLastTime);
+}
+
+// ================================================================
+// Function : encode
+// Purpose  :
+// ================================================================
+void OccImguiInputRecording::encode(std::vector<uint8_t>& theData) const
+{
+  theData.insert(theData.end(),
+                 std::begin(THE_RECORDING_SIGNATURE),
+                 std::end(THE_RECORDING_SIGNATURE));
+  appendRecordingInt32(theData, myWindowSize.x());
+  appendRecordingInt32(theData, myWindowSize.y());
+  appendRecordingUInt32(theData, static_cast<uint32_t>(myModelPath.size()));
+  theData.insert(theData.end(), myModelPath.begin(), myModelPath.end());
+  appendRecordingUInt32(theData, static_cast<uint32_t>(myEvents.size()));
+
+  // times are stored as microsecond deltas, so that replays of the file are exact
+  uint64_t aLastMicros = 0;
+  for (const Event& anEvent : myEvents)
+  {
+    const uint64_t aMicros = std::max(aLastMicros, uint64_t(std::llround(anEvent.Time * 1.0e6)));
+    theData.push_back(static_cast<uint8_t>(anEvent.Type));
+    appendRecordingUInt32(theData,
+                          static_cast<uint32_t>(std::min<uint64_t>(aMicros - aLastMicros,
+                                                                   UINT32_MAX)));
+    aLastMicros = aMicros;
+    appendRecordingInt32(theData, anEvent.Position.x());
+    appendRecordingInt32(theData, anEvent.Position.y());
+    switch (anEvent.Type)
+    {
+      case EventType_MouseButton:
+        theData.push_back(static_cast<uint8_t>(anEvent.Button));
+        theData.push_back(static_cast<uint8_t>(anEvent.Action));
+        theData.push_back(static_cast<uint8_t>(anEvent.Mods));
+        break;
+      case EventType_Scroll: {
+        const float aDelta = static_cast<float>(anEvent.ScrollDelta);
+        uint32_t    aBits  = 0;
+        std::memcpy(&aBits, &aDelta, sizeof(aBits));
+        appendRecordingUInt32(theData, aBits);
+        break;
+      }
+      case EventType_MouseMove:
+      case EventType_Resize:
+      case EventType_NB:
+        break;
+    }
+  }
+}
+
+// ================================================================
+// Function : decode
+// Purpose  :
+// ================================================================
+bool OccImguiInputRecording::decode(const uint8_t* theData, const size_t theSize)
+{
+  myEvents.clear();
+  myModelPath.clear();
+  if (theSize < sizeof(THE_RECORDING_SIGNATURE)
+      || std::memcmp(theData, THE_RECORDING_SIGNATURE, sizeof(THE_RECORDING_SIGNATURE)) != 0)
+  {
+    return false;
+  }
+
+  RecordingReader aReader;
+  aReader.Data   = theData;
+  aReader.Size   = theSize;
+  aReader.Offset = sizeof(THE_RECORDING_SIGNATURE);
+
+  myWindowSize.x()         = aReader.int32();
+  myWindowSize.y()         = aReader.int32();
+  const uint32_t aPathSize = aReader.uint32();
+  if (!aReader.IsOk || aPathSize > theSize - aReader.Offset)
+  {
+    return false;
+  }
+  myModelPath.assign(reinterpret_cast<const char*>(theData + aReader.Offset), aPathSize);
+  aReader.Offset += aPathSize;
+
+  const uint32_t aNbEvents = aReader.uint32();
+  uint64_t       aMicros   = 0;
+  myEvents.reserve(std::min<size_t>(aNbEvents, theSize / 13));
+  for (uint32_t anEventIter = 0; anEventIter < aNbEvents && aReader.IsOk; ++anEventIter)
+  {
+    Event         anEvent;
+    const uint8_t aType = aReader.byte();
+    if (aType >= EventType_NB)
+    {
+      return false;
+    }
+    aMicros += aReader.uint32();
+
+    anEvent.Type         = static_cast<EventType>(aType);
+    anEvent.Time         = double(aMicros) * 1.0e-6;
+    anEvent.Position.x() = aReader.int32();
+    anEvent.Position.y() = aReader.int32();
+    if (anEvent.Type == EventType_MouseButton)
+    {
+      anEvent.Button = aReader.byte();
+      anEvent.Action = aReader.byte();
+      anEvent.Mods   = aReader.byte();
+    }
+    else if (anEvent.Type == EventType_Scroll)
+    {
+      const uint32_t aBits  = aReader.uint32();
+      float          aDelta = 0.0f;
+      std::memcpy(&aDelta, &aBits, sizeof(aDelta));
+      anEvent.ScrollDelta = aDelta;
+    }
+    myEvents.push_back(anEvent);
+  }
+  if (!aReader.IsOk)
+  {
+    myEvents.clear();
+    return false;
+  }
+  return true;
+}
+
+// ================================================================
+// Function : write
+// Purpose  :
+// ================================================================
+bool OccImguiInputRecording::write(const std::string& thePath) const
+{
+  std::vector<uint8_t> aData;
+  encode(aData);
+  std::ofstream aFile(thePath, std::ios::binary);
+  aFile.write(reinterpret_cast<const char*>(aData.data()),
+              static_cast<std::streamsize>(aData.size()));
+  return aFile.good();
+}
+
+// ================================================================
+// Function : read
+// Purpose  :
+// ================================================================
+bool OccImguiInputRecording::read(const std::string& thePath)
+{
+  std::ifstream aFile(thePath, std::ios::binary);
+  if (!aFile)
+  {
+    return false;
+  }
+  const std::vector<uint8_t> aData((std::istreambuf_iterator<char>(aFile)),
+                                   std::istreambuf_iterator<char>());
+  return decode(aData.data(), aData.size());
+}
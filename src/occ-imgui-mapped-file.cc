@@ -0,0 +1,112 @@
+#include "occ_imgui/occ-imgui-mapped-file.h"
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+// ================================================================
+// Function : open
+// Purpose  :
+// ================================================================
+bool OccImguiMappedFile::open(const std::filesystem::path& thePath)
+{
+  close();
+#if defined(_WIN32)
+  HANDLE aFile = CreateFileW(thePath.c_str(),
+                             GENERIC_READ,
+                             FILE_SHARE_READ,
+                             nullptr,
+                             OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                             nullptr);
+  if (aFile == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER aSize;
+  if (!GetFileSizeEx(aFile, &aSize) || aSize.QuadPart == 0)
+  {
+    CloseHandle(aFile);
+    return false;
+  }
+
+  HANDLE aMapping = CreateFileMappingW(aFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (aMapping == nullptr)
+  {
+    CloseHandle(aFile);
+    return false;
+  }
+
+  void* aData = MapViewOfFile(aMapping, FILE_MAP_READ, 0, 0, 0);
+  if (aData == nullptr)
+  {
+    CloseHandle(aMapping);
+    CloseHandle(aFile);
+    return false;
+  }
+
+  myFile    = aFile;
+  myMapping = aMapping;
+  myData    = static_cast<const uint8_t*>(aData);
+  mySize    = static_cast<size_t>(aSize.QuadPart);
+#else
+  const int aFile = ::open(thePath.c_str(), O_RDONLY);
+  if (aFile < 0)
+  {
+    return false;
+  }
+
+  struct stat aStat;
+  if (::fstat(aFile, &aStat) != 0 || aStat.st_size <= 0)
+  {
+    ::close(aFile);
+    return false;
+  }
+
+  const size_t aSize = static_cast<size_t>(aStat.st_size);
+  void*        aData = ::mmap(nullptr, aSize, PROT_READ, MAP_PRIVATE, aFile, 0);
+  // the mapping stays valid after the descriptor is closed
+  ::close(aFile);
+  if (aData == MAP_FAILED)
+  {
+    return false;
+  }
+
+  myData = static_cast<const uint8_t*>(aData);
+  mySize = aSize;
+#endif
+  return true;
+}
+
+// ================================================================
+// Function : close
+// Purpose  :
+// ================================================================
+void OccImguiMappedFile::close()
+{
+  if (myData == nullptr)
+  {
+    return;
+  }
+
+#if defined(_WIN32)
+  UnmapViewOfFile(myData);
+  CloseHandle(static_cast<HANDLE>(myMapping));
+  CloseHandle(static_cast<HANDLE>(myFile));
+  myMapping = nullptr;
+  myFile    = nullptr;
+#else
+  ::munmap(const_cast<uint8_t*>(myData), mySize);
+#endif
+  myData = nullptr;
+  mySize = 0;
+}
@@ -0,0 +1,351 @@
+#include "occ_imgui/occ-imgui-memory-budget.h"
+
+#include "occ_imgui/occ-imgui-scene-lod.h"
+
+#include <opencascade/AIS_ConnectedInteractive.hxx>
+#include <opencascade/Graphic3d_Camera.hxx>
+#include <opencascade/OpenGl_Group.hxx>
+#include <opencascade/OSD_MemInfo.hxx>
+#include <opencascade/PrsMgr_Presentation.hxx>
+#include <opencascade/Standard.hxx>
+
+#include <algorithm>
+#include <cfloat>
+#include <unordered_map>
+
+namespace
+{
+//! Interval between periodic accountings in seconds.
+constexpr double THE_MEMORY_ACCOUNT_INTERVAL = 1.0;
+
+//! Shapes within this factor of the view size count as visible,
+//! so that they are rebuilt slightly before they enter the view.
+constexpr double THE_MEMORY_VIEW_MARGIN = 1.25;
+
+//! Eviction stops once the total drops below this fraction of the budget,
+//! so that shapes are not evicted again right after being restored.
+constexpr double THE_MEMORY_HYSTERESIS = 0.9;
+
+//! Return the shape whose presentations are drawn for the object: the shape itself
+//! or the prototype of an instance.
+Handle(AIS_Shape) memoryShape(const Handle(AIS_InteractiveObject)& theObject)
+{
+  if (const Handle(AIS_ConnectedInteractive) anInstance =
+        Handle(AIS_ConnectedInteractive)::DownCast(theObject);
+      !anInstance.IsNull())
+  {
+    return Handle(AIS_Shape)::DownCast(anInstance->ConnectedTo());
+  }
+  return Handle(AIS_Shape)::DownCast(theObject);
+}
+} // namespace
+
+// ================================================================
+// Function : presentationSize
+// Purpose  :
+// ================================================================
+size_t OccImguiMemoryBudget::presentationSize(const Handle(PrsMgr_PresentableObject)& theObject)
+{
+  size_t aSize = 0;
+  for (const Handle(PrsMgr_Presentation)& aPrs : theObject->Presentations())
+  {
+    for (const Handle(Graphic3d_Group)& aGroup : aPrs->Groups())
+    {
+      const Handle(OpenGl_Group) aGlGroup = Handle(OpenGl_Group)::DownCast(aGroup);
+      if (aGlGroup.IsNull())
+      {
+        continue;
+      }
+      for (const OpenGl_ElementNode* aNode = aGlGroup->FirstNode(); aNode != nullptr;)
+      {
+        aSize += aNode->elem->EstimatedDataSize();
+        aNode = aNode->next;
+      }
+    }
+  }
+  return aSize;
+}
+
+// ================================================================
+// Function : isInView
+// Purpose  :
+// ================================================================
+bool OccImguiMemoryBudget::isInView(const Bnd_Box&          theBox,
+                                    const Handle(V3d_View)& theView,
+                                    const double            theMargin)
+{
+  if (theBox.IsVoid())
+  {
+    return true;
+  }
+
+  const Handle(Graphic3d_Camera)& aCamera = theView->Camera();
+  const gp_Pnt                    anEye   = aCamera->Eye();
+  const gp_Vec                    aDir(aCamera->Direction());
+  const gp_Pnt                    aMin = theBox.CornerMin();
+  const gp_Pnt                    aMax = theBox.CornerMax();
+  double                          aProjMin[2] = {DBL_MAX, DBL_MAX};
+  double                          aProjMax[2] = {-DBL_MAX, -DBL_MAX};
+  for (int aCornerIter = 0; aCornerIter < 8; ++aCornerIter)
+  {
+    const gp_Pnt aCorner((aCornerIter & 1) != 0 ? aMax.X() : aMin.X(),
+                         (aCornerIter & 2) != 0 ? aMax.Y() : aMin.Y(),
+                         (aCornerIter & 4) != 0 ? aMax.Z() : aMin.Z());
+    if (!aCamera->IsOrthographic() && gp_Vec(anEye, aCorner).Dot(aDir) <= 0.0)
+    {
+      // the perspective projection is not defined behind the eye
+      return true;
+    }
+
+    const gp_Pnt aProj = aCamera->Project(aCorner);
+    aProjMin[0]        = std::min(aProjMin[0], aProj.X());
+    aProjMin[1]        = std::min(aProjMin[1], aProj.Y());
+    aProjMax[0]        = std::max(aProjMax[0], aProj.X());
+    aProjMax[1]        = std::max(aProjMax[1], aProj.Y());
+  }
+  return aProjMax[0] >= -theMargin && aProjMin[0] <= theMargin && aProjMax[1] >= -theMargin
+         && aProjMin[1] <= theMargin;
+}
+
+// ================================================================
+// Function : update
+// Purpose  :
+// ================================================================
+bool OccImguiMemoryBudget::update(const Handle(AIS_InteractiveContext)& theCtx,
+                                  const std::vector<Handle(V3d_View)>&  theViews,
+                                  OccImguiMeshLodCache&                 theMeshCache,
+                                  const Handle(OpenGl_Context)&         theGlCtx,
+                                  const double                          theTime,
+                                  const double                          theInterval,
+                                  std::vector<Handle(AIS_Shape)>&       theRestored)
+{
+  bool isCameraChanged = myCameraStates.size() != theViews.size();
+  myCameraStates.resize(theViews.size());
+  for (size_t aViewIter = 0; aViewIter < theViews.size(); ++aViewIter)
+  {
+    const Graphic3d_WorldViewProjState& aState =
+      theViews[aViewIter]->Camera()->WorldViewProjState();
+    if (!myCameraStates[aViewIter].IsValid() || myCameraStates[aViewIter] != aState)
+    {
+      myCameraStates[aViewIter] = aState;
+      isCameraChanged           = true;
+    }
+  }
+
+  // evicted shapes entering a view are restored as soon as possible
+  const double anInterval = isCameraChanged && !myEvicted.empty() ? theInterval
+                                                                   : THE_MEMORY_ACCOUNT_INTERVAL;
+  if (!myToUpdate && myUpdateTime >= 0.0 && theTime - myUpdateTime < anInterval)
+  {
+    return false;
+  }
+  myToUpdate   = false;
+  myUpdateTime = theTime;
+
+  account(theCtx, theViews, theMeshCache, theGlCtx);
+  for (ShapeMemory& aShape : myShapes)
+  {
+    if (aShape.IsEvicted && (aShape.IsVisible || !myIsEnabled))
+    {
+      aShape.IsEvicted = false;
+      myEvicted.erase(aShape.Shape.get());
+      theRestored.push_back(aShape.Shape);
+    }
+  }
+
+  size_t aTotal = myStats.GpuBytes + myStats.MeshBytes;
+  if (!myIsEnabled || aTotal <= myBudget)
+  {
+    myStats.NbEvicted = myEvicted.size();
+    return false;
+  }
+
+  // hidden shapes go first, then off-screen ones; the largest ones within each group
+  std::vector<ShapeMemory*> aCandidates;
+  for (ShapeMemory& aShape : myShapes)
+  {
+    if (!aShape.IsVisible && !aShape.IsEvicted)
+    {
+      aCandidates.push_back(&aShape);
+    }
+  }
+  std::stable_sort(aCandidates.begin(),
+                   aCandidates.end(),
+                   [](const ShapeMemory* theLeft, const ShapeMemory* theRight) {
+                     return theLeft->IsHidden && !theRight->IsHidden;
+                   });
+
+  const size_t aTarget =
+    static_cast<size_t>(static_cast<double>(myBudget) * THE_MEMORY_HYSTERESIS);
+  bool isEvicted = false;
+  for (ShapeMemory* aShape : aCandidates)
+  {
+    if (aTotal <= aTarget)
+    {
+      break;
+    }
+
+    const size_t aSizeBefore = aShape->GpuBytes + aShape->MeshBytes;
+    evict(*aShape, theMeshCache);
+    const size_t aSizeAfter = aShape->GpuBytes + aShape->MeshBytes;
+    aTotal -= std::min(aTotal, aSizeBefore > aSizeAfter ? aSizeBefore - aSizeAfter : 0);
+    isEvicted = true;
+  }
+  if (isEvicted)
+  {
+    // return blocks released by triangulations to the system when the optimized allocator is used
+    Standard::Purge();
+    myStats.GpuBytes = 0;
+    for (const ShapeMemory& aShape : myShapes)
+    {
+      myStats.GpuBytes += aShape.GpuBytes;
+    }
+    myStats.MeshBytes = meshBytes(theMeshCache);
+  }
+  myStats.NbEvicted = myEvicted.size();
+  return isEvicted;
+}
+
+// ================================================================
+// Function : account
+// Purpose  :
+// ================================================================
+void OccImguiMemoryBudget::account(const Handle(AIS_InteractiveContext)& theCtx,
+                                   const std::vector<Handle(V3d_View)>&  theViews,
+                                   const OccImguiMeshLodCache&           theMeshCache,
+                                   const Handle(OpenGl_Context)&         theGlCtx)
+{
+  myShapes.clear();
+  std::unordered_map<const AIS_Shape*, size_t> aShapeIndices;
+  auto addShape = [&](const Handle(AIS_Shape)& theShape) -> ShapeMemory& {
+    const auto anIter = aShapeIndices.emplace(theShape.get(), myShapes.size());
+    if (anIter.second)
+    {
+      ShapeMemory aShape;
+      aShape.Shape = theShape;
+      myShapes.push_back(aShape);
+    }
+    return myShapes[anIter.first->second];
+  };
+
+  AIS_ListOfInteractive aDisplayed;
+  theCtx->DisplayedObjects(aDisplayed);
+  for (const Handle(AIS_InteractiveObject)& anObject : aDisplayed)
+  {
+    const Handle(AIS_Shape) aShapePrs = memoryShape(anObject);
+    if (aShapePrs.IsNull())
+    {
+      continue;
+    }
+
+    ShapeMemory& aShape = addShape(aShapePrs);
+    aShape.IsHidden     = false;
+    Bnd_Box aBox;
+    if (aShape.IsVisible || !OccImguiSceneLod::boundingBox(anObject, aBox))
+    {
+      continue;
+    }
+    for (const Handle(V3d_View)& aView : theViews)
+    {
+      if (isInView(aBox, aView, THE_MEMORY_VIEW_MARGIN))
+      {
+        aShape.IsVisible = true;
+        break;
+      }
+    }
+  }
+
+  AIS_ListOfInteractive anErased;
+  theCtx->ErasedObjects(anErased);
+  for (const Handle(AIS_InteractiveObject)& anObject : anErased)
+  {
+    if (const Handle(AIS_Shape) aShapePrs = memoryShape(anObject); !aShapePrs.IsNull())
+    {
+      addShape(aShapePrs);
+    }
+  }
+
+  // forget evicted shapes removed from the context meanwhile
+  std::unordered_set<const AIS_Shape*> anEvicted;
+  myStats.GpuBytes = 0;
+  for (ShapeMemory& aShape : myShapes)
+  {
+    aShape.GpuBytes  = presentationSize(aShape.Shape);
+    aShape.MeshBytes = theMeshCache.memorySize(aShape.Shape->Shape());
+    aShape.IsEvicted = myEvicted.count(aShape.Shape.get()) != 0;
+    if (aShape.IsEvicted)
+    {
+      anEvicted.insert(aShape.Shape.get());
+    }
+    myStats.GpuBytes += aShape.GpuBytes;
+  }
+  myEvicted.swap(anEvicted);
+  std::sort(myShapes.begin(),
+            myShapes.end(),
+            [](const ShapeMemory& theLeft, const ShapeMemory& theRight) {
+              return theLeft.GpuBytes + theLeft.MeshBytes > theRight.GpuBytes + theRight.MeshBytes;
+            });
+  // cache entries not reachable from the context cannot be released by eviction,
+  // so they do not count against the budget
+  myStats.MeshBytes = meshBytes(theMeshCache);
+
+  OSD_MemInfo aMemInfo(false);
+  aMemInfo.SetActive(OSD_MemInfo::MemHeapUsage, true);
+  aMemInfo.SetActive(OSD_MemInfo::MemWorkingSet, true);
+  aMemInfo.Update();
+  myStats.HeapBytes       = aMemInfo.Value(OSD_MemInfo::MemHeapUsage);
+  myStats.WorkingSetBytes = aMemInfo.Value(OSD_MemInfo::MemWorkingSet);
+  if (!theGlCtx.IsNull())
+  {
+    myStats.GpuFreeBytes = theGlCtx->AvailableMemory();
+    myGpuInfo            = theGlCtx->MemoryInfo();
+  }
+}
+
+// ================================================================
+// Function : evict
+// Purpose  :
+// ================================================================
+void OccImguiMemoryBudget::evict(ShapeMemory& theShape, OccImguiMeshLodCache& theMeshCache)
+{
+  // emptied presentations release their buffers and are recomputed by the next Display()
+  // or Redisplay() of the shape, as they are flagged for update
+  for (const Handle(PrsMgr_Presentation)& aPrs : theShape.Shape->Presentations())
+  {
+    aPrs->Clear();
+  }
+  theShape.Shape->SetToUpdate();
+
+  const TopoDS_Shape& aTopo = theShape.Shape->Shape();
+  if (theMeshCache.hasLevel(aTopo, OccImguiMeshLodCache::Level_Coarse))
+  {
+    theMeshCache.activate(aTopo, OccImguiMeshLodCache::Level_Coarse);
+  }
+  theMeshCache.release(aTopo, OccImguiMeshLodCache::Level_Coarse);
+
+  theShape.GpuBytes  = 0;
+  theShape.MeshBytes = theMeshCache.memorySize(aTopo);
+  theShape.IsEvicted = true;
+  myEvicted.insert(theShape.Shape.get());
+  ++myStats.NbEvictions;
+}
+
+// ================================================================
+// Function : meshBytes
+// Purpose  :
+// ================================================================
+size_t OccImguiMemoryBudget::meshBytes(const OccImguiMeshLodCache& theMeshCache) const
+{
+  // shapes sharing a TShape share the cache entry
+  std::unordered_set<const TopoDS_TShape*> aCounted;
+  size_t                                   aSize = 0;
+  for (const ShapeMemory& aShape : myShapes)
+  {
+    const TopoDS_Shape& aTopo = aShape.Shape->Shape();
+    if (aCounted.insert(aTopo.TShape().get()).second)
+    {
+      aSize += theMeshCache.memorySize(aTopo);
+    }
+  }
+  return aSize;
+}
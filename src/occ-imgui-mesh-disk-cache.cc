@@ -0,0 +1,527 @@
+#include "occ_imgui/occ-imgui-mesh-disk-cache.h"
+
+#include "occ_imgui/occ-imgui-mapped-file.h"
+
+#include <opencascade/BRepTools.hxx>
+#include <opencascade/OSD_Environment.hxx>
+#include <opencascade/OSD_Process.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+
+namespace
+{
+//! File signature.
+constexpr char THE_MESH_CACHE_MAGIC[8] = {'O', 'C', 'C', 'I', 'M', 'E', 'S', 'H'};
+
+//! File format version; bump on any layout change.
+constexpr uint32_t THE_MESH_CACHE_VERSION = 1;
+
+//! File extension of cache entries.
+constexpr const char* THE_MESH_CACHE_EXT = ".mesh";
+
+//! Fraction of the size limit the cache is trimmed to on eviction.
+constexpr double THE_MESH_CACHE_TRIM_RATIO = 0.9;
+
+//! Per-face data flags.
+enum MeshCacheFlags : uint32_t
+{
+  MeshCacheFlags_Normals = 0x01,
+  MeshCacheFlags_UVNodes = 0x02
+};
+
+//! File header.
+struct MeshCacheHeader
+{
+  char     Magic[8];
+  uint32_t Version;
+  uint32_t NbFaces;
+};
+
+//! Face record; the header is followed by one record per face and then by face data:
+//! float nodes[3 * NbNodes], float normals[3 * NbNodes], float uv[2 * NbNodes],
+//! int32 triangles[3 * NbTriangles], where normals and UV nodes are optional.
+struct MeshCacheFace
+{
+  uint32_t NbNodes;
+  uint32_t NbTriangles;
+  uint32_t Flags;
+  uint32_t Reserved;
+  double   Deflection;
+};
+
+static_assert(sizeof(MeshCacheHeader) == 16, "unexpected padding in MeshCacheHeader");
+static_assert(sizeof(MeshCacheFace) == 24, "unexpected padding in MeshCacheFace");
+
+//! Stream buffer computing 64-bit FNV-1a hash of the written data without storing it.
+class MeshCacheHashBuffer : public std::streambuf
+{
+public:
+  //! Main constructor; theSeed continues a hash computed before.
+  explicit MeshCacheHashBuffer(const uint64_t theSeed = 14695981039346656037ULL)
+      : myHash(theSeed)
+  {
+  }
+
+  //! Return hash of the data written so far.
+  uint64_t hash() const { return myHash; }
+
+protected:
+  int_type overflow(const int_type theChar) override
+  {
+    if (!traits_type::eq_int_type(theChar, traits_type::eof()))
+    {
+      add(traits_type::to_char_type(theChar));
+    }
+    return traits_type::not_eof(theChar);
+  }
+
+  std::streamsize xsputn(const char* theData, const std::streamsize theSize) override
+  {
+    for (std::streamsize aCharIter = 0; aCharIter < theSize; ++aCharIter)
+    {
+      add(theData[aCharIter]);
+    }
+    return theSize;
+  }
+
+private:
+  void add(const char theChar)
+  {
+    myHash ^= static_cast<uint8_t>(theChar);
+    myHash *= 1099511628211ULL;
+  }
+
+private:
+  uint64_t myHash;
+};
+
+//! Append raw bytes of the value to the buffer.
+template <typename T>
+void appendMeshCacheValue(std::vector<uint8_t>& theBuffer, const T& theValue)
+{
+  const uint8_t* aBytes = reinterpret_cast<const uint8_t*>(&theValue);
+  theBuffer.insert(theBuffer.end(), aBytes, aBytes + sizeof(T));
+}
+
+//! Read value from the mapped data advancing the offset.
+template <typename T>
+T readMeshCacheValue(const uint8_t* theData, size_t& theOffset)
+{
+  T aValue;
+  std::memcpy(&aValue, theData + theOffset, sizeof(T));
+  theOffset += sizeof(T);
+  return aValue;
+}
+
+//! Return number of data bytes of the face record.
+size_t meshCacheFaceDataSize(const MeshCacheFace& theFace)
+{
+  size_t aSize = size_t(theFace.NbNodes) * 3 * sizeof(float)
+                 + size_t(theFace.NbTriangles) * 3 * sizeof(int32_t);
+  if ((theFace.Flags & MeshCacheFlags_Normals) != 0)
+  {
+    aSize += size_t(theFace.NbNodes) * 3 * sizeof(float);
+  }
+  if ((theFace.Flags & MeshCacheFlags_UVNodes) != 0)
+  {
+    aSize += size_t(theFace.NbNodes) * 2 * sizeof(float);
+  }
+  return aSize;
+}
+} // namespace
+
+// ================================================================
+// Function : defaultDirectory
+// Purpose  :
+// ================================================================
+std::filesystem::path OccImguiMeshDiskCache::defaultDirectory()
+{
+  const TCollection_AsciiString aDir = OSD_Environment("OCC_IMGUI_MESH_CACHE_DIR").Value();
+  if (!aDir.IsEmpty())
+  {
+    return std::filesystem::u8path(aDir.ToCString());
+  }
+
+  std::error_code anError;
+  return std::filesystem::temp_directory_path(anError) / "occ-imgui" / "mesh-cache";
+}
+
+// ================================================================
+// Function : defaultSizeLimit
+// Purpose  :
+// ================================================================
+uint64_t OccImguiMeshDiskCache::defaultSizeLimit()
+{
+  const TCollection_AsciiString aSizeMb = OSD_Environment("OCC_IMGUI_MESH_CACHE_SIZE_MB").Value();
+  const uint64_t                aLimitMb =
+    aSizeMb.IsIntegerValue() ? static_cast<uint64_t>(std::max(aSizeMb.IntegerValue(), 0)) : 2048;
+  return aLimitMb * 1024 * 1024;
+}
+
+// ================================================================
+// Function : shapeKey
+// Purpose  :
+// ================================================================
+uint64_t OccImguiMeshDiskCache::shapeKey(const TopoDS_Shape& theShape)
+{
+  MeshCacheHashBuffer aBuffer;
+  std::ostream        aStream(&aBuffer);
+  BRepTools::Write(theShape.Located(TopLoc_Location()),
+                   aStream,
+                   Standard_False,
+                   Standard_False,
+                   TopTools_FormatVersion_CURRENT);
+  aStream.flush();
+  return aBuffer.hash();
+}
+
+// ================================================================
+// Function : levelKey
+// Purpose  :
+// ================================================================
+uint64_t OccImguiMeshDiskCache::levelKey(const uint64_t theShapeKey,
+                                         const double   theDeflection,
+                                         const double   theAngle)
+{
+  MeshCacheHashBuffer aBuffer(theShapeKey);
+  std::ostream        aStream(&aBuffer);
+
+  // deflection is derived from the bounding box of the located shape,
+  // so round it to let instances of the same part share the entry
+  aStream << "\n" << THE_MESH_CACHE_VERSION << std::setprecision(6) << " " << theDeflection << " "
+          << theAngle;
+  aStream.flush();
+  return aBuffer.hash();
+}
+
+// ================================================================
+// Function : OccImguiMeshDiskCache
+// Purpose  :
+// ================================================================
+OccImguiMeshDiskCache::OccImguiMeshDiskCache(const std::filesystem::path& theDirectory,
+                                             const uint64_t               theSizeLimit)
+    : myDirectory(theDirectory),
+      mySizeLimit(theSizeLimit)
+{
+  std::error_code anError;
+  std::filesystem::create_directories(myDirectory, anError);
+  evict();
+}
+
+// ================================================================
+// Function : entryPath
+// Purpose  :
+// ================================================================
+std::filesystem::path OccImguiMeshDiskCache::entryPath(const uint64_t theKey) const
+{
+  std::ostringstream aName;
+  aName << std::hex << std::setw(16) << std::setfill('0') << theKey << THE_MESH_CACHE_EXT;
+  return myDirectory / aName.str();
+}
+
+// ================================================================
+// Function : load
+// Purpose  :
+// ================================================================
+bool OccImguiMeshDiskCache::load(const uint64_t                           theKey,
+                                 const size_t                             theNbFaces,
+                                 std::vector<Handle(Poly_Triangulation)>& theTriangulations)
+{
+  const std::filesystem::path aPath = entryPath(theKey);
+  OccImguiMappedFile          aFile;
+  if (!aFile.open(aPath))
+  {
+    ++myNbMisses;
+    return false;
+  }
+
+  const uint8_t* aData    = aFile.data();
+  size_t         anOffset = 0;
+  if (aFile.size() < sizeof(MeshCacheHeader))
+  {
+    ++myNbMisses;
+    return false;
+  }
+
+  const MeshCacheHeader aHeader = readMeshCacheValue<MeshCacheHeader>(aData, anOffset);
+  if (std::memcmp(aHeader.Magic, THE_MESH_CACHE_MAGIC, sizeof(THE_MESH_CACHE_MAGIC)) != 0
+      || aHeader.Version != THE_MESH_CACHE_VERSION || aHeader.NbFaces != theNbFaces
+      || aFile.size() < anOffset + size_t(aHeader.NbFaces) * sizeof(MeshCacheFace))
+  {
+    ++myNbMisses;
+    return false;
+  }
+
+  std::vector<MeshCacheFace> aFaces(aHeader.NbFaces);
+  for (MeshCacheFace& aFace : aFaces)
+  {
+    aFace = readMeshCacheValue<MeshCacheFace>(aData, anOffset);
+  }
+
+  std::vector<Handle(Poly_Triangulation)> aTriangulations(aFaces.size());
+  for (size_t aFaceIter = 0; aFaceIter < aFaces.size(); ++aFaceIter)
+  {
+    const MeshCacheFace& aFace = aFaces[aFaceIter];
+    if (aFile.size() < anOffset + meshCacheFaceDataSize(aFace))
+    {
+      ++myNbMisses;
+      return false;
+    }
+    if (aFace.NbNodes == 0)
+    {
+      continue;
+    }
+
+    const int aNbNodes = static_cast<int>(aFace.NbNodes);
+    const int aNbTris  = static_cast<int>(aFace.NbTriangles);
+
+    // single precision matches the file and halves memory of the nodes
+    Handle(Poly_Triangulation) aTri = new Poly_Triangulation();
+    aTri->SetDoublePrecision(false);
+    aTri->ResizeNodes(aNbNodes, false);
+    aTri->ResizeTriangles(aNbTris, false);
+    aTri->Deflection(aFace.Deflection);
+    for (int aNodeIter = 1; aNodeIter <= aNbNodes; ++aNodeIter)
+    {
+      const float aX = readMeshCacheValue<float>(aData, anOffset);
+      const float aY = readMeshCacheValue<float>(aData, anOffset);
+      const float aZ = readMeshCacheValue<float>(aData, anOffset);
+      aTri->SetNode(aNodeIter, gp_Pnt(aX, aY, aZ));
+    }
+    if ((aFace.Flags & MeshCacheFlags_Normals) != 0)
+    {
+      aTri->AddNormals();
+      for (int aNodeIter = 1; aNodeIter <= aNbNodes; ++aNodeIter)
+      {
+        const float aX = readMeshCacheValue<float>(aData, anOffset);
+        const float aY = readMeshCacheValue<float>(aData, anOffset);
+        const float aZ = readMeshCacheValue<float>(aData, anOffset);
+        aTri->SetNormal(aNodeIter, gp_Vec3f(aX, aY, aZ));
+      }
+    }
+    if ((aFace.Flags & MeshCacheFlags_UVNodes) != 0)
+    {
+      aTri->AddUVNodes();
+      for (int aNodeIter = 1; aNodeIter <= aNbNodes; ++aNodeIter)
+      {
+        const float aU = readMeshCacheValue<float>(aData, anOffset);
+        const float aV = readMeshCacheValue<float>(aData, anOffset);
+        aTri->SetUVNode(aNodeIter, gp_Pnt2d(aU, aV));
+      }
+    }
+    for (int aTriIter = 1; aTriIter <= aNbTris; ++aTriIter)
+    {
+      const int32_t aN1 = readMeshCacheValue<int32_t>(aData, anOffset);
+      const int32_t aN2 = readMeshCacheValue<int32_t>(aData, anOffset);
+      const int32_t aN3 = readMeshCacheValue<int32_t>(aData, anOffset);
+      if (aN1 < 1 || aN1 > aNbNodes || aN2 < 1 || aN2 > aNbNodes || aN3 < 1 || aN3 > aNbNodes)
+      {
+        // a corrupted entry would make presentations read nodes out of bounds
+        ++myNbMisses;
+        return false;
+      }
+      aTri->SetTriangle(aTriIter, Poly_Triangle(aN1, aN2, aN3));
+    }
+    aTriangulations[aFaceIter] = aTri;
+  }
+
+  // touch the entry to keep it from LRU eviction
+  std::error_code anError;
+  std::filesystem::last_write_time(aPath, std::filesystem::file_time_type::clock::now(), anError);
+
+  theTriangulations = std::move(aTriangulations);
+  ++myNbHits;
+  return true;
+}
+
+// ================================================================
+// Function : store
+// Purpose  :
+// ================================================================
+void OccImguiMeshDiskCache::store(const uint64_t                                 theKey,
+                                  const std::vector<Handle(Poly_Triangulation)>& theTriangulations)
+{
+  MeshCacheHeader aHeader;
+  std::memcpy(aHeader.Magic, THE_MESH_CACHE_MAGIC, sizeof(THE_MESH_CACHE_MAGIC));
+  aHeader.Version = THE_MESH_CACHE_VERSION;
+  aHeader.NbFaces = static_cast<uint32_t>(theTriangulations.size());
+
+  std::vector<uint8_t> aBuffer;
+  appendMeshCacheValue(aBuffer, aHeader);
+  for (const Handle(Poly_Triangulation)& aTri : theTriangulations)
+  {
+    MeshCacheFace aFace{};
+    if (!aTri.IsNull())
+    {
+      aFace.NbNodes     = static_cast<uint32_t>(aTri->NbNodes());
+      aFace.NbTriangles = static_cast<uint32_t>(aTri->NbTriangles());
+      aFace.Flags       = (aTri->HasNormals() ? MeshCacheFlags_Normals : 0u)
+                    | (aTri->HasUVNodes() ? MeshCacheFlags_UVNodes : 0u);
+      aFace.Deflection = aTri->Deflection();
+    }
+    appendMeshCacheValue(aBuffer, aFace);
+  }
+
+  for (const Handle(Poly_Triangulation)& aTri : theTriangulations)
+  {
+    if (aTri.IsNull())
+    {
+      continue;
+    }
+
+    const int aNbNodes = aTri->NbNodes();
+    for (int aNodeIter = 1; aNodeIter <= aNbNodes; ++aNodeIter)
+    {
+      const gp_Pnt aNode = aTri->Node(aNodeIter);
+      appendMeshCacheValue(aBuffer, static_cast<float>(aNode.X()));
+      appendMeshCacheValue(aBuffer, static_cast<float>(aNode.Y()));
+      appendMeshCacheValue(aBuffer, static_cast<float>(aNode.Z()));
+    }
+    if (aTri->HasNormals())
+    {
+      for (int aNodeIter = 1; aNodeIter <= aNbNodes; ++aNodeIter)
+      {
+        gp_Vec3f aNorm;
+        aTri->Normal(aNodeIter, aNorm);
+        appendMeshCacheValue(aBuffer, aNorm);
+      }
+    }
+    if (aTri->HasUVNodes())
+    {
+      for (int aNodeIter = 1; aNodeIter <= aNbNodes; ++aNodeIter)
+      {
+        const gp_Pnt2d aUV = aTri->UVNode(aNodeIter);
+        appendMeshCacheValue(aBuffer, static_cast<float>(aUV.X()));
+        appendMeshCacheValue(aBuffer, static_cast<float>(aUV.Y()));
+      }
+    }
+    for (int aTriIter = 1; aTriIter <= aTri->NbTriangles(); ++aTriIter)
+    {
+      int aN1 = 0, aN2 = 0, aN3 = 0;
+      aTri->Triangle(aTriIter).Get(aN1, aN2, aN3);
+      appendMeshCacheValue(aBuffer, static_cast<int32_t>(aN1));
+      appendMeshCacheValue(aBuffer, static_cast<int32_t>(aN2));
+      appendMeshCacheValue(aBuffer, static_cast<int32_t>(aN3));
+    }
+  }
+
+  // write into a temporary file first, so that readers never map a partially written entry;
+  // the name is unique per process and thread, as batch workers share the cache directory
+  const std::filesystem::path aPath = entryPath(theKey);
+  std::filesystem::path       aTmpPath(aPath);
+  aTmpPath += ".tmp" + std::to_string(OSD_Process().ProcessId()) + "-"
+              + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream aStream(aTmpPath, std::ios::binary | std::ios::trunc);
+    aStream.write(reinterpret_cast<const char*>(aBuffer.data()),
+                  static_cast<std::streamsize>(aBuffer.size()));
+    if (!aStream)
+    {
+      aStream.close();
+      std::error_code anError;
+      std::filesystem::remove(aTmpPath, anError);
+      return;
+    }
+  }
+
+  // an existing entry of the same key is replaced, so its size no longer counts
+  std::error_code anError;
+  const uint64_t  anOldSize     = std::filesystem::file_size(aPath, anError);
+  const uint64_t  aReplacedSize = anError ? 0 : anOldSize;
+  std::filesystem::rename(aTmpPath, aPath, anError);
+  if (anError)
+  {
+    std::filesystem::remove(aTmpPath, anError);
+    return;
+  }
+
+  mySize += aBuffer.size();
+  mySize -= std::min<uint64_t>(aReplacedSize, mySize);
+  if (mySize > mySizeLimit)
+  {
+    evict();
+  }
+}
+
+// ================================================================
+// Function : clear
+// Purpose  :
+// ================================================================
+void OccImguiMeshDiskCache::clear()
+{
+  std::lock_guard<std::mutex> aLock(myEvictMutex);
+  std::error_code             anError;
+  for (const auto& anEntry : std::filesystem::directory_iterator(myDirectory, anError))
+  {
+    if (anEntry.path().extension() == THE_MESH_CACHE_EXT)
+    {
+      std::filesystem::remove(anEntry.path(), anError);
+    }
+  }
+  mySize = 0;
+}
+
+// ================================================================
+// Function : evict
+// Purpose  :
+// ================================================================
+void OccImguiMeshDiskCache::evict()
+{
+  std::lock_guard<std::mutex> aLock(myEvictMutex);
+
+  struct CacheFile
+  {
+    std::filesystem::path           Path;
+    std::filesystem::file_time_type Time;
+    uint64_t                        Size = 0;
+  };
+
+  std::vector<CacheFile> aFiles;
+  uint64_t               aTotalSize = 0;
+  std::error_code        anError;
+  for (const auto& anEntry : std::filesystem::directory_iterator(myDirectory, anError))
+  {
+    if (anEntry.path().extension() != THE_MESH_CACHE_EXT)
+    {
+      continue;
+    }
+
+    CacheFile aFile;
+    aFile.Path = anEntry.path();
+    aFile.Time = anEntry.last_write_time(anError);
+    aFile.Size = anEntry.file_size(anError);
+    aTotalSize += aFile.Size;
+    aFiles.push_back(aFile);
+  }
+
+  if (aTotalSize > mySizeLimit)
+  {
+    // least recently used entries first
+    std::sort(aFiles.begin(),
+              aFiles.end(),
+              [](const CacheFile& theLeft, const CacheFile& theRight) {
+                return theLeft.Time < theRight.Time;
+              });
+
+    const uint64_t aTarget =
+      static_cast<uint64_t>(static_cast<double>(mySizeLimit) * THE_MESH_CACHE_TRIM_RATIO);
+    for (const CacheFile& aFile : aFiles)
+    {
+      if (aTotalSize <= aTarget)
+      {
+        break;
+      }
+      if (std::filesystem::remove(aFile.Path, anError))
+      {
+        aTotalSize -= aFile.Size;
+      }
+    }
+  }
+  mySize = aTotalSize;
+}
@@ -0,0 +1,529 @@
+#include "occ_imgui/occ-imgui-mesh-lod-cache.h"
+
+#include <opencascade/BRep_Builder.hxx>
+#include <opencascade/BRep_Tool.hxx>
+#include <opencascade/BRepBuilderAPI_Copy.hxx>
+#include <opencascade/BRepLib_ToolTriangulatedShape.hxx>
+#include <opencascade/BRepMesh_IncrementalMesh.hxx>
+#include <opencascade/IMeshTools_Parameters.hxx>
+#include <opencascade/OSD_Parallel.hxx>
+#include <opencascade/Prs3d_Drawer.hxx>
+#include <opencascade/StdPrs_ToolTriangulatedShape.hxx>
+#include <opencascade/TopExp_Explorer.hxx>
+#include <opencascade/TopoDS.hxx>
+
+#include <algorithm>
+#include <map>
+
+namespace
+{
+//! Collect faces of the shape in explorer order.
+std::vector<TopoDS_Face> collectLodFaces(const TopoDS_Shape& theShape)
+{
+  std::vector<TopoDS_Face> aFaces;
+  for (TopExp_Explorer aFaceIter(theShape, TopAbs_FACE); aFaceIter.More(); aFaceIter.Next())
+  {
+    aFaces.push_back(TopoDS::Face(aFaceIter.Current()));
+  }
+  return aFaces;
+}
+} // namespace
+
+// ================================================================
+// Function : levelName
+// Purpose  :
+// ================================================================
+const char* OccImguiMeshLodCache::levelName(const int theLevel)
+{
+  switch (theLevel)
+  {
+    case Level_Coarse:
+      return "Coarse";
+    case Level_Medium:
+      return "Medium";
+    case Level_Fine:
+      return "Fine";
+  }
+  return "Unknown";
+}
+
+// ================================================================
+// Function : deviationCoefficient
+// Purpose  :
+// ================================================================
+double OccImguiMeshLodCache::deviationCoefficient(const int theLevel)
+{
+  switch (theLevel)
+  {
+    case Level_Coarse:
+      return 0.004;
+    case Level_Fine:
+      return 0.00025;
+  }
+  return 0.001;
+}
+
+// ================================================================
+// Function : deviationAngle
+// Purpose  :
+// ================================================================
+double OccImguiMeshLodCache::deviationAngle(const int theLevel)
+{
+  switch (theLevel)
+  {
+    case Level_Coarse:
+      return 30.0 * M_PI / 180.0;
+    case Level_Fine:
+      return 12.0 * M_PI / 180.0;
+  }
+  return 20.0 * M_PI / 180.0;
+}
+
+// ================================================================
+// Function : triangulationSize
+// Purpose  :
+// ================================================================
+size_t OccImguiMeshLodCache::triangulationSize(const Handle(Poly_Triangulation)& theTriangulation)
+{
+  if (theTriangulation.IsNull())
+  {
+    return 0;
+  }
+
+  // nodes are stored as gp_Pnt or 3 floats, normals as 3 floats and UV nodes as gp_Pnt2d
+  size_t aNodeSize = theTriangulation->IsDoublePrecision() ? sizeof(gp_Pnt) : 3 * sizeof(float);
+  aNodeSize += theTriangulation->HasNormals() ? 3 * sizeof(float) : 0;
+  aNodeSize += theTriangulation->HasUVNodes() ? sizeof(gp_Pnt2d) : 0;
+  return sizeof(Poly_Triangulation)
+         + static_cast<size_t>(theTriangulation->NbNodes()) * aNodeSize
+         + static_cast<size_t>(theTriangulation->NbTriangles()) * sizeof(Poly_Triangle);
+}
+
+// ================================================================
+// Function : ~OccImguiMeshLodCache
+// Purpose  :
+// ================================================================
+OccImguiMeshLodCache::~OccImguiMeshLodCache()
+{
+  {
+    std::lock_guard<std::mutex> aLock(myMutex);
+    myToStop = true;
+  }
+  myCondition.notify_all();
+  if (myThread.joinable())
+  {
+    myThread.join();
+  }
+}
+
+// ================================================================
+// Function : setWakeupCallback
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::setWakeupCallback(const std::function<void()>& theCallback)
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  myWakeup = theCallback;
+}
+
+// ================================================================
+// Function : findEntry
+// Purpose  :
+// ================================================================
+std::shared_ptr<OccImguiMeshLodCache::Entry> OccImguiMeshLodCache::findEntry(
+  const TopoDS_Shape& theShape) const
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  const auto                  anIter = myEntries.find(theShape.TShape().get());
+  return anIter != myEntries.end() ? anIter->second : nullptr;
+}
+
+// ================================================================
+// Function : findOrCreateEntry
+// Purpose  :
+// ================================================================
+std::shared_ptr<OccImguiMeshLodCache::Entry> OccImguiMeshLodCache::findOrCreateEntry(
+  const TopoDS_Shape& theShape)
+{
+  if (std::shared_ptr<Entry> anEntry = findEntry(theShape))
+  {
+    return anEntry;
+  }
+
+  // bounding box and face map are computed outside of the lock
+  auto aNewEntry   = std::make_shared<Entry>();
+  aNewEntry->Shape = theShape;
+  aNewEntry->Faces = collectLodFaces(theShape);
+  for (const TopoDS_Face& aFace : aNewEntry->Faces)
+  {
+    TopLoc_Location aLoc;
+    if (BRep_Tool::Surface(aFace, aLoc).IsNull())
+    {
+      aNewEntry->IsMeshOnly = true;
+      break;
+    }
+  }
+  for (int aLevel = 0; aLevel < Level_NB; ++aLevel)
+  {
+    // GetDeflection() stores the computed value in the drawer, hence a drawer per level
+    const Handle(Prs3d_Drawer) aDrawer = new Prs3d_Drawer();
+    aDrawer->SetDeviationCoefficient(deviationCoefficient(aLevel));
+    aNewEntry->Deflections[static_cast<size_t>(aLevel)] =
+      StdPrs_ToolTriangulatedShape::GetDeflection(theShape, aDrawer);
+  }
+
+  std::lock_guard<std::mutex> aLock(myMutex);
+  return myEntries.emplace(theShape.TShape().get(), aNewEntry).first->second;
+}
+
+// ================================================================
+// Function : mesh
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::mesh(const std::vector<TopoDS_Shape>& theShapes, const int theLevel)
+{
+  std::vector<std::shared_ptr<Entry>> anEntries(theShapes.size());
+  OSD_Parallel::For(0, static_cast<int>(theShapes.size()), [&](const int theIndex) {
+    anEntries[static_cast<size_t>(theIndex)] =
+      findOrCreateEntry(theShapes[static_cast<size_t>(theIndex)]);
+  });
+  meshEntries(anEntries, theLevel);
+}
+
+// ================================================================
+// Function : meshEntries
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::meshEntries(const std::vector<std::shared_ptr<Entry>>& theEntries,
+                                       const int                                  theLevel)
+{
+  const size_t aLevel = static_cast<size_t>(theLevel);
+  OSD_Parallel::For(0, static_cast<int>(theEntries.size()), [&](const int theIndex) {
+    const std::shared_ptr<Entry>& anEntry = theEntries[static_cast<size_t>(theIndex)];
+    {
+      std::lock_guard<std::mutex> aLock(myMutex);
+      if (!anEntry->Triangulations[aLevel].empty() || anEntry->Faces.empty()
+          || anEntry->IsMeshOnly)
+      {
+        return;
+      }
+    }
+
+    const double aDeflection = anEntry->Deflections[aLevel];
+    const double anAngle     = deviationAngle(theLevel);
+    uint64_t     aDiskKey    = 0;
+
+    std::vector<Handle(Poly_Triangulation)> aTriangulations;
+    if (myDiskCache != nullptr)
+    {
+      // serializing the shape costs about as much as reading it, hence once for all levels;
+      // computed on first use rather than on entry creation, which may happen on the GUI thread
+      std::call_once(anEntry->DiskKeyFlag, [&anEntry]() {
+        anEntry->DiskKey = OccImguiMeshDiskCache::shapeKey(anEntry->Shape);
+      });
+      aDiskKey = OccImguiMeshDiskCache::levelKey(anEntry->DiskKey, aDeflection, anAngle);
+      if (myDiskCache->load(aDiskKey, anEntry->Faces.size(), aTriangulations))
+      {
+        std::lock_guard<std::mutex> aLock(myMutex);
+        anEntry->Triangulations[aLevel] = std::move(aTriangulations);
+        return;
+      }
+    }
+
+    // mesh a copy sharing the geometry but not the faces, so that existing (possibly finer)
+    // triangulations are neither reused by BRepMesh nor modified while being displayed
+    BRepBuilderAPI_Copy aCopier(anEntry->Shape, Standard_False, Standard_False);
+
+    IMeshTools_Parameters aParams;
+    aParams.Deflection = aDeflection;
+    aParams.Angle      = anAngle;
+    aParams.InParallel = true;
+    BRepMesh_IncrementalMesh aMesher(aCopier.Shape(), aParams);
+
+    // the copy has the same structure, so its faces are explored in the same order
+    aTriangulations.reserve(anEntry->Faces.size());
+    for (TopExp_Explorer aFaceIter(aCopier.Shape(), TopAbs_FACE); aFaceIter.More();
+         aFaceIter.Next())
+    {
+      const TopoDS_Face&         aFace = TopoDS::Face(aFaceIter.Current());
+      TopLoc_Location            aLoc;
+      Handle(Poly_Triangulation) aTri = BRep_Tool::Triangulation(aFace, aLoc);
+      if (myDiskCache != nullptr && !aTri.IsNull() && !aTri->HasNormals())
+      {
+        // store normals as well, so that loaded entries skip their computation on display
+        BRepLib_ToolTriangulatedShape::ComputeNormals(aFace, aTri);
+      }
+      aTriangulations.push_back(aTri);
+    }
+    if (myDiskCache != nullptr)
+    {
+      myDiskCache->store(aDiskKey, aTriangulations);
+    }
+
+    std::lock_guard<std::mutex> aLock(myMutex);
+    anEntry->Triangulations[aLevel] = std::move(aTriangulations);
+  });
+}
+
+// ================================================================
+// Function : hasLevel
+// Purpose  :
+// ================================================================
+bool OccImguiMeshLodCache::hasLevel(const TopoDS_Shape& theShape, const int theLevel) const
+{
+  const std::shared_ptr<Entry> anEntry = findEntry(theShape);
+  std::lock_guard<std::mutex>  aLock(myMutex);
+  return anEntry != nullptr && !anEntry->Triangulations[static_cast<size_t>(theLevel)].empty();
+}
+
+// ================================================================
+// Function : deflection
+// Purpose  :
+// ================================================================
+double OccImguiMeshLodCache::deflection(const TopoDS_Shape& theShape, const int theLevel)
+{
+  return findOrCreateEntry(theShape)->Deflections[static_cast<size_t>(theLevel)];
+}
+
+// ================================================================
+// Function : activeLevel
+// Purpose  :
+// ================================================================
+int OccImguiMeshLodCache::activeLevel(const TopoDS_Shape& theShape) const
+{
+  const std::shared_ptr<Entry> anEntry = findEntry(theShape);
+  std::lock_guard<std::mutex>  aLock(myMutex);
+  return anEntry != nullptr ? anEntry->ActiveLevel : -1;
+}
+
+// ================================================================
+// Function : activate
+// Purpose  :
+// ================================================================
+bool OccImguiMeshLodCache::activate(const TopoDS_Shape& theShape, const int theLevel)
+{
+  const std::shared_ptr<Entry> anEntry = findEntry(theShape);
+  if (anEntry == nullptr)
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex>                    aLock(myMutex);
+  const std::vector<Handle(Poly_Triangulation)>& aTriangulations =
+    anEntry->Triangulations[static_cast<size_t>(theLevel)];
+  if (aTriangulations.size() != anEntry->Faces.size())
+  {
+    return false;
+  }
+
+  BRep_Builder aBuilder;
+  for (size_t aFaceIter = 0; aFaceIter < anEntry->Faces.size(); ++aFaceIter)
+  {
+    aBuilder.UpdateFace(anEntry->Faces[aFaceIter], aTriangulations[aFaceIter]);
+  }
+  anEntry->ActiveLevel = theLevel;
+  return true;
+}
+
+// ================================================================
+// Function : requestAsync
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::requestAsync(const TopoDS_Shape&               theShape,
+                                        const int                         theLevel,
+                                        const Handle(Standard_Transient)& theOwner)
+{
+  {
+    std::lock_guard<std::mutex> aLock(myMutex);
+    for (const ReadyLevel& aRequest : myRequests)
+    {
+      if (aRequest.Level == theLevel && aRequest.Shape.TShape() == theShape.TShape())
+      {
+        return;
+      }
+    }
+
+    myRequests.push_back(ReadyLevel{theShape, theLevel, theOwner});
+    if (!myThread.joinable())
+    {
+      myThread = std::thread(&OccImguiMeshLodCache::processRequests, this);
+    }
+  }
+  myCondition.notify_one();
+}
+
+// ================================================================
+// Function : takeReady
+// Purpose  :
+// ================================================================
+size_t OccImguiMeshLodCache::takeReady(std::vector<ReadyLevel>& theLevels)
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  const size_t                aNbReady = myReady.size();
+  theLevels.insert(theLevels.end(), myReady.begin(), myReady.end());
+  myReady.clear();
+  return aNbReady;
+}
+
+// ================================================================
+// Function : clear
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::clear()
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  myEntries.clear();
+}
+
+// ================================================================
+// Function : erase
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::erase(const TopoDS_Shape& theShape)
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  myEntries.erase(theShape.TShape().get());
+  myRequests.erase(std::remove_if(myRequests.begin(),
+                                  myRequests.end(),
+                                  [&theShape](const ReadyLevel& theRequest) {
+                                    return theRequest.Shape.TShape() == theShape.TShape();
+                                  }),
+                   myRequests.end());
+}
+
+// ================================================================
+// Function : memorySize
+// Purpose  :
+// ================================================================
+size_t OccImguiMeshLodCache::memorySize() const
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  size_t                      aSize = 0;
+  for (const auto& anEntry : myEntries)
+  {
+    aSize += entrySize(*anEntry.second);
+  }
+  return aSize;
+}
+
+// ================================================================
+// Function : memorySize
+// Purpose  :
+// ================================================================
+size_t OccImguiMeshLodCache::memorySize(const TopoDS_Shape& theShape) const
+{
+  const std::shared_ptr<Entry> anEntry = findEntry(theShape);
+  if (anEntry == nullptr)
+  {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> aLock(myMutex);
+  return entrySize(*anEntry);
+}
+
+// ================================================================
+// Function : entrySize
+// Purpose  :
+// ================================================================
+size_t OccImguiMeshLodCache::entrySize(const Entry& theEntry)
+{
+  size_t aSize = 0;
+  if (theEntry.IsMeshOnly)
+  {
+    for (const TopoDS_Face& aFace : theEntry.Faces)
+    {
+      TopLoc_Location aLoc;
+      aSize += triangulationSize(BRep_Tool::Triangulation(aFace, aLoc));
+    }
+    return aSize;
+  }
+
+  for (const std::vector<Handle(Poly_Triangulation)>& aLevel : theEntry.Triangulations)
+  {
+    for (const Handle(Poly_Triangulation)& aTriangulation : aLevel)
+    {
+      aSize += triangulationSize(aTriangulation);
+    }
+  }
+  return aSize;
+}
+
+// ================================================================
+// Function : release
+// Purpose  :
+// ================================================================
+size_t OccImguiMeshLodCache::release(const TopoDS_Shape& theShape, const int theKeepLevel)
+{
+  const std::shared_ptr<Entry> anEntry = findEntry(theShape);
+  if (anEntry == nullptr)
+  {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> aLock(myMutex);
+  size_t                      aSize = 0;
+  for (int aLevelIter = 0; aLevelIter < Level_NB; ++aLevelIter)
+  {
+    if (aLevelIter == theKeepLevel || aLevelIter == anEntry->ActiveLevel)
+    {
+      continue;
+    }
+
+    std::vector<Handle(Poly_Triangulation)>& aLevel =
+      anEntry->Triangulations[static_cast<size_t>(aLevelIter)];
+    for (const Handle(Poly_Triangulation)& aTriangulation : aLevel)
+    {
+      aSize += triangulationSize(aTriangulation);
+    }
+    std::vector<Handle(Poly_Triangulation)>().swap(aLevel);
+  }
+  return aSize;
+}
+
+// ================================================================
+// Function : processRequests
+// Purpose  :
+// ================================================================
+void OccImguiMeshLodCache::processRequests()
+{
+  for (;;)
+  {
+    std::deque<ReadyLevel> aRequests;
+    {
+      std::unique_lock<std::mutex> aLock(myMutex);
+      myCondition.wait(aLock, [this]() { return myToStop || !myRequests.empty(); });
+      if (myToStop)
+      {
+        return;
+      }
+      aRequests.swap(myRequests);
+    }
+
+    // mesh all pending requests of the same level in one parallel pass; shapes erased meanwhile
+    // are skipped, entries erased while being meshed are released once done
+    std::map<int, std::vector<std::shared_ptr<Entry>>> anEntriesPerLevel;
+    for (const ReadyLevel& aRequest : aRequests)
+    {
+      if (std::shared_ptr<Entry> anEntry = findEntry(aRequest.Shape))
+      {
+        anEntriesPerLevel[aRequest.Level].push_back(std::move(anEntry));
+      }
+    }
+    for (const auto& aLevelEntries : anEntriesPerLevel)
+    {
+      meshEntries(aLevelEntries.second, aLevelEntries.first);
+    }
+
+    std::function<void()> aWakeup;
+    {
+      std::lock_guard<std::mutex> aLock(myMutex);
+      myReady.insert(myReady.end(), aRequests.begin(), aRequests.end());
+      aWakeup = myWakeup;
+    }
+    if (aWakeup)
+    {
+      aWakeup();
+    }
+  }
+}
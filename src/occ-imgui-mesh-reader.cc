@@ -0,0 +1,531 @@
+#include "occ_imgui/occ-imgui-mesh-reader.h"
+
+#include "occ_imgui/occ-imgui-mapped-file.h"
+
+#include <opencascade/BRep_Builder.hxx>
+#include <opencascade/Message_ProgressScope.hxx>
+#include <opencascade/OSD_Parallel.hxx>
+#include <opencascade/RWGltf_CafReader.hxx>
+#include <opencascade/RWStl.hxx>
+#include <opencascade/Standard_CString.hxx>
+#include <opencascade/TopoDS_Compound.hxx>
+#include <opencascade/TopoDS_Face.hxx>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+//! Size of the binary STL header followed by the triangle count.
+constexpr size_t THE_STL_HEADER_SIZE = 84;
+
+//! Size of one binary STL triangle record: normal, three vertices and attribute.
+constexpr size_t THE_STL_RECORD_SIZE = 50;
+
+//! Approximate number of OBJ bytes parsed by one task.
+constexpr size_t THE_OBJ_CHUNK_BYTES = size_t(1) << 22;
+
+//! Supported mesh formats.
+enum MeshFileFormat
+{
+  MeshFileFormat_Unknown,
+  MeshFileFormat_STL,
+  MeshFileFormat_OBJ,
+  MeshFileFormat_GLTF
+};
+
+//! Detect mesh format from the file extension.
+MeshFileFormat meshFormatFromPath(const TCollection_AsciiString& thePath)
+{
+  const Standard_Integer aDotPos = thePath.SearchFromEnd(".");
+  if (aDotPos <= 0)
+  {
+    return MeshFileFormat_Unknown;
+  }
+
+  TCollection_AsciiString anExt = thePath.SubString(aDotPos + 1, thePath.Length());
+  anExt.LowerCase();
+  if (anExt == "stl")
+  {
+    return MeshFileFormat_STL;
+  }
+  if (anExt == "obj")
+  {
+    return MeshFileFormat_OBJ;
+  }
+  if (anExt == "gltf" || anExt == "glb")
+  {
+    return MeshFileFormat_GLTF;
+  }
+  return MeshFileFormat_Unknown;
+}
+
+//! Read a little-endian 32-bit value.
+uint32_t readStlUInt32(const uint8_t* theData)
+{
+  return uint32_t(theData[0]) | (uint32_t(theData[1]) << 8) | (uint32_t(theData[2]) << 16)
+         | (uint32_t(theData[3]) << 24);
+}
+
+//! Read a little-endian float.
+float readStlFloat(const uint8_t* theData)
+{
+  const uint32_t aBits = readStlUInt32(theData);
+  float          aValue;
+  std::memcpy(&aValue, &aBits, sizeof(aValue));
+  return aValue;
+}
+
+//! Hash of the 12 bytes of an STL vertex.
+uint32_t hashStlVertex(const uint8_t* theVertex)
+{
+  uint32_t aHash = readStlUInt32(theVertex) * 0x9E3779B1u;
+  aHash ^= readStlUInt32(theVertex + 4) * 0x85EBCA77u;
+  aHash ^= readStlUInt32(theVertex + 8) * 0xC2B2AE3Du;
+  return aHash ^ (aHash >> 15);
+}
+
+//! Parse one chunk of binary STL records into a triangulation with merged nodes.
+//! Nodes are looked up by the bytes of the mapped records, so that node coordinates are copied
+//! only once, into the triangulation.
+Handle(Poly_Triangulation) readStlChunk(const uint8_t* theRecords, const size_t theNbTriangles)
+{
+  auto aVertex = [theRecords](const size_t theOrdinal) {
+    return theRecords + (theOrdinal / 3) * THE_STL_RECORD_SIZE + 12 + (theOrdinal % 3) * 12;
+  };
+
+  // open addressing table of node indices, at most half full
+  size_t aTableSize = 16;
+  while (aTableSize < theNbTriangles * 6)
+  {
+    aTableSize <<= 1;
+  }
+  std::vector<int32_t>  aTable(aTableSize, -1);
+  std::vector<uint32_t> aNodeVertices; // first vertex ordinal of every node
+  aNodeVertices.reserve(theNbTriangles);
+
+  Handle(Poly_Triangulation) aTri = new Poly_Triangulation();
+  aTri->SetDoublePrecision(false);
+  aTri->ResizeTriangles(static_cast<Standard_Integer>(theNbTriangles), false);
+  Standard_Integer aNbTriangles = 0;
+  for (size_t aTriIter = 0; aTriIter < theNbTriangles; ++aTriIter)
+  {
+    Standard_Integer aNodes[3] = {0, 0, 0};
+    for (size_t aVertIter = 0; aVertIter < 3; ++aVertIter)
+    {
+      const size_t   anOrdinal = aTriIter * 3 + aVertIter;
+      const uint8_t* aPos      = aVertex(anOrdinal);
+      size_t         aSlot     = hashStlVertex(aPos) & (aTableSize - 1);
+      while (aTable[aSlot] >= 0
+             && std::memcmp(aVertex(aNodeVertices[static_cast<size_t>(aTable[aSlot])]), aPos, 12)
+                  != 0)
+      {
+        aSlot = (aSlot + 1) & (aTableSize - 1);
+      }
+      if (aTable[aSlot] < 0)
+      {
+        aTable[aSlot] = static_cast<int32_t>(aNodeVertices.size());
+        aNodeVertices.push_back(static_cast<uint32_t>(anOrdinal));
+      }
+      aNodes[aVertIter] = aTable[aSlot] + 1;
+    }
+    if (aNodes[0] != aNodes[1] && aNodes[1] != aNodes[2] && aNodes[0] != aNodes[2])
+    {
+      aTri->SetTriangle(++aNbTriangles, Poly_Triangle(aNodes[0], aNodes[1], aNodes[2]));
+    }
+  }
+  if (aNbTriangles == 0)
+  {
+    return Handle(Poly_Triangulation)();
+  }
+
+  aTri->ResizeTriangles(aNbTriangles, true);
+  aTri->ResizeNodes(static_cast<Standard_Integer>(aNodeVertices.size()), false);
+  for (size_t aNodeIter = 0; aNodeIter < aNodeVertices.size(); ++aNodeIter)
+  {
+    const uint8_t* aPos = aVertex(aNodeVertices[aNodeIter]);
+    aTri->SetNode(static_cast<Standard_Integer>(aNodeIter + 1),
+                  gp_Pnt(readStlFloat(aPos), readStlFloat(aPos + 4), readStlFloat(aPos + 8)));
+  }
+  aTri->ComputeNormals();
+  return aTri;
+}
+
+//! Skip spaces and tabs; returns FALSE at the end of the line.
+bool skipObjBlanks(const char*& thePos, const char* theEnd)
+{
+  while (thePos < theEnd && (*thePos == ' ' || *thePos == '\t' || *thePos == '\r'))
+  {
+    ++thePos;
+  }
+  return thePos < theEnd && *thePos != '\n';
+}
+
+//! Return 'v' for vertex lines, 'f' for face lines and 0 for other lines;
+//! thePos is moved behind the keyword.
+char objLineKind(const char*& thePos, const char* theEnd)
+{
+  if (!skipObjBlanks(thePos, theEnd) || theEnd - thePos < 2
+      || (thePos[1] != ' ' && thePos[1] != '\t'))
+  {
+    return 0;
+  }
+  const char aKind = *thePos;
+  if (aKind == 'v' || aKind == 'f')
+  {
+    thePos += 2;
+    return aKind;
+  }
+  return 0;
+}
+
+//! Count vertex references of a face line.
+size_t countObjFaceVertices(const char* thePos, const char* theEnd)
+{
+  size_t aNbVertices = 0;
+  while (skipObjBlanks(thePos, theEnd))
+  {
+    ++aNbVertices;
+    while (thePos < theEnd && !std::isspace(static_cast<unsigned char>(*thePos)))
+    {
+      ++thePos;
+    }
+  }
+  return aNbVertices;
+}
+
+//! Vertex and triangle counts of an OBJ chunk, turned into offsets by a prefix sum.
+struct ObjChunk
+{
+  const char* Begin       = nullptr;
+  const char* End         = nullptr;
+  size_t      NbNodes     = 0;
+  size_t      NbTriangles = 0;
+};
+
+//! Parse a vertex or face line, terminated by '\n' or a null character;
+//! returns FALSE if it refers to a missing vertex.
+bool parseObjLine(const char*                       thePos,
+                  const char*                       theEnd,
+                  size_t&                           theNodeIndex,
+                  size_t&                           theTriIndex,
+                  const size_t                      theNbNodes,
+                  const Handle(Poly_Triangulation)& theTri)
+{
+  const char aKind = objLineKind(thePos, theEnd);
+  if (aKind == 'v')
+  {
+    double aCoords[3] = {0.0, 0.0, 0.0};
+    for (double& aCoord : aCoords)
+    {
+      if (!skipObjBlanks(thePos, theEnd))
+      {
+        break;
+      }
+      char* aNext = nullptr;
+      aCoord      = Strtod(thePos, &aNext);
+      thePos      = aNext;
+    }
+    theTri->SetNode(static_cast<Standard_Integer>(++theNodeIndex),
+                    gp_Pnt(aCoords[0], aCoords[1], aCoords[2]));
+    return true;
+  }
+  if (aKind != 'f')
+  {
+    return true;
+  }
+
+  // polygons are split into fans; negative indices are relative to the last vertex so far
+  Standard_Integer aFirst = 0, aPrev = 0;
+  size_t           aNbVertices = 0;
+  while (skipObjBlanks(thePos, theEnd))
+  {
+    char*      aNext   = nullptr;
+    const long anIndex = std::strtol(thePos, &aNext, 10);
+    const long aNode   = anIndex < 0 ? static_cast<long>(theNodeIndex) + anIndex + 1 : anIndex;
+    if (aNext == thePos || aNode < 1 || aNode > static_cast<long>(theNbNodes))
+    {
+      return false;
+    }
+    thePos = aNext;
+    while (thePos < theEnd && !std::isspace(static_cast<unsigned char>(*thePos)))
+    {
+      ++thePos;
+    }
+
+    const Standard_Integer aCurr = static_cast<Standard_Integer>(aNode);
+    if (++aNbVertices >= 3)
+    {
+      theTri->SetTriangle(static_cast<Standard_Integer>(++theTriIndex),
+                          Poly_Triangle(aFirst, aPrev, aCurr));
+    }
+    aFirst = aNbVertices == 1 ? aCurr : aFirst;
+    aPrev  = aCurr;
+  }
+  return true;
+}
+} // namespace
+
+// ================================================================
+// Function : isSupportedFile
+// Purpose  :
+// ================================================================
+bool OccImguiMeshReader::isSupportedFile(const TCollection_AsciiString& thePath)
+{
+  return meshFormatFromPath(thePath) != MeshFileFormat_Unknown;
+}
+
+// ================================================================
+// Function : isBinaryStl
+// Purpose  :
+// ================================================================
+bool OccImguiMeshReader::isBinaryStl(const uint8_t* theData, const size_t theSize)
+{
+  if (theSize < THE_STL_HEADER_SIZE)
+  {
+    return false;
+  }
+
+  // ASCII files start with "solid", but so do headers of some binary files
+  const size_t aNbTriangles = readStlUInt32(theData + 80);
+  const size_t anExpected   = THE_STL_HEADER_SIZE + aNbTriangles * THE_STL_RECORD_SIZE;
+  return theSize == anExpected
+         || (theSize > anExpected && std::memcmp(theData, "solid", 5) != 0);
+}
+
+// ================================================================
+// Function : readBinaryStl
+// Purpose  :
+// ================================================================
+bool OccImguiMeshReader::readBinaryStl(const uint8_t*                           theData,
+                                       const size_t                             theSize,
+                                       const size_t                             theChunkSize,
+                                       std::vector<Handle(Poly_Triangulation)>& theTriangulations,
+                                       const Message_ProgressRange&             theProgress)
+{
+  if (theSize < THE_STL_HEADER_SIZE || theChunkSize == 0)
+  {
+    return false;
+  }
+
+  const size_t aNbTriangles = readStlUInt32(theData + 80);
+  if (theSize < THE_STL_HEADER_SIZE + aNbTriangles * THE_STL_RECORD_SIZE)
+  {
+    return false;
+  }
+
+  // progress ranges are taken up front, as scopes are created on worker threads
+  const size_t          aNbChunks = (aNbTriangles + theChunkSize - 1) / theChunkSize;
+  Message_ProgressScope aPS(theProgress,
+                            "Reading STL",
+                            static_cast<Standard_Real>(std::max<size_t>(aNbChunks, 1)));
+  std::vector<Message_ProgressRange>      aRanges;
+  std::vector<Handle(Poly_Triangulation)> aChunks(aNbChunks);
+  for (size_t aChunkIter = 0; aChunkIter < aNbChunks; ++aChunkIter)
+  {
+    aRanges.push_back(aPS.Next());
+  }
+
+  OSD_Parallel::For(0, static_cast<int>(aNbChunks), [&](const int theIndex) {
+    const size_t          aChunk = static_cast<size_t>(theIndex);
+    Message_ProgressScope aChunkPS(aRanges[aChunk], nullptr, 1);
+    if (!aChunkPS.More())
+    {
+      return;
+    }
+
+    const size_t aFirst = aChunk * theChunkSize;
+    aChunks[aChunk] =
+      readStlChunk(theData + THE_STL_HEADER_SIZE + aFirst * THE_STL_RECORD_SIZE,
+                   std::min(theChunkSize, aNbTriangles - aFirst));
+    aChunkPS.Next();
+  });
+  if (aPS.UserBreak())
+  {
+    return false;
+  }
+
+  for (const Handle(Poly_Triangulation)& aChunk : aChunks)
+  {
+    if (!aChunk.IsNull())
+    {
+      theTriangulations.push_back(aChunk);
+    }
+  }
+  return true;
+}
+
+// ================================================================
+// Function : readObj
+// Purpose  :
+// ================================================================
+Handle(Poly_Triangulation) OccImguiMeshReader::readObj(const char*                  theData,
+                                                       const size_t                 theSize,
+                                                       const Message_ProgressRange& theProgress)
+{
+  // split the content at line ends into chunks parsed in parallel
+  const char*           anEnd = theData + theSize;
+  std::vector<ObjChunk> aChunks;
+  for (const char* aPos = theData; aPos < anEnd;)
+  {
+    const char* aChunkEnd =
+      aPos + std::min(THE_OBJ_CHUNK_BYTES, static_cast<size_t>(anEnd - aPos));
+    aChunkEnd             = std::find(aChunkEnd, anEnd, '\n');
+    aChunkEnd             = aChunkEnd < anEnd ? aChunkEnd + 1 : anEnd;
+    aChunks.push_back(ObjChunk{aPos, aChunkEnd, 0, 0});
+    aPos = aChunkEnd;
+  }
+
+  // the first pass counts vertices and triangles, so that the second one knows where to put them
+  // and how to resolve relative vertex indices
+  OSD_Parallel::For(0, static_cast<int>(aChunks.size()), [&](const int theIndex) {
+    ObjChunk& aChunk = aChunks[static_cast<size_t>(theIndex)];
+    for (const char* aLine = aChunk.Begin; aLine < aChunk.End;)
+    {
+      const char* aLineEnd = std::find(aLine, aChunk.End, '\n');
+      const char* aPos     = aLine;
+      const char  aKind    = objLineKind(aPos, aLineEnd);
+      if (aKind == 'v')
+      {
+        ++aChunk.NbNodes;
+      }
+      else if (aKind == 'f')
+      {
+        aChunk.NbTriangles += std::max<size_t>(countObjFaceVertices(aPos, aLineEnd), 2) - 2;
+      }
+      aLine = aLineEnd < aChunk.End ? aLineEnd + 1 : aChunk.End;
+    }
+  });
+
+  size_t aNbNodes = 0, aNbTriangles = 0;
+  for (ObjChunk& aChunk : aChunks)
+  {
+    const size_t aChunkNodes = aChunk.NbNodes, aChunkTriangles = aChunk.NbTriangles;
+    aChunk.NbNodes           = aNbNodes;
+    aChunk.NbTriangles       = aNbTriangles;
+    aNbNodes += aChunkNodes;
+    aNbTriangles += aChunkTriangles;
+  }
+  if (aNbNodes == 0 || aNbTriangles == 0)
+  {
+    return Handle(Poly_Triangulation)();
+  }
+
+  Handle(Poly_Triangulation) aTri = new Poly_Triangulation();
+  aTri->SetDoublePrecision(false);
+  aTri->ResizeNodes(static_cast<Standard_Integer>(aNbNodes), false);
+  aTri->ResizeTriangles(static_cast<Standard_Integer>(aNbTriangles), false);
+
+  Message_ProgressScope aPS(theProgress, "Reading OBJ", static_cast<Standard_Real>(aChunks.size()));
+  std::vector<Message_ProgressRange> aRanges;
+  for (size_t aChunkIter = 0; aChunkIter < aChunks.size(); ++aChunkIter)
+  {
+    aRanges.push_back(aPS.Next());
+  }
+
+  std::atomic<bool> isValid(true);
+  OSD_Parallel::For(0, static_cast<int>(aChunks.size()), [&](const int theIndex) {
+    const ObjChunk&       aChunk = aChunks[static_cast<size_t>(theIndex)];
+    Message_ProgressScope aChunkPS(aRanges[static_cast<size_t>(theIndex)], nullptr, 1);
+    size_t                aNodeIndex = aChunk.NbNodes;
+    size_t                aTriIndex  = aChunk.NbTriangles;
+    for (const char* aLine = aChunk.Begin; aLine < aChunk.End && aChunkPS.More() && isValid;)
+    {
+      const char* aLineEnd = std::find(aLine, aChunk.End, '\n');
+      bool        isParsed = true;
+      if (aLineEnd == anEnd)
+      {
+        // numbers are parsed up to a terminator, which the mapping lacks after the last line
+        const std::string aLastLine(aLine, aLineEnd);
+        isParsed = parseObjLine(aLastLine.c_str(),
+                                aLastLine.c_str() + aLastLine.size(),
+                                aNodeIndex,
+                                aTriIndex,
+                                aNbNodes,
+                                aTri);
+      }
+      else
+      {
+        isParsed = parseObjLine(aLine, aLineEnd, aNodeIndex, aTriIndex, aNbNodes, aTri);
+      }
+      if (!isParsed)
+      {
+        isValid = false;
+      }
+      aLine = aLineEnd < aChunk.End ? aLineEnd + 1 : aChunk.End;
+    }
+    aChunkPS.Next();
+  });
+  if (!isValid || aPS.UserBreak())
+  {
+    return Handle(Poly_Triangulation)();
+  }
+
+  aTri->ComputeNormals();
+  return aTri;
+}
+
+// ================================================================
+// Function : readShape
+// Purpose  :
+// ================================================================
+TopoDS_Shape OccImguiMeshReader::readShape(const TCollection_AsciiString& thePath,
+                                           const Message_ProgressRange&   theProgress)
+{
+  const MeshFileFormat aFormat = meshFormatFromPath(thePath);
+  if (aFormat == MeshFileFormat_GLTF)
+  {
+    // buffers are loaded by parallel tasks directly into the triangulations
+    RWGltf_CafReader aReader;
+    aReader.SetParallel(true);
+    aReader.SetSystemCoordinateSystem(RWMesh_CoordinateSystem_Zup);
+    return aReader.Perform(thePath, theProgress) ? aReader.SingleShape() : TopoDS_Shape();
+  }
+
+  std::vector<Handle(Poly_Triangulation)> aTriangulations;
+  if (aFormat == MeshFileFormat_STL || aFormat == MeshFileFormat_OBJ)
+  {
+    OccImguiMappedFile aFile;
+    if (!aFile.open(thePath.ToCString()))
+    {
+      return TopoDS_Shape();
+    }
+
+    if (aFormat == MeshFileFormat_OBJ)
+    {
+      aTriangulations.push_back(readObj(reinterpret_cast<const char*>(aFile.data()),
+                                        aFile.size(),
+                                        theProgress));
+    }
+    else if (isBinaryStl(aFile.data(), aFile.size()))
+    {
+      readBinaryStl(aFile.data(), aFile.size(), THE_STL_CHUNK_SIZE, aTriangulations, theProgress);
+    }
+    else
+    {
+      aFile.close();
+      aTriangulations.push_back(RWStl::ReadFile(thePath.ToCString(), theProgress));
+    }
+  }
+
+  // every triangulation becomes a face without surface
+  BRep_Builder    aBuilder;
+  TopoDS_Compound aCompound;
+  aBuilder.MakeCompound(aCompound);
+  bool isEmpty = true;
+  for (const Handle(Poly_Triangulation)& aTri : aTriangulations)
+  {
+    if (!aTri.IsNull())
+    {
+      TopoDS_Face aFace;
+      aBuilder.MakeFace(aFace, aTri);
+      aBuilder.Add(aCompound, aFace);
+      isEmpty = false;
+    }
+  }
+  return isEmpty ? TopoDS_Shape() : aCompound;
+}
@@ -0,0 +1,328 @@
+#include "occ_imgui/occ-imgui-modeling.h"
+
+#include <opencascade/BRepAlgoAPI_BooleanOperation.hxx>
+#include <opencascade/BRepBuilderAPI_Copy.hxx>
+#include <opencascade/BRepFilletAPI_MakeFillet.hxx>
+#include <opencascade/BRepOffsetAPI_MakeOffsetShape.hxx>
+#include <opencascade/BRep_Tool.hxx>
+#include <opencascade/Message.hxx>
+#include <opencascade/Message_Messenger.hxx>
+#include <opencascade/Message_ProgressScope.hxx>
+#include <opencascade/Precision.hxx>
+#include <opencascade/Standard_Failure.hxx>
+#include <opencascade/TopExp.hxx>
+#include <opencascade/TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <opencascade/TopTools_ListOfShape.hxx>
+#include <opencascade/TopoDS.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+namespace
+{
+//! Return steady clock time in seconds.
+double modelingClockTime()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+    .count();
+}
+} // namespace
+
+// ================================================================
+// Function : operationName
+// Purpose  :
+// ================================================================
+const char* OccImguiModeling::operationName(const int theOperation)
+{
+  switch (theOperation)
+  {
+    case Operation_Fuse:
+      return "Fuse";
+    case Operation_Cut:
+      return "Cut";
+    case Operation_Common:
+      return "Common";
+    case Operation_Fillet:
+      return "Fillet";
+    case Operation_Offset:
+      return "Offset";
+  }
+  return "Unknown";
+}
+
+// ================================================================
+// Function : perform
+// Purpose  :
+// ================================================================
+TopoDS_Shape OccImguiModeling::perform(const Operation                  theOperation,
+                                       const TopoDS_Shape&              theShape,
+                                       const std::vector<TopoDS_Shape>& theTools,
+                                       const double                     theValue,
+                                       const Message_ProgressRange&     theProgress)
+{
+  switch (theOperation)
+  {
+    case Operation_Fuse:
+    case Operation_Cut:
+    case Operation_Common: {
+      TopTools_ListOfShape anArguments, aTools;
+      anArguments.Append(theShape);
+      for (const TopoDS_Shape& aTool : theTools)
+      {
+        aTools.Append(aTool);
+      }
+
+      // inputs keep their tolerances (non-destructive mode), so they stay valid for display;
+      // oriented bounding boxes speed up filtering of interfering sub-shapes
+      BRepAlgoAPI_BooleanOperation aBoolean;
+      aBoolean.SetOperation(theOperation == Operation_Fuse  ? BOPAlgo_FUSE
+                            : theOperation == Operation_Cut ? BOPAlgo_CUT
+                                                            : BOPAlgo_COMMON);
+      aBoolean.SetArguments(anArguments);
+      aBoolean.SetTools(aTools);
+      aBoolean.SetRunParallel(Standard_True);
+      aBoolean.SetNonDestructive(Standard_True);
+      aBoolean.SetUseOBB(Standard_True);
+      aBoolean.Build(theProgress);
+      if (theProgress.UserBreak())
+      {
+        return TopoDS_Shape();
+      }
+      if (aBoolean.HasErrors() || !aBoolean.IsDone())
+      {
+        std::ostringstream aStream;
+        aStream << operationName(theOperation) << " failed: ";
+        aBoolean.DumpErrors(aStream);
+        throw Standard_Failure(aStream.str().c_str());
+      }
+      return aBoolean.Shape();
+    }
+    case Operation_Fillet: {
+      // sharp edges between two distinct faces; seams and degenerated edges are skipped
+      TopTools_IndexedDataMapOfShapeListOfShape anEdgeFaces;
+      TopExp::MapShapesAndUniqueAncestors(theShape, TopAbs_EDGE, TopAbs_FACE, anEdgeFaces);
+      BRepFilletAPI_MakeFillet aFillet(theShape);
+      for (int anEdgeIter = 1; anEdgeIter <= anEdgeFaces.Extent(); ++anEdgeIter)
+      {
+        const TopoDS_Edge&          anEdge = TopoDS::Edge(anEdgeFaces.FindKey(anEdgeIter));
+        const TopTools_ListOfShape& aFaces = anEdgeFaces.FindFromIndex(anEdgeIter);
+        if (BRep_Tool::Degenerated(anEdge) || aFaces.Extent() != 2
+            || BRep_Tool::Continuity(anEdge,
+                                     TopoDS::Face(aFaces.First()),
+                                     TopoDS::Face(aFaces.Last()))
+                 != GeomAbs_C0)
+        {
+          continue;
+        }
+        aFillet.Add(theValue, anEdge);
+      }
+      if (aFillet.NbContours() == 0)
+      {
+        throw Standard_Failure("Fillet failed: no sharp edges");
+      }
+
+      aFillet.Build(theProgress);
+      if (theProgress.UserBreak())
+      {
+        return TopoDS_Shape();
+      }
+      if (!aFillet.IsDone())
+      {
+        throw Standard_Failure("Fillet failed: radius may be too large");
+      }
+      return aFillet.Shape();
+    }
+    case Operation_Offset: {
+      BRepOffsetAPI_MakeOffsetShape anOffset;
+      anOffset.PerformByJoin(theShape,
+                             theValue,
+                             Precision::Confusion(),
+                             BRepOffset_Skin,
+                             Standard_False,
+                             Standard_False,
+                             GeomAbs_Arc,
+                             Standard_False,
+                             theProgress);
+      if (theProgress.UserBreak())
+      {
+        return TopoDS_Shape();
+      }
+      if (!anOffset.IsDone())
+      {
+        throw Standard_Failure("Offset failed");
+      }
+      return anOffset.Shape();
+    }
+    case Operation_NB:
+      break;
+  }
+  throw Standard_Failure("Unknown modeling operation");
+}
+
+// ================================================================
+// Function : ~OccImguiModeling
+// Purpose  :
+// ================================================================
+OccImguiModeling::~OccImguiModeling()
+{
+  cancel();
+  wait();
+}
+
+// ================================================================
+// Function : start
+// Purpose  :
+// ================================================================
+bool OccImguiModeling::start(const Operation                       theOperation,
+                             const Handle(AIS_Shape)&              theTarget,
+                             const std::vector<Handle(AIS_Shape)>& theTools,
+                             const double                          theValue)
+{
+  if (theTarget.IsNull() || isBusy(theTarget) || (isBoolean(theOperation) && theTools.empty())
+      || std::any_of(theTools.begin(), theTools.end(), [this](const Handle(AIS_Shape)& theTool) {
+           return isBusy(theTool);
+         }))
+  {
+    return false;
+  }
+
+  std::unique_ptr<Task> aTask = std::make_unique<Task>();
+  aTask->Target               = theTarget;
+  aTask->Op                   = theOperation;
+  aTask->Value                = theValue;
+  aTask->Progress             = new OccImguiProgress();
+  aTask->StartTime            = modelingClockTime();
+
+  // the GUI thread keeps swapping triangulations of the displayed inputs, so they are copied
+  // here, before the worker starts; the operation reads copies sharing only the geometry
+  const TopoDS_Shape        aShape =
+    BRepBuilderAPI_Copy(theTarget->Shape(), Standard_False).Shape();
+  std::vector<TopoDS_Shape> aTools;
+  if (isBoolean(theOperation))
+  {
+    aTask->Tools = theTools;
+    for (const Handle(AIS_Shape)& aTool : theTools)
+    {
+      aTools.push_back(BRepBuilderAPI_Copy(aTool->Shape(), Standard_False).Shape());
+    }
+  }
+
+  Task& aTaskRef = *aTask;
+  myTasks.push_back(std::move(aTask));
+  aTaskRef.Thread = std::thread(&OccImguiModeling::run, this, std::ref(aTaskRef), aShape, aTools);
+  return true;
+}
+
+// ================================================================
+// Function : isBusy
+// Purpose  :
+// ================================================================
+bool OccImguiModeling::isBusy(const Handle(AIS_Shape)& theShape) const
+{
+  for (const std::unique_ptr<Task>& aTask : myTasks)
+  {
+    if (aTask->Target == theShape
+        || std::find(aTask->Tools.begin(), aTask->Tools.end(), theShape) != aTask->Tools.end())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ================================================================
+// Function : cancel
+// Purpose  :
+// ================================================================
+void OccImguiModeling::cancel()
+{
+  for (const std::unique_ptr<Task>& aTask : myTasks)
+  {
+    aTask->Progress->requestCancel();
+  }
+}
+
+// ================================================================
+// Function : wait
+// Purpose  :
+// ================================================================
+void OccImguiModeling::wait()
+{
+  for (const std::unique_ptr<Task>& aTask : myTasks)
+  {
+    if (aTask->Thread.joinable())
+    {
+      aTask->Thread.join();
+    }
+  }
+}
+
+// ================================================================
+// Function : fetch
+// Purpose  :
+// ================================================================
+size_t OccImguiModeling::fetch(std::vector<std::unique_ptr<Task>>& theTasks)
+{
+  size_t aNbTasks = 0;
+  for (auto aTaskIter = myTasks.begin(); aTaskIter != myTasks.end();)
+  {
+    if ((*aTaskIter)->State == Status_Running)
+    {
+      ++aTaskIter;
+      continue;
+    }
+
+    (*aTaskIter)->Thread.join();
+    theTasks.push_back(std::move(*aTaskIter));
+    aTaskIter = myTasks.erase(aTaskIter);
+    ++aNbTasks;
+  }
+  return aNbTasks;
+}
+
+// ================================================================
+// Function : run
+// Purpose  :
+// ================================================================
+void OccImguiModeling::run(Task&                            theTask,
+                           const TopoDS_Shape&              theShape,
+                           const std::vector<TopoDS_Shape>& theTools)
+{
+  Status aResult = Status_Failed;
+  try
+  {
+    Message_ProgressScope aPS(theTask.Progress->Start(), operationName(theTask.Op), 10);
+    const TopoDS_Shape    aModified =
+      perform(theTask.Op, theShape, theTools, theTask.Value, aPS.Next(8));
+    if (!aModified.IsNull() && aPS.More())
+    {
+      // same levels as for imported parts, the result is displayed at medium quality at once
+      Message_ProgressScope aMeshPS(aPS.Next(2), "Meshing", 1);
+      myMeshCache.mesh({aModified}, OccImguiMeshLodCache::Level_Coarse);
+      myMeshCache.mesh({aModified}, OccImguiMeshLodCache::Level_Medium);
+      myMeshCache.activate(aModified, OccImguiMeshLodCache::Level_Medium);
+      theTask.Result = aModified;
+    }
+    aResult = theTask.Result.IsNull() ? Status_Cancelled : Status_Finished;
+  }
+  catch (const Standard_Failure& theFailure)
+  {
+    theTask.Error = theFailure.GetMessageString();
+  }
+  catch (const std::exception& theError)
+  {
+    theTask.Error = theError.what();
+  }
+
+  if (aResult == Status_Failed)
+  {
+    Message::DefaultMessenger()->Send(theTask.Error, Message_Fail);
+  }
+  theTask.Duration = modelingClockTime() - theTask.StartTime;
+  theTask.State    = aResult;
+  if (myWakeup)
+  {
+    myWakeup();
+  }
+}
@@ -0,0 +1,227 @@
+#include "occ_imgui/occ-imgui-png-writer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <fstream>
+
+namespace
+{
+//! PNG file signature.
+constexpr uint8_t THE_PNG_SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+//! Largest payload of a stored deflate block.
+constexpr size_t THE_PNG_MAX_STORED_BLOCK = 65535;
+
+//! Largest number of bytes summed before the Adler-32 sums have to be reduced.
+constexpr size_t THE_PNG_ADLER_NMAX = 5552;
+
+//! Return the table of CRC-32 remainders of all byte values.
+const std::array<uint32_t, 256>& pngCrcTable()
+{
+  static const std::array<uint32_t, 256> THE_TABLE = []() {
+    std::array<uint32_t, 256> aTable{};
+    for (uint32_t aByte = 0; aByte < 256; ++aByte)
+    {
+      uint32_t aCrc = aByte;
+      for (int aBit = 0; aBit < 8; ++aBit)
+      {
+        aCrc = (aCrc & 1u) != 0 ? 0xEDB88320u ^ (aCrc >> 1) : aCrc >> 1;
+      }
+      aTable[aByte] = aCrc;
+    }
+    return aTable;
+  }();
+  return THE_TABLE;
+}
+
+//! Return Adler-32 checksum of the zlib stream.
+uint32_t pngAdler32(const uint8_t* theData, const size_t theSize)
+{
+  uint32_t aSumA = 1, aSumB = 0;
+  for (size_t anOffset = 0; anOffset < theSize;)
+  {
+    const size_t aChunkEnd = std::min(theSize, anOffset + THE_PNG_ADLER_NMAX);
+    for (; anOffset < aChunkEnd; ++anOffset)
+    {
+      aSumA += theData[anOffset];
+      aSumB += aSumA;
+    }
+    aSumA %= 65521u;
+    aSumB %= 65521u;
+  }
+  return (aSumB << 16) | aSumA;
+}
+
+//! Append a 32-bit big-endian value.
+void appendPngUInt32(std::vector<uint8_t>& theData, const uint32_t theValue)
+{
+  theData.push_back(static_cast<uint8_t>(theValue >> 24));
+  theData.push_back(static_cast<uint8_t>(theValue >> 16));
+  theData.push_back(static_cast<uint8_t>(theValue >> 8));
+  theData.push_back(static_cast<uint8_t>(theValue));
+}
+
+//! Append a chunk with its length, type and CRC.
+void appendPngChunk(std::vector<uint8_t>&       theData,
+                    const char*                 theType,
+                    const std::vector<uint8_t>& thePayload)
+{
+  appendPngUInt32(theData, static_cast<uint32_t>(thePayload.size()));
+  const size_t aTypeOffset = theData.size();
+  theData.insert(theData.end(), theType, theType + 4);
+  theData.insert(theData.end(), thePayload.begin(), thePayload.end());
+  appendPngUInt32(theData,
+                  OccImguiPngWriter::crc32(theData.data() + aTypeOffset,
+                                           theData.size() - aTypeOffset));
+}
+
+//! Return number of channels written to PNG and the source channel offsets of the format.
+int pngChannels(const Image_Format theFormat, std::array<int, 4>& theOffsets)
+{
+  switch (theFormat)
+  {
+    case Image_Format_Gray:
+      theOffsets = {0, 0, 0, 0};
+      return 1;
+    case Image_Format_RGB:
+    case Image_Format_RGB32:
+      theOffsets = {0, 1, 2, 0};
+      return 3;
+    case Image_Format_BGR:
+    case Image_Format_BGR32:
+      theOffsets = {2, 1, 0, 0};
+      return 3;
+    case Image_Format_RGBA:
+      theOffsets = {0, 1, 2, 3};
+      return 4;
+    case Image_Format_BGRA:
+      theOffsets = {2, 1, 0, 3};
+      return 4;
+    default:
+      return 0;
+  }
+}
+} // namespace
+
+// ================================================================
+// Function : crc32
+// Purpose  :
+// ================================================================
+uint32_t OccImguiPngWriter::crc32(const uint8_t* theData,
+                                  const size_t   theSize,
+                                  const uint32_t theCrc)
+{
+  const std::array<uint32_t, 256>& aTable = pngCrcTable();
+  uint32_t                         aCrc   = ~theCrc;
+  for (size_t anIter = 0; anIter < theSize; ++anIter)
+  {
+    aCrc = aTable[(aCrc ^ theData[anIter]) & 0xFFu] ^ (aCrc >> 8);
+  }
+  return ~aCrc;
+}
+
+// ================================================================
+// Function : isSupportedFormat
+// Purpose  :
+// ================================================================
+bool OccImguiPngWriter::isSupportedFormat(const Image_Format theFormat)
+{
+  std::array<int, 4> anOffsets{};
+  return pngChannels(theFormat, anOffsets) != 0;
+}
+
+// ================================================================
+// Function : encode
+// Purpose  :
+// ================================================================
+bool OccImguiPngWriter::encode(const Image_PixMap& theImage, std::vector<uint8_t>& theData)
+{
+  std::array<int, 4> anOffsets{};
+  const int          aNbChannels = pngChannels(theImage.Format(), anOffsets);
+  if (aNbChannels == 0 || theImage.IsEmpty())
+  {
+    return false;
+  }
+
+  // scanlines top-down, each prefixed by filter type 0 (none)
+  const size_t         aWidth    = theImage.SizeX();
+  const size_t         aHeight   = theImage.SizeY();
+  const size_t         aPixelSrc = theImage.SizePixelBytes();
+  const size_t         aRowSize  = 1 + aWidth * static_cast<size_t>(aNbChannels);
+  std::vector<uint8_t> aRaw(aRowSize * aHeight);
+  for (size_t aRowIter = 0; aRowIter < aHeight; ++aRowIter)
+  {
+    const uint8_t* aSrc = theImage.Row(aRowIter);
+    uint8_t*       aDst = aRaw.data() + aRowIter * aRowSize;
+    *aDst++             = 0;
+    for (size_t aColIter = 0; aColIter < aWidth; ++aColIter, aSrc += aPixelSrc)
+    {
+      for (int aChannel = 0; aChannel < aNbChannels; ++aChannel)
+      {
+        *aDst++ = aSrc[anOffsets[aChannel]];
+      }
+    }
+  }
+
+  // zlib stream of stored deflate blocks
+  std::vector<uint8_t> anIdat;
+  anIdat.reserve(aRaw.size() + (aRaw.size() / THE_PNG_MAX_STORED_BLOCK + 1) * 5 + 6);
+  anIdat.push_back(0x78);
+  anIdat.push_back(0x01);
+  size_t anOffset = 0;
+  do
+  {
+    const size_t   aBlockSize = std::min(aRaw.size() - anOffset, THE_PNG_MAX_STORED_BLOCK);
+    const bool     isLast     = anOffset + aBlockSize == aRaw.size();
+    const uint16_t aLen       = static_cast<uint16_t>(aBlockSize);
+    const uint16_t aNLen      = static_cast<uint16_t>(~aLen);
+    anIdat.push_back(isLast ? 1 : 0);
+    anIdat.push_back(static_cast<uint8_t>(aLen & 0xFFu));
+    anIdat.push_back(static_cast<uint8_t>(aLen >> 8));
+    anIdat.push_back(static_cast<uint8_t>(aNLen & 0xFFu));
+    anIdat.push_back(static_cast<uint8_t>(aNLen >> 8));
+    anIdat.insert(anIdat.end(),
+                  aRaw.begin() + static_cast<std::ptrdiff_t>(anOffset),
+                  aRaw.begin() + static_cast<std::ptrdiff_t>(anOffset + aBlockSize));
+    anOffset += aBlockSize;
+  } while (anOffset < aRaw.size());
+  appendPngUInt32(anIdat, pngAdler32(aRaw.data(), aRaw.size()));
+
+  std::vector<uint8_t> aHeader;
+  appendPngUInt32(aHeader, static_cast<uint32_t>(aWidth));
+  appendPngUInt32(aHeader, static_cast<uint32_t>(aHeight));
+  const uint8_t aColorType =
+    static_cast<uint8_t>(aNbChannels == 1 ? 0 : (aNbChannels == 3 ? 2 : 6));
+  aHeader.push_back(8); // bit depth
+  aHeader.push_back(aColorType);
+  aHeader.push_back(0); // compression
+  aHeader.push_back(0); // filter
+  aHeader.push_back(0); // interlace
+
+  theData.clear();
+  theData.reserve(sizeof(THE_PNG_SIGNATURE) + aHeader.size() + anIdat.size() + 36);
+  theData.insert(theData.end(), std::begin(THE_PNG_SIGNATURE), std::end(THE_PNG_SIGNATURE));
+  appendPngChunk(theData, "IHDR", aHeader);
+  appendPngChunk(theData, "IDAT", anIdat);
+  appendPngChunk(theData, "IEND", std::vector<uint8_t>());
+  return true;
+}
+
+// ================================================================
+// Function : write
+// Purpose  :
+// ================================================================
+bool OccImguiPngWriter::write(const Image_PixMap& theImage, const std::string& thePath)
+{
+  std::vector<uint8_t> aData;
+  if (!encode(theImage, aData))
+  {
+    return false;
+  }
+
+  std::ofstream aStream(thePath, std::ios::binary | std::ios::trunc);
+  aStream.write(reinterpret_cast<const char*>(aData.data()),
+                static_cast<std::streamsize>(aData.size()));
+  return static_cast<bool>(aStream);
+}
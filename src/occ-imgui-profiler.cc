@@ -0,0 +1,291 @@
+#include "occ_imgui/occ-imgui-profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+
+#ifndef GL_TIMESTAMP
+  #define GL_TIMESTAMP 0x8E28
+#endif
+
+namespace
+{
+//! Maximal number of timestamp query pairs in flight.
+constexpr size_t THE_PROFILER_MAX_GPU_QUERIES = 64;
+} // namespace
+
+// ================================================================
+// Function : stageName
+// Purpose  :
+// ================================================================
+const char* OccImguiProfiler::stageName(const int theStage)
+{
+  switch (theStage)
+  {
+    case Stage_Events:
+      return "Events";
+    case Stage_Update:
+      return "Update";
+    case Stage_Scene:
+      return "FlushViewEvents";
+    case Stage_GuiBuild:
+      return "ImGui build";
+    case Stage_GuiRender:
+      return "ImGui render";
+    case Stage_PlatformWindows:
+      return "Platform windows";
+    case Stage_Swap:
+      return "Swap buffers";
+  }
+  return "Unknown";
+}
+
+// ================================================================
+// Function : Scope
+// Purpose  :
+// ================================================================
+OccImguiProfiler::Scope::Scope(OccImguiProfiler& theProfiler,
+                               const Stage       theStage,
+                               const bool        theToTimeGpu)
+    : myProfiler(theProfiler),
+      myBeginUs(theProfiler.nowUs()),
+      myGpuQuery(-1),
+      myStage(theStage)
+{
+  if (theToTimeGpu && myProfiler.isEnabled())
+  {
+    myGpuQuery = myProfiler.beginGpu(theStage);
+  }
+}
+
+// ================================================================
+// Function : ~Scope
+// Purpose  :
+// ================================================================
+OccImguiProfiler::Scope::~Scope()
+{
+  if (myGpuQuery >= 0)
+  {
+    myProfiler.endGpu(myGpuQuery);
+  }
+  if (!myProfiler.isEnabled())
+  {
+    return;
+  }
+
+  Sample aSample;
+  aSample.Frame      = myProfiler.frameIndex();
+  aSample.BeginUs    = myBeginUs;
+  aSample.DurationUs = myProfiler.nowUs() - myBeginUs;
+  aSample.StageId    = myStage;
+  myProfiler.push(aSample);
+}
+
+// ================================================================
+// Function : OccImguiProfiler
+// Purpose  :
+// ================================================================
+OccImguiProfiler::OccImguiProfiler()
+    : myEpoch(std::chrono::steady_clock::now())
+{
+}
+
+// ================================================================
+// Function : nowUs
+// Purpose  :
+// ================================================================
+double OccImguiProfiler::nowUs() const
+{
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - myEpoch)
+    .count();
+}
+
+// ================================================================
+// Function : setGlContext
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::setGlContext(const Handle(OpenGl_Context)& theGlCtx)
+{
+  releaseGlResources();
+  // timestamp queries are core since OpenGL 3.3
+  if (!theGlCtx.IsNull() && theGlCtx->core33 != nullptr)
+  {
+    myGlCtx = theGlCtx;
+  }
+}
+
+// ================================================================
+// Function : releaseGlResources
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::releaseGlResources()
+{
+  if (!myGlCtx.IsNull())
+  {
+    for (GpuQuery& aQuery : myGpuQueries)
+    {
+      myGlCtx->core33->glDeleteQueries(2, aQuery.Queries);
+    }
+  }
+  myGpuQueries.clear();
+  myGlCtx.Nullify();
+}
+
+// ================================================================
+// Function : beginFrame
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::beginFrame()
+{
+  ++myFrame;
+  if (myGlCtx.IsNull())
+  {
+    return;
+  }
+
+  collectGpu();
+
+  // re-calibrate GPU clock against CPU clock to place GPU samples on the same timeline
+  GLint64 aGpuNow = 0;
+  myGlCtx->core33->glGetInteger64v(GL_TIMESTAMP, &aGpuNow);
+  myGpuOffsetUs = nowUs() - static_cast<double>(aGpuNow) / 1000.0;
+}
+
+// ================================================================
+// Function : push
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::push(const Sample& theSample)
+{
+  const size_t anIndex             = myNbWritten.load(std::memory_order_relaxed);
+  mySamples[anIndex % THE_CAPACITY] = theSample;
+  myNbWritten.store(anIndex + 1, std::memory_order_release);
+}
+
+// ================================================================
+// Function : snapshot
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::snapshot(std::vector<Sample>& theSamples, const size_t theMaxSamples) const
+{
+  const size_t aNbWritten = myNbWritten.load(std::memory_order_acquire);
+  const size_t aNbSamples = std::min({aNbWritten, THE_CAPACITY, theMaxSamples});
+  theSamples.reserve(theSamples.size() + aNbSamples);
+  for (size_t anIndex = aNbWritten - aNbSamples; anIndex < aNbWritten; ++anIndex)
+  {
+    theSamples.push_back(mySamples[anIndex % THE_CAPACITY]);
+  }
+}
+
+// ================================================================
+// Function : exportChromeTrace
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::exportChromeTrace(std::ostream& theStream) const
+{
+  std::vector<Sample> aSamples;
+  snapshot(aSamples, THE_CAPACITY);
+
+  theStream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,"
+            << "\"args\":{\"name\":\"CPU\"}},\n"
+            << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,"
+            << "\"args\":{\"name\":\"GPU\"}}";
+  theStream << std::fixed << std::setprecision(3);
+  for (const Sample& aSample : aSamples)
+  {
+    theStream << ",\n{\"name\":\"" << stageName(aSample.StageId) << "\",\"cat\":\""
+              << (aSample.IsGpu ? "gpu" : "cpu") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+              << (aSample.IsGpu ? 2 : 1) << ",\"ts\":" << aSample.BeginUs
+              << ",\"dur\":" << aSample.DurationUs << ",\"args\":{\"frame\":" << aSample.Frame
+              << "}}";
+  }
+  theStream << "\n]}\n";
+}
+
+// ================================================================
+// Function : beginGpu
+// Purpose  :
+// ================================================================
+int OccImguiProfiler::beginGpu(const Stage theStage)
+{
+  if (myGlCtx.IsNull())
+  {
+    return -1;
+  }
+
+  size_t aSlot = 0;
+  for (; aSlot < myGpuQueries.size() && myGpuQueries[aSlot].IsPending; ++aSlot)
+  {
+  }
+  if (aSlot == myGpuQueries.size())
+  {
+    if (myGpuQueries.size() >= THE_PROFILER_MAX_GPU_QUERIES)
+    {
+      // the GPU lags too far behind, skip measuring rather than stalling on results
+      return -1;
+    }
+
+    myGpuQueries.emplace_back();
+    myGlCtx->core33->glGenQueries(2, myGpuQueries.back().Queries);
+  }
+
+  GpuQuery& aQuery = myGpuQueries[aSlot];
+  aQuery.StageId   = theStage;
+  aQuery.Frame     = myFrame;
+  aQuery.IsPending = true;
+  myGlCtx->core33->glQueryCounter(aQuery.Queries[0], GL_TIMESTAMP);
+  return static_cast<int>(aSlot);
+}
+
+// ================================================================
+// Function : endGpu
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::endGpu(const int theQuery)
+{
+  if (!myGlCtx.IsNull())
+  {
+    myGlCtx->core33->glQueryCounter(myGpuQueries[static_cast<size_t>(theQuery)].Queries[1],
+                                    GL_TIMESTAMP);
+  }
+}
+
+// ================================================================
+// Function : collectGpu
+// Purpose  :
+// ================================================================
+void OccImguiProfiler::collectGpu()
+{
+  for (GpuQuery& aQuery : myGpuQueries)
+  {
+    if (!aQuery.IsPending)
+    {
+      continue;
+    }
+
+    // the end query finishes last, so both results are available once it is
+    GLint isAvailable = 0;
+    myGlCtx->core33->glGetQueryObjectiv(aQuery.Queries[1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+    if (isAvailable == 0)
+    {
+      continue;
+    }
+
+    GLuint64 aBegin = 0, anEnd = 0;
+    myGlCtx->core33->glGetQueryObjectui64v(aQuery.Queries[0], GL_QUERY_RESULT, &aBegin);
+    myGlCtx->core33->glGetQueryObjectui64v(aQuery.Queries[1], GL_QUERY_RESULT, &anEnd);
+    aQuery.IsPending = false;
+    if (!myIsEnabled)
+    {
+      continue;
+    }
+
+    Sample aSample;
+    aSample.Frame      = aQuery.Frame;
+    aSample.BeginUs    = static_cast<double>(aBegin) / 1000.0 + myGpuOffsetUs;
+    aSample.DurationUs = static_cast<double>(anEnd - aBegin) / 1000.0;
+    aSample.StageId    = aQuery.StageId;
+    aSample.IsGpu      = true;
+    push(aSample);
+  }
+}
@@ -0,0 +1,368 @@
+#include "occ_imgui/occ-imgui-program-cache.h"
+
+#include <opencascade/OSD_Environment.hxx>
+#include <opencascade/OSD_Process.hxx>
+#include <opencascade/OpenGl_GlCore41.hxx>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+  #define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+  #define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+  #define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace
+{
+//! File signature.
+constexpr char THE_PROGRAM_CACHE_MAGIC[8] = {'O', 'C', 'C', 'I', 'P', 'R', 'O', 'G'};
+
+//! File format version; bump on any layout change.
+constexpr uint32_t THE_PROGRAM_CACHE_VERSION = 1;
+
+//! File extension of cache entries.
+constexpr const char* THE_PROGRAM_CACHE_EXT = ".bin";
+
+//! File header, followed by Size bytes of the binary.
+struct ProgramCacheHeader
+{
+  char     Magic[8];
+  uint32_t Version;
+  uint32_t Format; //!< binary format reported by glGetProgramBinary()
+  uint64_t Key;
+  uint64_t Size;
+};
+
+static_assert(sizeof(ProgramCacheHeader) == 32, "unexpected padding in ProgramCacheHeader");
+
+//! Redirection of glLinkProgram() shared by all OpenGL contexts of the process.
+struct ProgramCacheHook
+{
+  decltype(OpenGl_GlCore20::glLinkProgram) DriverLink = nullptr; //!< glLinkProgram() of the driver
+  OccImguiProgramCache*                    Cache      = nullptr; //!< cache handling the calls
+};
+
+//! Return the redirection of glLinkProgram().
+ProgramCacheHook& programCacheHook()
+{
+  static ProgramCacheHook aHook;
+  return aHook;
+}
+
+//! Continue 64-bit FNV-1a hash with the text.
+uint64_t hashProgramCacheText(uint64_t theHash, const std::string& theText)
+{
+  for (const char aChar : theText)
+  {
+    theHash ^= static_cast<uint8_t>(aChar);
+    theHash *= 1099511628211ULL;
+  }
+  return theHash;
+}
+
+//! Return the string of glGetString(), or an empty string.
+std::string programCacheGlString(const Handle(OpenGl_Context)& theGlCtx, const GLenum theName)
+{
+  const GLubyte* aString = theGlCtx->core11fwd->glGetString(theName);
+  return aString != nullptr ? std::string(reinterpret_cast<const char*>(aString)) : std::string();
+}
+} // namespace
+
+// ================================================================
+// Function : defaultDirectory
+// Purpose  :
+// ================================================================
+std::filesystem::path OccImguiProgramCache::defaultDirectory()
+{
+  const TCollection_AsciiString aDir = OSD_Environment("OCC_IMGUI_PROGRAM_CACHE_DIR").Value();
+  if (!aDir.IsEmpty())
+  {
+    return std::filesystem::u8path(aDir.ToCString());
+  }
+
+  std::error_code anError;
+  return std::filesystem::temp_directory_path(anError) / "occ-imgui" / "program-cache";
+}
+
+// ================================================================
+// Function : programKey
+// Purpose  :
+// ================================================================
+uint64_t OccImguiProgramCache::programKey(const std::string& theDriver,
+                                          const std::string& theSources)
+{
+  uint64_t aHash = hashProgramCacheText(14695981039346656037ULL, theDriver);
+  aHash          = hashProgramCacheText(aHash, std::string(1, '\0'));
+  aHash          = hashProgramCacheText(aHash, theSources);
+  return hashProgramCacheText(aHash, std::to_string(THE_PROGRAM_CACHE_VERSION));
+}
+
+// ================================================================
+// Function : OccImguiProgramCache
+// Purpose  :
+// ================================================================
+OccImguiProgramCache::OccImguiProgramCache(const std::filesystem::path& theDirectory)
+    : myDirectory(theDirectory)
+{
+  std::error_code anError;
+  std::filesystem::create_directories(myDirectory, anError);
+}
+
+// ================================================================
+// Function : ~OccImguiProgramCache
+// Purpose  :
+// ================================================================
+OccImguiProgramCache::~OccImguiProgramCache()
+{
+  if (programCacheHook().Cache == this)
+  {
+    programCacheHook().Cache = nullptr;
+  }
+}
+
+// ================================================================
+// Function : install
+// Purpose  :
+// ================================================================
+bool OccImguiProgramCache::install(const Handle(OpenGl_Context)& theGlCtx)
+{
+  if (theGlCtx.IsNull() || theGlCtx->core20fwd == nullptr)
+  {
+    return false;
+  }
+
+  if (myGlCtx.IsNull())
+  {
+    // program binaries are core since OpenGL 4.1, yet drivers may offer no format at all
+    GLint aNbFormats = 0;
+    if (theGlCtx->core41 != nullptr)
+    {
+      theGlCtx->core11fwd->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &aNbFormats);
+    }
+    if (aNbFormats <= 0)
+    {
+      return false;
+    }
+
+    myGlCtx  = theGlCtx;
+    myDriver = programCacheGlString(theGlCtx, GL_VENDOR) + "\n"
+               + programCacheGlString(theGlCtx, GL_RENDERER) + "\n"
+               + programCacheGlString(theGlCtx, GL_VERSION);
+  }
+
+  // each OCCT context has its own function table, all of them share the driver function
+  ProgramCacheHook& aHook = programCacheHook();
+  if (theGlCtx->core20fwd->glLinkProgram != &linkProgramHook)
+  {
+    aHook.DriverLink                   = theGlCtx->core20fwd->glLinkProgram;
+    theGlCtx->core20fwd->glLinkProgram = &linkProgramHook;
+  }
+  aHook.Cache = this;
+  return true;
+}
+
+// ================================================================
+// Function : linkProgramHook
+// Purpose  :
+// ================================================================
+void APIENTRY OccImguiProgramCache::linkProgramHook(const GLuint theProgram)
+{
+  const ProgramCacheHook& aHook = programCacheHook();
+  if (aHook.Cache != nullptr)
+  {
+    aHook.Cache->linkProgram(theProgram);
+  }
+  else
+  {
+    aHook.DriverLink(theProgram);
+  }
+}
+
+// ================================================================
+// Function : linkProgram
+// Purpose  :
+// ================================================================
+void OccImguiProgramCache::linkProgram(const GLuint theProgram)
+{
+  // shaders have been compiled already, restoring the binary skips linking,
+  // where most drivers optimize and generate the code
+  const OpenGl_GlCore41* aGl  = myGlCtx->core41;
+  const uint64_t         aKey = programKey(myDriver, programSources(theProgram));
+
+  std::vector<uint8_t> aBinary;
+  uint32_t             aFormat  = 0;
+  GLint                isLinked = GL_FALSE;
+  if (load(aKey, aFormat, aBinary))
+  {
+    aGl->glProgramBinary(theProgram, aFormat, aBinary.data(), static_cast<GLsizei>(aBinary.size()));
+    aGl->glGetProgramiv(theProgram, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_TRUE)
+    {
+      ++myNbLoaded;
+      return;
+    }
+
+    // e.g. a driver update keeping the version string; the binary is replaced below
+    ++myNbRejected;
+  }
+
+  aGl->glProgramParameteri(theProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  programCacheHook().DriverLink(theProgram);
+  ++myNbLinked;
+
+  GLint aLength = 0;
+  aGl->glGetProgramiv(theProgram, GL_LINK_STATUS, &isLinked);
+  aGl->glGetProgramiv(theProgram, GL_PROGRAM_BINARY_LENGTH, &aLength);
+  if (isLinked != GL_TRUE || aLength <= 0)
+  {
+    return;
+  }
+
+  GLenum  aBinaryFormat = 0;
+  GLsizei aBinaryLength = 0;
+  aBinary.resize(static_cast<size_t>(aLength));
+  aGl->glGetProgramBinary(theProgram, aLength, &aBinaryLength, &aBinaryFormat, aBinary.data());
+  if (aBinaryLength > 0)
+  {
+    aBinary.resize(static_cast<size_t>(aBinaryLength));
+    store(aKey, static_cast<uint32_t>(aBinaryFormat), aBinary);
+  }
+}
+
+// ================================================================
+// Function : programSources
+// Purpose  :
+// ================================================================
+std::string OccImguiProgramCache::programSources(const GLuint theProgram) const
+{
+  const OpenGl_GlCore20* aGl        = myGlCtx->core20fwd;
+  GLint                  aNbShaders = 0;
+  aGl->glGetProgramiv(theProgram, GL_ATTACHED_SHADERS, &aNbShaders);
+  if (aNbShaders <= 0)
+  {
+    return std::string();
+  }
+
+  std::vector<GLuint> aShaders(static_cast<size_t>(aNbShaders));
+  aGl->glGetAttachedShaders(theProgram, aNbShaders, &aNbShaders, aShaders.data());
+  aShaders.resize(static_cast<size_t>(aNbShaders));
+
+  std::string aSources;
+  for (const GLuint aShader : aShaders)
+  {
+    GLint aType   = 0;
+    GLint aLength = 0;
+    aGl->glGetShaderiv(aShader, GL_SHADER_TYPE, &aType);
+    aGl->glGetShaderiv(aShader, GL_SHADER_SOURCE_LENGTH, &aLength);
+    std::string aSource(static_cast<size_t>(std::max(aLength, 1)), '\0');
+    GLsizei     aSourceLength = 0;
+    aGl->glGetShaderSource(aShader, aLength, &aSourceLength, aSource.data());
+    aSource.resize(static_cast<size_t>(std::max(aSourceLength, 0)));
+    aSources += std::to_string(aType) + "\n" + aSource + "\n";
+  }
+  return aSources;
+}
+
+// ================================================================
+// Function : entryPath
+// Purpose  :
+// ================================================================
+std::filesystem::path OccImguiProgramCache::entryPath(const uint64_t theKey) const
+{
+  std::ostringstream aName;
+  aName << std::hex << std::setw(16) << std::setfill('0') << theKey << THE_PROGRAM_CACHE_EXT;
+  return myDirectory / aName.str();
+}
+
+// ================================================================
+// Function : load
+// Purpose  :
+// ================================================================
+bool OccImguiProgramCache::load(const uint64_t        theKey,
+                                uint32_t&             theFormat,
+                                std::vector<uint8_t>& theBinary) const
+{
+  const std::filesystem::path aPath = entryPath(theKey);
+  std::error_code             anError;
+  const uint64_t              aFileSize = std::filesystem::file_size(aPath, anError);
+  std::ifstream               aStream(aPath, std::ios::binary);
+  if (anError || !aStream)
+  {
+    return false;
+  }
+
+  // the size is checked against the file before allocating, so that a corrupted header
+  // is a cache miss rather than a huge allocation
+  ProgramCacheHeader aHeader{};
+  aStream.read(reinterpret_cast<char*>(&aHeader), sizeof(aHeader));
+  if (!aStream
+      || std::memcmp(aHeader.Magic, THE_PROGRAM_CACHE_MAGIC, sizeof(THE_PROGRAM_CACHE_MAGIC)) != 0
+      || aHeader.Version != THE_PROGRAM_CACHE_VERSION || aHeader.Key != theKey
+      || aHeader.Size == 0 || aHeader.Size > aFileSize - sizeof(aHeader))
+  {
+    return false;
+  }
+
+  std::vector<uint8_t> aBinary(static_cast<size_t>(aHeader.Size));
+  aStream.read(reinterpret_cast<char*>(aBinary.data()), static_cast<std::streamsize>(aHeader.Size));
+  if (!aStream)
+  {
+    return false;
+  }
+
+  theFormat = aHeader.Format;
+  theBinary = std::move(aBinary);
+  return true;
+}
+
+// ================================================================
+// Function : store
+// Purpose  :
+// ================================================================
+void OccImguiProgramCache::store(const uint64_t              theKey,
+                                 const uint32_t              theFormat,
+                                 const std::vector<uint8_t>& theBinary) const
+{
+  ProgramCacheHeader aHeader{};
+  std::memcpy(aHeader.Magic, THE_PROGRAM_CACHE_MAGIC, sizeof(THE_PROGRAM_CACHE_MAGIC));
+  aHeader.Version = THE_PROGRAM_CACHE_VERSION;
+  aHeader.Format  = theFormat;
+  aHeader.Key     = theKey;
+  aHeader.Size    = theBinary.size();
+
+  // write into a temporary file first, so that other sessions never read a partial entry
+  const std::filesystem::path aPath = entryPath(theKey);
+  std::filesystem::path       aTmpPath(aPath);
+  aTmpPath += ".tmp" + std::to_string(OSD_Process().ProcessId()) + "-"
+              + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  {
+    std::ofstream aStream(aTmpPath, std::ios::binary | std::ios::trunc);
+    aStream.write(reinterpret_cast<const char*>(&aHeader), sizeof(aHeader));
+    aStream.write(reinterpret_cast<const char*>(theBinary.data()),
+                  static_cast<std::streamsize>(theBinary.size()));
+    if (!aStream)
+    {
+      aStream.close();
+      std::error_code anError;
+      std::filesystem::remove(aTmpPath, anError);
+      return;
+    }
+  }
+
+  std::error_code anError;
+  std::filesystem::rename(aTmpPath, aPath, anError);
+  if (anError)
+  {
+    std::filesystem::remove(aTmpPath, anError);
+  }
+}
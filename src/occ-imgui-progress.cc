@@ -0,0 +1,31 @@
+#include "occ_imgui/occ-imgui-progress.h"
+
+#include <opencascade/Message_ProgressScope.hxx>
+
+// ================================================================
+// Function : stepName
+// Purpose  :
+// ================================================================
+TCollection_AsciiString OccImguiProgress::stepName() const
+{
+  std::lock_guard<std::mutex> aLock(myMutex);
+  return myStepName;
+}
+
+// ================================================================
+// Function : Show
+// Purpose  :
+// ================================================================
+void OccImguiProgress::Show(const Message_ProgressScope& theScope, const Standard_Boolean)
+{
+  for (const Message_ProgressScope* aScope = &theScope; aScope != nullptr;
+       aScope                              = aScope->Parent())
+  {
+    if (aScope->Name() != nullptr)
+    {
+      std::lock_guard<std::mutex> aLock(myMutex);
+      myStepName = aScope->Name();
+      return;
+    }
+  }
+}
@@ -0,0 +1,240 @@
+#include "occ_imgui/occ-imgui-scene-index.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+//! Return lower case copy of the text.
+std::string toLowerSceneText(std::string theText)
+{
+  for (char& aChar : theText)
+  {
+    aChar = static_cast<char>(std::tolower(static_cast<unsigned char>(aChar)));
+  }
+  return theText;
+}
+} // namespace
+
+// ================================================================
+// Function : add
+// Purpose  :
+// ================================================================
+size_t OccImguiSceneIndex::add()
+{
+  // new objects are always beyond the scan position and get tested against the filter
+  myEntries.emplace_back();
+  ++myNbObjects;
+  return myEntries.size() - 1;
+}
+
+// ================================================================
+// Function : remove
+// Purpose  :
+// ================================================================
+void OccImguiSceneIndex::remove(const size_t theId)
+{
+  Entry& anEntry = myEntries[theId];
+  if (anEntry.IsRemoved)
+  {
+    return;
+  }
+
+  if (anEntry.IsIndexed)
+  {
+    --myNbIndexed;
+  }
+  anEntry           = Entry();
+  anEntry.IsRemoved = true;
+  --myNbObjects;
+  if (const auto aRow = std::lower_bound(myRows.begin(), myRows.end(), theId);
+      aRow != myRows.end() && *aRow == theId)
+  {
+    myRows.erase(aRow);
+  }
+}
+
+// ================================================================
+// Function : invalidate
+// Purpose  :
+// ================================================================
+void OccImguiSceneIndex::invalidate(const size_t theId)
+{
+  Entry& anEntry = myEntries[theId];
+  if (anEntry.IsRemoved)
+  {
+    return;
+  }
+
+  if (anEntry.IsIndexed)
+  {
+    anEntry.Name.clear();
+    anEntry.Attributes.clear();
+    anEntry.SearchText.clear();
+    anEntry.IsIndexed = false;
+    --myNbIndexed;
+  }
+  myNextIndexed = std::min(myNextIndexed, theId);
+
+  // objects tested already are matched again at once, pending ones are tested by update()
+  if (myTerms.empty() || isPending(theId))
+  {
+    return;
+  }
+  const auto aRow     = std::lower_bound(myRows.begin(), myRows.end(), theId);
+  const bool isListed = aRow != myRows.end() && *aRow == theId;
+  if (matches(theId))
+  {
+    if (!isListed)
+    {
+      myRows.insert(aRow, theId);
+    }
+  }
+  else if (isListed)
+  {
+    myRows.erase(aRow);
+  }
+}
+
+// ================================================================
+// Function : name
+// Purpose  :
+// ================================================================
+const std::string& OccImguiSceneIndex::name(const size_t theId)
+{
+  return fetch(theId).Name;
+}
+
+// ================================================================
+// Function : attributes
+// Purpose  :
+// ================================================================
+const std::string& OccImguiSceneIndex::attributes(const size_t theId)
+{
+  return fetch(theId).Attributes;
+}
+
+// ================================================================
+// Function : setFilter
+// Purpose  :
+// ================================================================
+void OccImguiSceneIndex::setFilter(const std::string& theFilter)
+{
+  if (theFilter == myFilter)
+  {
+    return;
+  }
+
+  // every term of the previous filter is a prefix of a term of the extended one,
+  // so objects not matching the previous filter cannot match the new one
+  const bool isRefined = !myFilter.empty() && theFilter.compare(0, myFilter.size(), myFilter) == 0;
+  if (isRefined)
+  {
+    std::vector<size_t> aCandidates = std::move(myRows);
+    aCandidates.insert(aCandidates.end(),
+                       myCandidates.begin() + static_cast<std::ptrdiff_t>(myCandidatePos),
+                       myCandidates.end());
+    myCandidates = std::move(aCandidates);
+  }
+  else
+  {
+    myCandidates.clear();
+    myScanPos = 0;
+  }
+  myCandidatePos = 0;
+  myRows.clear();
+
+  myFilter = theFilter;
+  myTerms.clear();
+  const std::string aFilter = toLowerSceneText(theFilter);
+  for (size_t aPos = 0; aPos < aFilter.size();)
+  {
+    const size_t aStart = aFilter.find_first_not_of(" \t", aPos);
+    if (aStart == std::string::npos)
+    {
+      break;
+    }
+    const size_t anEnd = std::min(aFilter.find_first_of(" \t", aStart), aFilter.size());
+    myTerms.push_back(aFilter.substr(aStart, anEnd - aStart));
+    aPos = anEnd;
+  }
+}
+
+// ================================================================
+// Function : update
+// Purpose  :
+// ================================================================
+bool OccImguiSceneIndex::update(const size_t theMaxSteps)
+{
+  // candidates all precede the scan position, so matches are appended in insertion order
+  size_t aStep = 0;
+  for (; aStep < theMaxSteps && isFiltering(); ++aStep)
+  {
+    const size_t anId =
+      myCandidatePos < myCandidates.size() ? myCandidates[myCandidatePos++] : myScanPos++;
+    if (!myEntries[anId].IsRemoved && matches(anId))
+    {
+      myRows.push_back(anId);
+    }
+  }
+  if (!isFiltering())
+  {
+    myCandidates.clear();
+    myCandidatePos = 0;
+  }
+
+  for (; aStep < theMaxSteps && myNextIndexed < myEntries.size(); ++aStep, ++myNextIndexed)
+  {
+    if (!myEntries[myNextIndexed].IsRemoved)
+    {
+      fetch(myNextIndexed);
+    }
+  }
+  return isComplete();
+}
+
+// ================================================================
+// Function : fetch
+// Purpose  :
+// ================================================================
+OccImguiSceneIndex::Entry& OccImguiSceneIndex::fetch(const size_t theId)
+{
+  Entry& anEntry = myEntries[theId];
+  if (!anEntry.IsIndexed && !anEntry.IsRemoved)
+  {
+    myText(theId, anEntry.Name, anEntry.Attributes);
+    anEntry.SearchText = toLowerSceneText(anEntry.Name + "\n" + anEntry.Attributes);
+    anEntry.IsIndexed  = true;
+    ++myNbIndexed;
+  }
+  return anEntry;
+}
+
+// ================================================================
+// Function : matches
+// Purpose  :
+// ================================================================
+bool OccImguiSceneIndex::matches(const size_t theId)
+{
+  if (myTerms.empty())
+  {
+    return true;
+  }
+
+  const std::string& aText = fetch(theId).SearchText;
+  return std::all_of(myTerms.begin(), myTerms.end(), [&aText](const std::string& theTerm) {
+    return aText.find(theTerm) != std::string::npos;
+  });
+}
+
+// ================================================================
+// Function : isPending
+// Purpose  :
+// ================================================================
+bool OccImguiSceneIndex::isPending(const size_t theId) const
+{
+  return theId >= myScanPos
+         || std::binary_search(myCandidates.begin() + static_cast<std::ptrdiff_t>(myCandidatePos),
+                               myCandidates.end(),
+                               theId);
+}
@@ -0,0 +1,184 @@
+#include "occ_imgui/occ-imgui-scene-lod.h"
+
+#include <opencascade/AIS_ConnectedInteractive.hxx>
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/Graphic3d_Camera.hxx>
+#include <opencascade/Graphic3d_ZLayerSettings.hxx>
+#include <opencascade/V3d_Viewer.hxx>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+//! Proxies are swapped back only once they exceed the proxy size by this factor,
+//! so that shapes close to the threshold do not flicker while the camera moves.
+constexpr double THE_SCENE_LOD_HYSTERESIS = 1.25;
+
+//! Screen size reported for shapes crossing the near plane.
+constexpr double THE_SCENE_LOD_HUGE_SIZE = 1.0e10;
+} // namespace
+
+// ================================================================
+// Function : setupView
+// Purpose  :
+// ================================================================
+void OccImguiSceneLod::setupView(const Handle(V3d_View)& theView) const
+{
+  theView->ChangeRenderingParams().FrustumCullingState =
+    Graphic3d_RenderingParams::FrustumCulling_On;
+
+  Graphic3d_ZLayerSettings aSettings =
+    theView->Viewer()->ZLayerSettings(Graphic3d_ZLayerId_Default);
+  if (myCullingSize > 0.0f)
+  {
+    aSettings.SetCullingSize(myCullingSize);
+  }
+  else
+  {
+    aSettings.DisableCullingSize();
+  }
+  theView->Viewer()->SetZLayerSettings(Graphic3d_ZLayerId_Default, aSettings);
+}
+
+// ================================================================
+// Function : update
+// Purpose  :
+// ================================================================
+bool OccImguiSceneLod::update(const Handle(AIS_InteractiveContext)& theCtx,
+                              const std::vector<Handle(V3d_View)>&  theViews,
+                              const double                          theTime,
+                              const double                          theInterval)
+{
+  bool isCameraChanged = myCameraStates.size() != theViews.size();
+  for (size_t aViewIter = 0; !isCameraChanged && aViewIter < theViews.size(); ++aViewIter)
+  {
+    isCameraChanged =
+      myCameraStates[aViewIter].IsChanged(theViews[aViewIter]->Camera()->WorldViewProjState());
+  }
+  if (!myToUpdateAll && (!isCameraChanged || theTime - myUpdateTime < theInterval))
+  {
+    return false;
+  }
+
+  // views not laid out yet are skipped
+  std::vector<Handle(V3d_View)> aViews;
+  std::vector<int>              aHeights;
+  for (const Handle(V3d_View)& aView : theViews)
+  {
+    Standard_Integer aWidth = 0, aHeight = 0;
+    aView->Window()->Size(aWidth, aHeight);
+    if (aHeight > 0)
+    {
+      aViews.push_back(aView);
+      aHeights.push_back(aHeight);
+    }
+  }
+  if (aViews.empty())
+  {
+    return false;
+  }
+
+  myToUpdateAll = false;
+  myUpdateTime  = theTime;
+  myCameraStates.clear();
+  for (const Handle(V3d_View)& aView : theViews)
+  {
+    myCameraStates.push_back(aView->Camera()->WorldViewProjState());
+  }
+
+  bool                  isChanged = false;
+  AIS_ListOfInteractive aDisplayed;
+  theCtx->DisplayedObjects(aDisplayed);
+  myNbProxies = 0;
+  for (AIS_ListOfInteractive::Iterator anObjIter(aDisplayed); anObjIter.More(); anObjIter.Next())
+  {
+    const Handle(AIS_InteractiveObject)& anObject = anObjIter.Value();
+    double                               aSize    = -1.0;
+    for (size_t aViewIter = 0; aViewIter < aViews.size(); ++aViewIter)
+    {
+      aSize = std::max(aSize, screenSize(anObject, aViews[aViewIter], aHeights[aViewIter]));
+    }
+    if (aSize < 0.0)
+    {
+      continue;
+    }
+
+    const bool   isProxy = anObject->DisplayMode() == THE_PROXY_MODE;
+    const double aThreshold =
+      isProxy ? myProxySize * THE_SCENE_LOD_HYSTERESIS : static_cast<double>(myProxySize);
+    const bool toProxy = myIsEnabled && aSize < aThreshold;
+    if (toProxy != isProxy)
+    {
+      theCtx->SetDisplayMode(anObject, toProxy ? THE_PROXY_MODE : AIS_Shaded, false);
+      isChanged = true;
+    }
+    if (toProxy)
+    {
+      ++myNbProxies;
+    }
+  }
+  return isChanged;
+}
+
+// ================================================================
+// Function : boundingBox
+// Purpose  :
+// ================================================================
+bool OccImguiSceneLod::boundingBox(const Handle(AIS_InteractiveObject)& theObject, Bnd_Box& theBox)
+{
+  // shape bounding boxes are cached by AIS_Shape; instances transform the box of their prototype
+  if (const Handle(AIS_Shape) aShape = Handle(AIS_Shape)::DownCast(theObject); !aShape.IsNull())
+  {
+    theBox = aShape->BoundingBox();
+  }
+  else if (const Handle(AIS_ConnectedInteractive) anInstance =
+             Handle(AIS_ConnectedInteractive)::DownCast(theObject);
+           !anInstance.IsNull())
+  {
+    const Handle(AIS_Shape) aPrototype = Handle(AIS_Shape)::DownCast(anInstance->ConnectedTo());
+    if (aPrototype.IsNull())
+    {
+      return false;
+    }
+    theBox = aPrototype->BoundingBox().Transformed(anInstance->LocalTransformation());
+  }
+  else
+  {
+    return false;
+  }
+  return !theBox.IsVoid();
+}
+
+// ================================================================
+// Function : screenSize
+// Purpose  :
+// ================================================================
+double OccImguiSceneLod::screenSize(const Handle(AIS_InteractiveObject)& theObject,
+                                    const Handle(V3d_View)&               theView,
+                                    const int                             theViewHeight) const
+{
+  Bnd_Box aBox;
+  if (!boundingBox(theObject, aBox))
+  {
+    return -1.0;
+  }
+
+  // bounding sphere of the box projected at its depth
+  const gp_Pnt                    aMin    = aBox.CornerMin();
+  const gp_Pnt                    aMax    = aBox.CornerMax();
+  const gp_Pnt                    aCenter((aMin.XYZ() + aMax.XYZ()) * 0.5);
+  const double                    aRadius = 0.5 * aMin.Distance(aMax);
+  const Handle(Graphic3d_Camera)& aCamera = theView->Camera();
+  double                          aWorldPerPixel = aCamera->Scale() / theViewHeight;
+  if (!aCamera->IsOrthographic())
+  {
+    const double aDepth = gp_Vec(aCamera->Eye(), aCenter).Dot(gp_Vec(aCamera->Direction()));
+    if (aDepth <= aRadius)
+    {
+      return THE_SCENE_LOD_HUGE_SIZE;
+    }
+    aWorldPerPixel = 2.0 * aDepth * std::tan(aCamera->FOVy() * M_PI / 360.0) / theViewHeight;
+  }
+  return 2.0 * aRadius / aWorldPerPixel;
+}
@@ -0,0 +1,351 @@
+#include "occ_imgui/occ-imgui-snapshot-batch.h"
+
+#include <opencascade/OSD_Parallel.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+//! Quote the argument for the command processor used by std::system().
+std::string quoteBatchArgument(const std::string& theArg)
+{
+#if defined(_WIN32)
+  return "\"" + theArg + "\"";
+#else
+  std::string aQuoted = "'";
+  for (const char aChar : theArg)
+  {
+    aQuoted += aChar == '\'' ? std::string("'\\''") : std::string(1, aChar);
+  }
+  return aQuoted + "'";
+#endif
+}
+
+//! Return milliseconds elapsed since the time point.
+double batchMillisSince(const std::chrono::steady_clock::time_point& theFrom)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - theFrom)
+    .count();
+}
+} // namespace
+
+// ================================================================
+// Function : partition
+// Purpose  :
+// ================================================================
+std::vector<std::vector<size_t>> OccImguiSnapshotBatch::partition(
+  const std::vector<uintmax_t>& theCosts,
+  const int                     theNbWorkers)
+{
+  const size_t aNbWorkers =
+    std::max<size_t>(1, std::min(theCosts.size(), static_cast<size_t>(std::max(theNbWorkers, 1))));
+  std::vector<size_t> anOrder(theCosts.size());
+  std::iota(anOrder.begin(), anOrder.end(), size_t(0));
+  std::stable_sort(anOrder.begin(), anOrder.end(), [&theCosts](size_t theLeft, size_t theRight) {
+    return theCosts[theLeft] > theCosts[theRight];
+  });
+
+  std::vector<std::vector<size_t>> aParts(aNbWorkers);
+  std::vector<uintmax_t>           aLoads(aNbWorkers, 0);
+  for (const size_t anItem : anOrder)
+  {
+    const size_t aWorker =
+      static_cast<size_t>(std::min_element(aLoads.begin(), aLoads.end()) - aLoads.begin());
+    aParts[aWorker].push_back(anItem);
+    aLoads[aWorker] += theCosts[anItem] + 1;
+  }
+  for (std::vector<size_t>& aPart : aParts)
+  {
+    std::sort(aPart.begin(), aPart.end());
+  }
+  return aParts;
+}
+
+// ================================================================
+// Function : assignImageNames
+// Purpose  :
+// ================================================================
+void OccImguiSnapshotBatch::assignImageNames(std::vector<GlfwOcctSnapshot::Model>& theModels)
+{
+  std::set<std::string> aUsedNames;
+  for (const GlfwOcctSnapshot::Model& aModel : theModels)
+  {
+    if (!aModel.Name.empty())
+    {
+      aUsedNames.insert(aModel.Name);
+    }
+  }
+  for (GlfwOcctSnapshot::Model& aModel : theModels)
+  {
+    if (!aModel.Name.empty())
+    {
+      continue;
+    }
+
+    const std::string aStem = std::filesystem::path(aModel.Path).stem().string();
+    std::string       aName = aStem;
+    for (int aSuffix = 2; aUsedNames.count(aName) != 0; ++aSuffix)
+    {
+      aName = aStem + "-" + std::to_string(aSuffix);
+    }
+    aUsedNames.insert(aName);
+    aModel.Name = aName;
+  }
+}
+
+// ================================================================
+// Function : readModelList
+// Purpose  :
+// ================================================================
+bool OccImguiSnapshotBatch::readModelList(const std::string&                    thePath,
+                                          std::vector<GlfwOcctSnapshot::Model>& theModels)
+{
+  std::ifstream aStream(thePath);
+  if (!aStream)
+  {
+    return false;
+  }
+
+  std::string aLine;
+  while (std::getline(aStream, aLine))
+  {
+    if (!aLine.empty() && aLine.back() == '\r')
+    {
+      aLine.pop_back();
+    }
+    if (aLine.empty() || aLine.front() == '#')
+    {
+      continue;
+    }
+
+    GlfwOcctSnapshot::Model aModel;
+    const size_t            aTab = aLine.find('\t');
+    aModel.Path                  = aLine.substr(0, aTab);
+    if (aTab != std::string::npos)
+    {
+      aModel.Name = aLine.substr(aTab + 1);
+    }
+    theModels.push_back(aModel);
+  }
+  return true;
+}
+
+// ================================================================
+// Function : writeModelList
+// Purpose  :
+// ================================================================
+bool OccImguiSnapshotBatch::writeModelList(const std::string&                          thePath,
+                                           const std::vector<GlfwOcctSnapshot::Model>& theModels)
+{
+  std::ofstream aStream(thePath, std::ios::trunc);
+  for (const GlfwOcctSnapshot::Model& aModel : theModels)
+  {
+    aStream << aModel.Path << '\t' << aModel.Name << '\n';
+  }
+  return static_cast<bool>(aStream);
+}
+
+// ================================================================
+// Function : performWorker
+// Purpose  :
+// ================================================================
+int OccImguiSnapshotBatch::performWorker(const GlfwOcctSnapshot::Parameters& theParams,
+                                         const std::string&                  theResultsPath)
+{
+  GlfwOcctSnapshot::Parameters aParams = theParams;
+  assignImageNames(aParams.Models);
+  GlfwOcctSnapshot aSnapshot;
+  if (!aSnapshot.perform(aParams))
+  {
+    std::cerr << "Unable to create an offscreen OpenGL viewer" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream aStream(theResultsPath, std::ios::trunc);
+  GlfwOcctSnapshot::dumpResults(aStream, aSnapshot.results());
+  if (!aStream)
+  {
+    std::cerr << "Unable to write '" << theResultsPath << "'" << std::endl;
+    return EXIT_FAILURE;
+  }
+  return aSnapshot.nbFailed() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ================================================================
+// Function : perform
+// Purpose  :
+// ================================================================
+int OccImguiSnapshotBatch::perform(const Parameters& theParams)
+{
+  const auto aStart = std::chrono::steady_clock::now();
+  myParams          = theParams;
+  myWorkers.clear();
+  assignImageNames(myParams.Snapshot.Models);
+  if (myParams.ManifestPath.empty())
+  {
+    myParams.ManifestPath =
+      (std::filesystem::path(myParams.Snapshot.OutputDir) / "manifest.json").string();
+  }
+  if (myParams.NbWorkers <= 0)
+  {
+    myParams.NbWorkers = std::max(OSD_Parallel::NbLogicalProcessors() / 2, 1);
+  }
+
+  std::error_code anError;
+  std::filesystem::create_directories(myParams.Snapshot.OutputDir, anError);
+
+  // file size is a good enough estimate of reading and meshing time
+  std::vector<uintmax_t> aCosts;
+  for (const GlfwOcctSnapshot::Model& aModel : myParams.Snapshot.Models)
+  {
+    const uintmax_t aSize = std::filesystem::file_size(aModel.Path, anError);
+    aCosts.push_back(anError ? 0 : aSize);
+  }
+  for (const std::vector<size_t>& aPart : partition(aCosts, myParams.NbWorkers))
+  {
+    Worker aWorker;
+    for (const size_t aModelIndex : aPart)
+    {
+      aWorker.Models.push_back(myParams.Snapshot.Models[aModelIndex]);
+    }
+    myWorkers.push_back(aWorker);
+  }
+
+  if (myWorkers.size() == 1)
+  {
+    // a single worker renders within this process
+    Worker&                      aWorker = myWorkers.front();
+    GlfwOcctSnapshot::Parameters aParams = myParams.Snapshot;
+    aParams.Models                       = aWorker.Models;
+    GlfwOcctSnapshot aSnapshot;
+    if (!aSnapshot.perform(aParams))
+    {
+      std::cerr << "Unable to create an offscreen OpenGL viewer" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::ostringstream aResults;
+    GlfwOcctSnapshot::dumpResults(aResults, aSnapshot.results());
+    aWorker.Results = aResults.str();
+    aWorker.WallMs  = batchMillisSince(aStart);
+    aWorker.IsOk    = aSnapshot.nbFailed() == 0;
+  }
+  else
+  {
+    // worker processes exchange model lists and results through files next to the manifest
+    const std::filesystem::path aManifest(myParams.ManifestPath);
+    const std::string           aTmpBase = (aManifest.parent_path() / aManifest.stem()).string();
+    std::vector<std::thread>    aThreads;
+    for (size_t aWorkerIter = 0; aWorkerIter < myWorkers.size(); ++aWorkerIter)
+    {
+      aThreads.emplace_back([this, aWorkerIter, &aTmpBase]() {
+        Worker&           aWorker      = myWorkers[aWorkerIter];
+        const std::string aBasePath    = aTmpBase + ".worker-" + std::to_string(aWorkerIter);
+        const std::string aListPath    = aBasePath + ".txt";
+        const std::string aResultsPath = aBasePath + ".json";
+        const auto        aWorkerStart = std::chrono::steady_clock::now();
+        if (writeModelList(aListPath, aWorker.Models))
+        {
+          aWorker.IsOk = std::system(workerCommand(aListPath, aResultsPath).c_str()) == 0;
+        }
+        aWorker.WallMs = batchMillisSince(aWorkerStart);
+
+        std::ifstream aStream(aResultsPath);
+        if (aStream)
+        {
+          std::ostringstream aResults;
+          aResults << aStream.rdbuf();
+          aWorker.Results = aResults.str();
+        }
+        aStream.close();
+
+        std::error_code aRemoveError;
+        std::filesystem::remove(aListPath, aRemoveError);
+        std::filesystem::remove(aResultsPath, aRemoveError);
+      });
+    }
+    for (std::thread& aThread : aThreads)
+    {
+      aThread.join();
+    }
+  }
+
+  myWallMs = batchMillisSince(aStart);
+  std::ofstream aStream(myParams.ManifestPath, std::ios::trunc);
+  dumpManifest(aStream);
+  if (!aStream)
+  {
+    std::cerr << "Unable to write '" << myParams.ManifestPath << "'" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const bool isOk = std::all_of(myWorkers.begin(), myWorkers.end(), [](const Worker& theWorker) {
+    return theWorker.IsOk;
+  });
+  return isOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// ================================================================
+// Function : dumpManifest
+// Purpose  :
+// ================================================================
+void OccImguiSnapshotBatch::dumpManifest(std::ostream& theStream) const
+{
+  theStream << "{\n  \"width\": " << myParams.Snapshot.Width
+            << ",\n  \"height\": " << myParams.Snapshot.Height << ",\n  \"views\": [";
+  for (size_t aPresetIter = 0; aPresetIter < myParams.Snapshot.Presets.size(); ++aPresetIter)
+  {
+    theStream << (aPresetIter == 0 ? "\"" : ", \"")
+              << GlfwOcctSnapshot::presetName(myParams.Snapshot.Presets[aPresetIter]) << "\"";
+  }
+  theStream << "],\n  \"models\": " << myParams.Snapshot.Models.size()
+            << ",\n  \"wall_ms\": " << myWallMs << ",\n  \"workers\": [";
+  for (size_t aWorkerIter = 0; aWorkerIter < myWorkers.size(); ++aWorkerIter)
+  {
+    const Worker& aWorker = myWorkers[aWorkerIter];
+    theStream << (aWorkerIter == 0 ? "\n" : ",\n") << "  {\"index\": " << aWorkerIter
+              << ", \"ok\": " << (aWorker.IsOk ? "true" : "false")
+              << ", \"models\": " << aWorker.Models.size() << ", \"wall_ms\": " << aWorker.WallMs
+              << ", \"jobs\": [\n"
+              << aWorker.Results << "\n  ]}";
+  }
+  theStream << "\n  ]\n}\n";
+}
+
+// ================================================================
+// Function : workerCommand
+// Purpose  :
+// ================================================================
+std::string OccImguiSnapshotBatch::workerCommand(const std::string& theListPath,
+                                                 const std::string& theResultsPath) const
+{
+  const GlfwOcctSnapshot::Parameters& aParams = myParams.Snapshot;
+  std::string                         aViews;
+  for (const GlfwOcctSnapshot::Preset aPreset : aParams.Presets)
+  {
+    aViews += (aViews.empty() ? "" : ",") + std::string(GlfwOcctSnapshot::presetName(aPreset));
+  }
+
+  std::string aCommand = quoteBatchArgument(myParams.Executable) + " --batch"
+                         + " --list " + quoteBatchArgument(theListPath)
+                         + " --views " + aViews
+                         + " --size " + std::to_string(aParams.Width) + "x"
+                         + std::to_string(aParams.Height)
+                         + " --msaa " + std::to_string(aParams.NbMsaaSamples)
+                         + " --output " + quoteBatchArgument(aParams.OutputDir)
+                         + " --worker-results " + quoteBatchArgument(theResultsPath);
+#if defined(_WIN32)
+  // cmd.exe strips the outer quotes of a command line starting with a quote
+  aCommand = "\"" + aCommand + "\"";
+#endif
+  return aCommand;
+}
@@ -0,0 +1,74 @@
+#include "occ_imgui/occ-imgui-startup-timeline.h"
+
+#include <algorithm>
+#include <iomanip>
+
+// ================================================================
+// Function : start
+// Purpose  :
+// ================================================================
+void OccImguiStartupTimeline::start()
+{
+  myStart = std::chrono::steady_clock::now();
+  myPhases.clear();
+  myFirstFrameMs = -1.0;
+}
+
+// ================================================================
+// Function : addPhase
+// Purpose  :
+// ================================================================
+void OccImguiStartupTimeline::addPhase(const std::string& theName,
+                                       const double       theBeginMs,
+                                       const double       theEndMs)
+{
+  Phase aPhase;
+  aPhase.Name       = theName;
+  aPhase.BeginMs    = theBeginMs;
+  aPhase.DurationMs = std::max(theEndMs - theBeginMs, 0.0);
+  myPhases.push_back(aPhase);
+}
+
+// ================================================================
+// Function : markFirstFrame
+// Purpose  :
+// ================================================================
+void OccImguiStartupTimeline::markFirstFrame(const double theTimeMs)
+{
+  if (!hasFirstFrame())
+  {
+    myFirstFrameMs = theTimeMs;
+  }
+}
+
+// ================================================================
+// Function : dump
+// Purpose  :
+// ================================================================
+void OccImguiStartupTimeline::dump(std::ostream& theStream) const
+{
+  std::vector<Phase> aPhases = myPhases;
+  std::stable_sort(aPhases.begin(), aPhases.end(), [](const Phase& theLeft, const Phase& theRight) {
+    return theLeft.BeginMs < theRight.BeginMs;
+  });
+
+  theStream << "Startup timeline\n"
+            << std::right << std::setw(12) << "start, ms" << std::setw(14) << "duration, ms"
+            << "  Phase\n"
+            << std::fixed << std::setprecision(1);
+  bool isFirstFramePrinted = !hasFirstFrame();
+  for (const Phase& aPhase : aPhases)
+  {
+    if (!isFirstFramePrinted && isDeferred(aPhase))
+    {
+      theStream << std::setw(12) << myFirstFrameMs << std::setw(14) << "" << "  first frame\n";
+      isFirstFramePrinted = true;
+    }
+    theStream << std::setw(12) << aPhase.BeginMs << std::setw(14) << aPhase.DurationMs << "  "
+              << aPhase.Name << (isDeferred(aPhase) ? " (deferred)" : "") << "\n";
+  }
+  if (!isFirstFramePrinted)
+  {
+    theStream << std::setw(12) << myFirstFrameMs << std::setw(14) << "" << "  first frame\n";
+  }
+}
@@ -1,10 +1,7 @@
-// This file #includes all occ-imgui implementation .cc files. The
-// purpose is to allow a user to build occ-imgui by compiling this
-// file alone.
+// This file #includes all occ-imgui implementation .cc files together
+// with the application entry point. The purpose is to allow a user to
+// build occ-imgui by compiling this file alone.
 
-// The following lines pull in the real occ-imgui*.cc files.
-
-#include "occ-imgui-glfw-occt-view.cc"
-#include "occ-imgui-glfw-occt-window.cc"
+#include "occ-imgui-all.cc"
 
 #include "main.cc"
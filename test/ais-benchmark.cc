@@ -0,0 +1,343 @@
+#include "occ_imgui/occ-imgui-frame-stats.h"
+#include "occ_imgui/occ-imgui-glfw-occt-window.h"
+
+#include <GLFW/glfw3.h>
+
+#include <opencascade/AIS_ConnectedInteractive.hxx>
+#include <opencascade/AIS_InteractiveContext.hxx>
+#include <opencascade/AIS_Shape.hxx>
+#include <opencascade/BRepMesh_IncrementalMesh.hxx>
+#include <opencascade/BRepPrimAPI_MakeBox.hxx>
+#include <opencascade/OpenGl_Context.hxx>
+#include <opencascade/OpenGl_GraphicDriver.hxx>
+#include <opencascade/Prs3d_Drawer.hxx>
+#include <opencascade/Standard_Version.hxx>
+#include <opencascade/TColStd_IndexedDataMapOfStringString.hxx>
+#include <opencascade/V3d_View.hxx>
+#include <opencascade/V3d_Viewer.hxx>
+#include <opencascade/gp_Trsf.hxx>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+//! Exit code reported to CTest when no OpenGL context can be created.
+constexpr int THE_AIS_BENCHMARK_SKIP_CODE = 77;
+
+//! Benchmark parameters.
+struct AisBenchmarkParams
+{
+  std::vector<int> NbShapes;
+  int              NbFrames  = 50;
+  int              Width     = 1024;
+  int              Height    = 768;
+  bool             ToConnect = false; //!< display AIS_ConnectedInteractive instances
+  std::string      Output;
+};
+
+//! Results of one scene.
+struct AisBenchmarkScene
+{
+  int    NbShapes       = 0;
+  double DisplayMs      = 0.0;
+  double RedisplayMs    = 0.0;
+  double FirstRedrawMs  = 0.0;
+  double FirstMoveToMs  = 0.0;
+  double RedrawMedianMs = 0.0;
+  double RedrawP99Ms    = 0.0;
+  double MoveToMedianMs = 0.0;
+  double MoveToP99Ms    = 0.0;
+};
+
+//! Return milliseconds elapsed since theFrom.
+double aisBenchmarkMillis(const std::chrono::steady_clock::time_point& theFrom)
+{
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - theFrom)
+    .count();
+}
+
+//! Redraw the view and wait for the GPU to finish.
+void aisBenchmarkRedraw(const Handle(V3d_View)& theView, const Handle(OpenGl_Context)& theGlCtx)
+{
+  theView->Redraw();
+  if (!theGlCtx.IsNull())
+  {
+    theGlCtx->core11fwd->glFinish();
+  }
+}
+
+//! Print command line usage.
+void printAisBenchmarkUsage(const char* theExecutable)
+{
+  std::cout << "Usage: " << theExecutable << " [options]\n"
+            << "  --shapes N     number of box instances; may be repeated\n"
+            << "                 (default 1000, 10000 and 100000)\n"
+            << "  --frames K     number of measured redraws and MoveTo() calls (default 50)\n"
+            << "  --size WxH     offscreen window size (default 1024x768)\n"
+            << "  --connected    display instances of one AIS_Shape via AIS_ConnectedInteractive\n"
+            << "  --output FILE  write JSON results into FILE instead of stdout\n";
+}
+
+//! Measure one scene of theNbShapes instances of theShape in a fresh viewer.
+//! theRenderer is filled from the OpenGL context if empty.
+AisBenchmarkScene measureAisScene(const Handle(OpenGl_GraphicDriver)& theDriver,
+                                  const Handle(GlfwOcctWindow)&       theWindow,
+                                  const TopoDS_Shape&                 theShape,
+                                  const AisBenchmarkParams&           theParams,
+                                  const int                           theNbShapes,
+                                  TCollection_AsciiString&            theRenderer)
+{
+  AisBenchmarkScene aResult;
+  aResult.NbShapes = theNbShapes;
+
+  const Handle(Graphic3d_GraphicDriver) aBaseDriver = theDriver;
+  const Handle(V3d_Viewer)              aViewer     = new V3d_Viewer(aBaseDriver);
+  aViewer->SetDefaultLights();
+  aViewer->SetLightOn();
+  const Handle(V3d_View) aView = aViewer->CreateView();
+  aView->SetWindow(theWindow, theWindow->NativeGlContext());
+  const Handle(OpenGl_Context) aGlCtx = theDriver->GetSharedContext();
+  if (theRenderer.IsEmpty())
+  {
+    TColStd_IndexedDataMapOfStringString aDict;
+    aView->DiagnosticInformation(aDict, Graphic3d_DiagnosticInfo_Basic);
+    const TCollection_AsciiString* aValue = aDict.Seek("GLrenderer");
+    theRenderer = aValue != nullptr ? *aValue : TCollection_AsciiString("unknown");
+  }
+
+  const Handle(AIS_InteractiveContext) aContext = new AIS_InteractiveContext(aViewer);
+  // the shape is meshed once up front, so that timings exclude tessellation
+  aContext->DefaultDrawer()->SetAutoTriangulation(false);
+
+  // square grid of instances sharing the same TShape
+  const int aGridSize = static_cast<int>(std::ceil(std::sqrt(theNbShapes)));
+  const Handle(AIS_Shape)                    aPrototype = new AIS_Shape(theShape);
+  std::vector<Handle(AIS_InteractiveObject)> aShapes;
+  aShapes.reserve(static_cast<size_t>(theNbShapes));
+  for (int aShapeIter = 0; aShapeIter < theNbShapes; ++aShapeIter)
+  {
+    gp_Trsf aTrsf;
+    aTrsf.SetTranslation(
+      gp_Vec(2.0 * (aShapeIter % aGridSize), 2.0 * (aShapeIter / aGridSize), 0.0));
+    if (theParams.ToConnect)
+    {
+      Handle(AIS_ConnectedInteractive) anInstance = new AIS_ConnectedInteractive();
+      anInstance->Connect(aPrototype, aTrsf);
+      aShapes.push_back(anInstance);
+    }
+    else
+    {
+      aShapes.push_back(new AIS_Shape(theShape.Moved(TopLoc_Location(aTrsf))));
+    }
+  }
+
+  auto aStart = std::chrono::steady_clock::now();
+  for (const Handle(AIS_InteractiveObject)& aShape : aShapes)
+  {
+    aContext->Display(aShape, AIS_Shaded, 0, false);
+  }
+  aResult.DisplayMs = aisBenchmarkMillis(aStart);
+
+  aView->FitAll(0.01, false);
+  aStart = std::chrono::steady_clock::now();
+  aisBenchmarkRedraw(aView, aGlCtx);
+  aResult.FirstRedrawMs = aisBenchmarkMillis(aStart);
+
+  OccImguiFrameStats aRedrawStats;
+  aRedrawStats.reserve(static_cast<size_t>(theParams.NbFrames));
+  for (int aFrameIter = 0; aFrameIter < theParams.NbFrames; ++aFrameIter)
+  {
+    aView->Camera()->OrthogonalizeUp();
+    aView->Turn(0.0, 0.0, 0.01, false);
+    aStart = std::chrono::steady_clock::now();
+    aisBenchmarkRedraw(aView, aGlCtx);
+    aRedrawStats.add(aisBenchmarkMillis(aStart));
+  }
+  aResult.RedrawMedianMs = aRedrawStats.median();
+  aResult.RedrawP99Ms    = aRedrawStats.percentile(99.0);
+
+  // the first MoveTo() builds the selection BVH, the following ones only traverse it
+  aStart = std::chrono::steady_clock::now();
+  aContext->MoveTo(theParams.Width / 2, theParams.Height / 2, aView, false);
+  aResult.FirstMoveToMs = aisBenchmarkMillis(aStart);
+
+  OccImguiFrameStats aMoveToStats;
+  aMoveToStats.reserve(static_cast<size_t>(theParams.NbFrames));
+  for (int aFrameIter = 0; aFrameIter < theParams.NbFrames; ++aFrameIter)
+  {
+    const int aPosX = (aFrameIter * 37) % theParams.Width;
+    const int aPosY = (aFrameIter * 53) % theParams.Height;
+    aStart          = std::chrono::steady_clock::now();
+    aContext->MoveTo(aPosX, aPosY, aView, false);
+    aMoveToStats.add(aisBenchmarkMillis(aStart));
+  }
+  aResult.MoveToMedianMs = aMoveToStats.median();
+  aResult.MoveToP99Ms    = aMoveToStats.percentile(99.0);
+
+  aStart = std::chrono::steady_clock::now();
+  if (theParams.ToConnect)
+  {
+    aContext->Redisplay(aPrototype, false);
+  }
+  for (const Handle(AIS_InteractiveObject)& aShape : aShapes)
+  {
+    aContext->Redisplay(aShape, false);
+  }
+  aisBenchmarkRedraw(aView, aGlCtx);
+  aResult.RedisplayMs = aisBenchmarkMillis(aStart);
+
+  aContext->RemoveAll(false);
+  aView->Remove();
+  return aResult;
+}
+
+//! Write results as JSON document.
+void dumpAisBenchmark(std::ostream&                         theStream,
+                      const AisBenchmarkParams&             theParams,
+                      const TCollection_AsciiString&        theRenderer,
+                      const std::vector<AisBenchmarkScene>& theScenes)
+{
+  theStream << "{\n"
+            << "  \"benchmark\": \"ais\",\n"
+            << "  \"version\": \"" << OCC_IMGUI_AIS_BENCHMARK_VERSION << "\",\n"
+            << "  \"occt\": \"" << OCC_VERSION_COMPLETE << "\",\n"
+            << "  \"renderer\": \"" << theRenderer.ToCString() << "\",\n"
+            << "  \"frames\": " << theParams.NbFrames << ",\n"
+            << "  \"connected\": " << (theParams.ToConnect ? "true" : "false") << ",\n"
+            << "  \"scenes\": [";
+  for (size_t aSceneIter = 0; aSceneIter < theScenes.size(); ++aSceneIter)
+  {
+    const AisBenchmarkScene& aScene = theScenes[aSceneIter];
+    theStream << (aSceneIter == 0 ? "\n" : ",\n") << "    {\"shapes\": " << aScene.NbShapes
+              << ", \"display_ms\": " << aScene.DisplayMs
+              << ", \"redisplay_ms\": " << aScene.RedisplayMs
+              << ", \"first_redraw_ms\": " << aScene.FirstRedrawMs
+              << ", \"redraw_median_ms\": " << aScene.RedrawMedianMs
+              << ", \"redraw_p99_ms\": " << aScene.RedrawP99Ms
+              << ", \"first_moveto_ms\": " << aScene.FirstMoveToMs
+              << ", \"moveto_median_ms\": " << aScene.MoveToMedianMs
+              << ", \"moveto_p99_ms\": " << aScene.MoveToP99Ms << "}";
+  }
+  theStream << "\n  ]\n}\n";
+}
+} // namespace
+
+int main(int theNbArgs, char** theArgs)
+{
+  try
+  {
+    AisBenchmarkParams aParams;
+    for (int anArgIter = 1; anArgIter < theNbArgs; ++anArgIter)
+    {
+      const std::string anArg  = theArgs[anArgIter];
+      const bool        hasVal = anArgIter + 1 < theNbArgs;
+      if (anArg == "--shapes" && hasVal)
+      {
+        aParams.NbShapes.push_back(std::stoi(theArgs[++anArgIter]));
+      }
+      else if (anArg == "--frames" && hasVal)
+      {
+        aParams.NbFrames = std::stoi(theArgs[++anArgIter]);
+      }
+      else if (anArg == "--size" && hasVal)
+      {
+        const std::string aSize = theArgs[++anArgIter];
+        const size_t      aSep  = aSize.find('x');
+        if (aSep == std::string::npos)
+        {
+          printAisBenchmarkUsage(theArgs[0]);
+          return EXIT_FAILURE;
+        }
+        aParams.Width  = std::stoi(aSize.substr(0, aSep));
+        aParams.Height = std::stoi(aSize.substr(aSep + 1));
+      }
+      else if (anArg == "--connected")
+      {
+        aParams.ToConnect = true;
+      }
+      else if (anArg == "--output" && hasVal)
+      {
+        aParams.Output = theArgs[++anArgIter];
+      }
+      else
+      {
+        printAisBenchmarkUsage(theArgs[0]);
+        return anArg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+      }
+    }
+    if (aParams.NbShapes.empty())
+    {
+      aParams.NbShapes = {1000, 10000, 100000};
+    }
+
+    if (glfwInit() != GLFW_TRUE)
+    {
+      std::cerr << "Unable to initialize GLFW" << std::endl;
+      return THE_AIS_BENCHMARK_SKIP_CODE;
+    }
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+#if defined(__APPLE__)
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    std::vector<AisBenchmarkScene> aScenes;
+    TCollection_AsciiString        aRenderer;
+    {
+      Handle(GlfwOcctWindow) aWindow =
+        new GlfwOcctWindow(aParams.Width, aParams.Height, "OCCT IMGUI AIS Benchmark");
+      if (aWindow->getGlfwWindow() == nullptr)
+      {
+        std::cerr << "Unable to create an offscreen OpenGL window" << std::endl;
+        glfwTerminate();
+        return THE_AIS_BENCHMARK_SKIP_CODE;
+      }
+      aWindow->SetVirtual(true);
+
+      Handle(OpenGl_GraphicDriver) aDriver =
+        new OpenGl_GraphicDriver(aWindow->GetDisplay(), false);
+      aDriver->SetBuffersNoSwap(true);
+
+      TopoDS_Shape aBox = BRepPrimAPI_MakeBox(1.0, 1.0, 1.0).Shape();
+      BRepMesh_IncrementalMesh(aBox, 0.01);
+      for (const int aNbShapes : aParams.NbShapes)
+      {
+        // the driver keeps the shared OpenGL context alive between scenes
+        aScenes.push_back(
+          measureAisScene(aDriver, aWindow, aBox, aParams, aNbShapes, aRenderer));
+      }
+      aWindow->Close();
+    }
+    glfwTerminate();
+
+    if (aParams.Output.empty())
+    {
+      dumpAisBenchmark(std::cout, aParams, aRenderer, aScenes);
+    }
+    else
+    {
+      std::ofstream aStream(aParams.Output);
+      dumpAisBenchmark(aStream, aParams, aRenderer, aScenes);
+      if (!aStream)
+      {
+        std::cerr << "Unable to write '" << aParams.Output << "'" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  catch (const std::exception& theError)
+  {
+    std::cerr << theError.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
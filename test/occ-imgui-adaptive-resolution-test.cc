@@ -0,0 +1,60 @@
+#include "occ_imgui/occ-imgui-adaptive-resolution.h"
+
+#include <gtest/gtest.h>
+
+TEST(OccImguiAdaptiveResolutionTest, RefinesAfterInteraction)
+{
+  OccImguiAdaptiveResolution aQuality;
+  EXPECT_FALSE(aQuality.update(false, 0.0, 0.0));
+  EXPECT_FALSE(aQuality.isDegraded());
+
+  EXPECT_TRUE(aQuality.update(true, 1.0, 0.0));
+  EXPECT_TRUE(aQuality.isDegraded());
+
+  // short pauses keep the reduced quality
+  EXPECT_FALSE(aQuality.update(false, 1.0 + aQuality.refineDelay() * 0.5, 0.0));
+  EXPECT_TRUE(aQuality.isDegraded());
+
+  EXPECT_TRUE(aQuality.update(false, 1.0 + aQuality.refineDelay(), 0.0));
+  EXPECT_FALSE(aQuality.isDegraded());
+}
+
+TEST(OccImguiAdaptiveResolutionTest, ScaleFollowsFrameTime)
+{
+  OccImguiAdaptiveResolution aQuality;
+  aQuality.setTargetFrameTime(0.02);
+  aQuality.setMinScale(0.25f);
+  aQuality.update(true, 0.0, 0.0);
+  EXPECT_FLOAT_EQ(aQuality.scale(), 1.0f);
+
+  // slow frames lower the scale down to the minimum
+  double aTime = 0.0;
+  for (int aFrame = 0; aFrame < 20; ++aFrame)
+  {
+    aTime += 0.1;
+    aQuality.update(true, aTime, 0.1);
+    EXPECT_GE(aQuality.scale(), 0.25f);
+  }
+  EXPECT_FLOAT_EQ(aQuality.scale(), 0.25f);
+
+  // frames close to the target keep the scale
+  EXPECT_FALSE(aQuality.update(true, aTime + 0.02, 0.021));
+
+  // fast frames raise it back to the full resolution
+  for (int aFrame = 0; aFrame < 20; ++aFrame)
+  {
+    aTime += 0.005;
+    aQuality.update(true, aTime, 0.005);
+  }
+  EXPECT_FLOAT_EQ(aQuality.scale(), 1.0f);
+}
+
+TEST(OccImguiAdaptiveResolutionTest, DisabledKeepsFullQuality)
+{
+  OccImguiAdaptiveResolution aQuality;
+  aQuality.update(true, 0.0, 0.0);
+  aQuality.setEnabled(false);
+  EXPECT_TRUE(aQuality.update(true, 0.1, 0.1));
+  EXPECT_FALSE(aQuality.isDegraded());
+  EXPECT_FALSE(aQuality.update(true, 0.2, 0.1));
+}
@@ -0,0 +1,93 @@
+#include "occ_imgui/occ-imgui-frame-pacer.h"
+
+#include <gtest/gtest.h>
+
+TEST(OccImguiFramePacerTest, FramesFollowTargetAndIdleRates)
+{
+  OccImguiFramePacer aPacer;
+  aPacer.setTargetRate(50.0);
+  aPacer.setIdleRate(5.0);
+  aPacer.setIdleDelay(1.0);
+  EXPECT_DOUBLE_EQ(aPacer.frameDelay(0.0), 0.0);
+
+  aPacer.addInput(0.0);
+  aPacer.beginFrame(0.5);
+  EXPECT_NEAR(aPacer.frameDelay(0.51), 0.01, 1.0e-9);
+  EXPECT_DOUBLE_EQ(aPacer.frameDelay(0.53), 0.0);
+
+  // without input for the idle delay frames slow down to the idle rate
+  aPacer.beginFrame(1.5);
+  EXPECT_TRUE(aPacer.isIdle(1.5));
+  EXPECT_NEAR(aPacer.frameDelay(1.55), 0.15, 1.0e-9);
+
+  // input brings the target rate back at once
+  aPacer.addInput(1.55);
+  EXPECT_FALSE(aPacer.isIdle(1.55));
+  EXPECT_DOUBLE_EQ(aPacer.frameDelay(1.55), 0.0);
+
+  aPacer.setTargetRate(0.0);
+  aPacer.beginFrame(2.0);
+  EXPECT_DOUBLE_EQ(aPacer.frameDelay(2.0), 0.0);
+}
+
+TEST(OccImguiFramePacerTest, LatencyFromOldestInputToSwap)
+{
+  OccImguiFramePacer aPacer;
+  aPacer.beginFrame(0.0);
+  aPacer.endFrame(0.005, 0.006);
+  EXPECT_EQ(aPacer.nbLatencies(), 0u);
+
+  aPacer.addInput(0.010);
+  aPacer.addInput(0.012);
+  aPacer.beginFrame(0.015);
+  aPacer.endFrame(0.020, 0.030);
+  ASSERT_EQ(aPacer.nbLatencies(), 1u);
+  EXPECT_NEAR(aPacer.latencyPercentile(50.0), 20.0, 1.0e-9);
+
+  for (int aFrame = 0; aFrame < 99; ++aFrame)
+  {
+    const double aTime = 1.0 + aFrame * 0.1;
+    aPacer.addInput(aTime);
+    aPacer.beginFrame(aTime);
+    aPacer.endFrame(aTime + 0.001, aTime + 0.002);
+  }
+  EXPECT_EQ(aPacer.nbLatencies(), 100u);
+  EXPECT_NEAR(aPacer.latencyPercentile(50.0), 2.0, 1.0e-6);
+  EXPECT_NEAR(aPacer.latencyPercentile(100.0), 20.0, 1.0e-6);
+
+  aPacer.resetLatencies();
+  EXPECT_EQ(aPacer.nbLatencies(), 0u);
+}
+
+TEST(OccImguiFramePacerTest, SwapIntervalFollowsFrameWork)
+{
+  OccImguiFramePacer aPacer;
+  aPacer.setRefreshRate(100.0);
+  EXPECT_EQ(aPacer.swapInterval(), 1);
+
+  // frames longer than the refresh period are swapped without waiting for vsync
+  double aTime = 0.0;
+  for (int aFrame = 0; aFrame < 5; ++aFrame, aTime += 0.02)
+  {
+    aPacer.beginFrame(aTime);
+    aPacer.endFrame(aTime + 0.015, aTime + 0.016);
+  }
+  EXPECT_EQ(aPacer.swapInterval(), 0);
+
+  // vsync resumes once the smoothed work is well within the period
+  for (int aFrame = 0; aFrame < 50; ++aFrame, aTime += 0.01)
+  {
+    aPacer.beginFrame(aTime);
+    aPacer.endFrame(aTime + 0.002, aTime + 0.003);
+  }
+  EXPECT_EQ(aPacer.swapInterval(), 1);
+  EXPECT_NEAR(aPacer.frameRate(), 100.0, 5.0);
+
+  aPacer.setSwapTearSupported(true);
+  aPacer.endFrame(aTime, aTime + 0.001);
+  EXPECT_EQ(aPacer.swapInterval(), -1);
+
+  aPacer.setAdaptiveSwap(false);
+  aPacer.endFrame(aTime + 0.01, aTime + 0.011);
+  EXPECT_EQ(aPacer.swapInterval(), 1);
+}
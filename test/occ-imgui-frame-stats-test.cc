@@ -0,0 +1,40 @@
+#include "occ_imgui/occ-imgui-frame-stats.h"
+
+#include <gtest/gtest.h>
+
+TEST(OccImguiFrameStatsTest, EmptyStatsAreZero)
+{
+  const OccImguiFrameStats aStats;
+  EXPECT_TRUE(aStats.isEmpty());
+  EXPECT_DOUBLE_EQ(aStats.minimum(), 0.0);
+  EXPECT_DOUBLE_EQ(aStats.maximum(), 0.0);
+  EXPECT_DOUBLE_EQ(aStats.mean(), 0.0);
+  EXPECT_DOUBLE_EQ(aStats.percentile(99.0), 0.0);
+}
+
+TEST(OccImguiFrameStatsTest, OrderStatistics)
+{
+  OccImguiFrameStats aStats;
+  // insert out of order to make sure statistics do not depend on insertion order
+  for (int aValue = 100; aValue >= 1; --aValue)
+  {
+    aStats.add(static_cast<double>(aValue));
+  }
+
+  EXPECT_EQ(aStats.size(), 100u);
+  EXPECT_DOUBLE_EQ(aStats.minimum(), 1.0);
+  EXPECT_DOUBLE_EQ(aStats.maximum(), 100.0);
+  EXPECT_DOUBLE_EQ(aStats.mean(), 50.5);
+  EXPECT_DOUBLE_EQ(aStats.median(), 50.0);
+  EXPECT_DOUBLE_EQ(aStats.percentile(99.0), 99.0);
+  EXPECT_DOUBLE_EQ(aStats.percentile(0.0), 1.0);
+  EXPECT_DOUBLE_EQ(aStats.percentile(100.0), 100.0);
+}
+
+TEST(OccImguiFrameStatsTest, ResetRemovesSamples)
+{
+  OccImguiFrameStats aStats;
+  aStats.add(1.0);
+  aStats.reset();
+  EXPECT_TRUE(aStats.isEmpty());
+}
@@ -0,0 +1,73 @@
+#include "occ_imgui/occ-imgui-input-queue.h"
+
+#include <gtest/gtest.h>
+
+TEST(OccImguiInputQueueTest, ConsecutiveMovesAreMerged)
+{
+  OccImguiInputQueue aQueue;
+  aQueue.pushMouseMove(Graphic3d_Vec2i(1, 1));
+  aQueue.pushMouseMove(Graphic3d_Vec2i(2, 2));
+  aQueue.pushMouseMove(Graphic3d_Vec2i(3, 4));
+
+  std::vector<OccImguiInputQueue::Event> anEvents;
+  aQueue.takeEvents(anEvents);
+  ASSERT_EQ(anEvents.size(), 1u);
+  EXPECT_EQ(anEvents[0].Type, OccImguiInputQueue::EventType_MouseMove);
+  EXPECT_EQ(anEvents[0].Position, Graphic3d_Vec2i(3, 4));
+  EXPECT_EQ(aQueue.nbReceived(), 3u);
+  EXPECT_EQ(aQueue.nbApplied(), 1u);
+}
+
+TEST(OccImguiInputQueueTest, OrderAroundButtonsIsKept)
+{
+  OccImguiInputQueue aQueue;
+  aQueue.pushMouseMove(Graphic3d_Vec2i(1, 1));
+  aQueue.pushMouseButton(Graphic3d_Vec2i(1, 1), 0, 1, 0);
+  aQueue.pushMouseMove(Graphic3d_Vec2i(5, 5));
+  aQueue.pushMouseMove(Graphic3d_Vec2i(6, 6));
+  aQueue.pushMouseButton(Graphic3d_Vec2i(6, 6), 0, 0, 0);
+
+  std::vector<OccImguiInputQueue::Event> anEvents;
+  aQueue.takeEvents(anEvents);
+  ASSERT_EQ(anEvents.size(), 4u);
+  EXPECT_EQ(anEvents[0].Type, OccImguiInputQueue::EventType_MouseMove);
+  EXPECT_EQ(anEvents[1].Type, OccImguiInputQueue::EventType_MouseButton);
+  EXPECT_EQ(anEvents[1].Action, 1);
+  EXPECT_EQ(anEvents[2].Type, OccImguiInputQueue::EventType_MouseMove);
+  EXPECT_EQ(anEvents[2].Position, Graphic3d_Vec2i(6, 6));
+  EXPECT_EQ(anEvents[3].Type, OccImguiInputQueue::EventType_MouseButton);
+  EXPECT_EQ(anEvents[3].Action, 0);
+
+  anEvents.clear();
+  aQueue.takeEvents(anEvents);
+  EXPECT_TRUE(anEvents.empty());
+}
+
+TEST(OccImguiInputQueueTest, ScrollDeltasAccumulate)
+{
+  OccImguiInputQueue aQueue;
+  aQueue.pushScroll(Graphic3d_Vec2i(0, 0), 1.0);
+  aQueue.pushScroll(Graphic3d_Vec2i(2, 3), 2.0);
+
+  std::vector<OccImguiInputQueue::Event> anEvents;
+  aQueue.takeEvents(anEvents);
+  ASSERT_EQ(anEvents.size(), 1u);
+  EXPECT_DOUBLE_EQ(anEvents[0].ScrollDelta, 3.0);
+  EXPECT_EQ(anEvents[0].Position, Graphic3d_Vec2i(2, 3));
+}
+
+TEST(OccImguiInputQueueTest, ResizeIsDebounced)
+{
+  OccImguiInputQueue aQueue;
+  Graphic3d_Vec2i    aSize;
+  EXPECT_FALSE(aQueue.takeResize(0.0, 0.1, aSize));
+
+  aQueue.pushResize(Graphic3d_Vec2i(800, 600), 0.0);
+  aQueue.pushResize(Graphic3d_Vec2i(900, 700), 0.08);
+  EXPECT_TRUE(aQueue.hasPendingResize());
+  EXPECT_FALSE(aQueue.takeResize(0.15, 0.1, aSize));
+
+  ASSERT_TRUE(aQueue.takeResize(0.2, 0.1, aSize));
+  EXPECT_EQ(aSize, Graphic3d_Vec2i(900, 700));
+  EXPECT_FALSE(aQueue.hasPendingResize());
+}
@@ -0,0 +1,69 @@
+#include "occ_imgui/occ-imgui-input-recording.h"
+
+#include <gtest/gtest.h>
+
+TEST(OccImguiInputRecordingTest, EncodeDecodeRoundTrip)
+{
+  OccImguiInputRecording aRecording;
+  aRecording.setWindowSize(Graphic3d_Vec2i(1300, 900));
+  aRecording.setModelPath("models/part.step");
+
+  OccImguiInputRecording::Event anEvent;
+  anEvent.Time     = 0.5;
+  anEvent.Position = Graphic3d_Vec2i(10, 20);
+  aRecording.add(anEvent);
+
+  anEvent.Type   = OccImguiInputRecording::EventType_MouseButton;
+  anEvent.Time   = 0.5000014;
+  anEvent.Button = 1;
+  anEvent.Action = 1;
+  anEvent.Mods   = 2;
+  aRecording.add(anEvent);
+
+  anEvent.Type        = OccImguiInputRecording::EventType_Scroll;
+  anEvent.Time        = 1.25;
+  anEvent.Position    = Graphic3d_Vec2i(-5, 7);
+  anEvent.ScrollDelta = -1.5;
+  aRecording.add(anEvent);
+
+  // events arriving out of order keep the time order
+  anEvent.Type     = OccImguiInputRecording::EventType_Resize;
+  anEvent.Time     = 1.0;
+  anEvent.Position = Graphic3d_Vec2i(800, 600);
+  aRecording.add(anEvent);
+  EXPECT_DOUBLE_EQ(aRecording.duration(), 1.25);
+
+  std::vector<uint8_t> aData;
+  aRecording.encode(aData);
+
+  OccImguiInputRecording aDecoded;
+  ASSERT_TRUE(aDecoded.decode(aData.data(), aData.size()));
+  EXPECT_EQ(aDecoded.windowSize(), Graphic3d_Vec2i(1300, 900));
+  EXPECT_EQ(aDecoded.modelPath(), "models/part.step");
+  ASSERT_EQ(aDecoded.events().size(), 4u);
+
+  const std::vector<OccImguiInputRecording::Event>& anEvents = aDecoded.events();
+  EXPECT_EQ(anEvents[0].Type, OccImguiInputRecording::EventType_MouseMove);
+  EXPECT_EQ(anEvents[0].Position, Graphic3d_Vec2i(10, 20));
+  EXPECT_DOUBLE_EQ(anEvents[0].Time, 0.5);
+  EXPECT_EQ(anEvents[1].Type, OccImguiInputRecording::EventType_MouseButton);
+  EXPECT_NEAR(anEvents[1].Time, 0.500001, 1.0e-9);
+  EXPECT_EQ(anEvents[1].Button, 1);
+  EXPECT_EQ(anEvents[1].Action, 1);
+  EXPECT_EQ(anEvents[1].Mods, 2);
+  EXPECT_EQ(anEvents[2].Position, Graphic3d_Vec2i(-5, 7));
+  EXPECT_DOUBLE_EQ(anEvents[2].ScrollDelta, -1.5);
+  EXPECT_EQ(anEvents[3].Type, OccImguiInputRecording::EventType_Resize);
+  EXPECT_EQ(anEvents[3].Position, Graphic3d_Vec2i(800, 600));
+  EXPECT_DOUBLE_EQ(anEvents[3].Time, 1.25);
+
+  // encoding the decoded recording gives the same bytes
+  std::vector<uint8_t> aData2;
+  aDecoded.encode(aData2);
+  EXPECT_EQ(aData, aData2);
+
+  // truncated data and foreign files are rejected
+  EXPECT_FALSE(aDecoded.decode(aData.data(), aData.size() - 1));
+  aData[0] = 'X';
+  EXPECT_FALSE(aDecoded.decode(aData.data(), aData.size()));
+}
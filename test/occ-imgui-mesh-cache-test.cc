@@ -0,0 +1,200 @@
+#include "occ_imgui/occ-imgui-mesh-disk-cache.h"
+#include "occ_imgui/occ-imgui-mesh-lod-cache.h"
+
+#include "occ-imgui-test-dir.h"
+
+#include <gtest/gtest.h>
+
+#include <opencascade/BRepPrimAPI_MakeBox.hxx>
+#include <opencascade/BRepPrimAPI_MakeSphere.hxx>
+#include <opencascade/BRep_Tool.hxx>
+#include <opencascade/TopExp_Explorer.hxx>
+#include <opencascade/TopoDS.hxx>
+#include <opencascade/gp_Trsf.hxx>
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+
+namespace
+{
+//! Collect triangulations attached to the faces of the shape.
+std::vector<Handle(Poly_Triangulation)> meshCacheTestTriangulations(const TopoDS_Shape& theShape)
+{
+  std::vector<Handle(Poly_Triangulation)> aTriangulations;
+  for (TopExp_Explorer aFaceIter(theShape, TopAbs_FACE); aFaceIter.More(); aFaceIter.Next())
+  {
+    TopLoc_Location aLoc;
+    aTriangulations.push_back(BRep_Tool::Triangulation(TopoDS::Face(aFaceIter.Current()), aLoc));
+  }
+  return aTriangulations;
+}
+} // namespace
+
+TEST(OccImguiMeshLodCacheTest, LevelsAreMeshedAndActivated)
+{
+  const TopoDS_Shape   aSphere = BRepPrimAPI_MakeSphere(10.0).Shape();
+  OccImguiMeshLodCache aCache;
+  EXPECT_FALSE(aCache.hasLevel(aSphere, OccImguiMeshLodCache::Level_Coarse));
+  EXPECT_FALSE(aCache.activate(aSphere, OccImguiMeshLodCache::Level_Coarse));
+  EXPECT_EQ(aCache.activeLevel(aSphere), -1);
+
+  aCache.mesh({aSphere}, OccImguiMeshLodCache::Level_Coarse);
+  aCache.mesh({aSphere}, OccImguiMeshLodCache::Level_Fine);
+  ASSERT_TRUE(aCache.hasLevel(aSphere, OccImguiMeshLodCache::Level_Coarse));
+  ASSERT_TRUE(aCache.hasLevel(aSphere, OccImguiMeshLodCache::Level_Fine));
+  EXPECT_LT(aCache.deflection(aSphere, OccImguiMeshLodCache::Level_Fine),
+            aCache.deflection(aSphere, OccImguiMeshLodCache::Level_Coarse));
+
+  ASSERT_TRUE(aCache.activate(aSphere, OccImguiMeshLodCache::Level_Coarse));
+  EXPECT_EQ(aCache.activeLevel(aSphere), OccImguiMeshLodCache::Level_Coarse);
+  int aNbCoarse = 0;
+  for (const Handle(Poly_Triangulation)& aTris : meshCacheTestTriangulations(aSphere))
+  {
+    ASSERT_FALSE(aTris.IsNull());
+    aNbCoarse += aTris->NbTriangles();
+  }
+
+  ASSERT_TRUE(aCache.activate(aSphere, OccImguiMeshLodCache::Level_Fine));
+  int aNbFine = 0;
+  for (const Handle(Poly_Triangulation)& aTris : meshCacheTestTriangulations(aSphere))
+  {
+    ASSERT_FALSE(aTris.IsNull());
+    aNbFine += aTris->NbTriangles();
+  }
+  EXPECT_GT(aNbFine, aNbCoarse);
+}
+
+TEST(OccImguiMeshLodCacheTest, InstancesShareEntry)
+{
+  const TopoDS_Shape aBox = BRepPrimAPI_MakeBox(1.0, 2.0, 3.0).Shape();
+  gp_Trsf            aTrsf;
+  aTrsf.SetTranslation(gp_Vec(10.0, 0.0, 0.0));
+  const TopoDS_Shape anInstance = aBox.Moved(TopLoc_Location(aTrsf));
+
+  OccImguiMeshLodCache aCache;
+  aCache.mesh({aBox}, OccImguiMeshLodCache::Level_Medium);
+  EXPECT_TRUE(aCache.hasLevel(anInstance, OccImguiMeshLodCache::Level_Medium));
+}
+
+TEST(OccImguiMeshLodCacheTest, ReleaseKeepsActiveLevel)
+{
+  const TopoDS_Shape   aSphere = BRepPrimAPI_MakeSphere(10.0).Shape();
+  OccImguiMeshLodCache aCache;
+  EXPECT_EQ(aCache.memorySize(), 0u);
+  aCache.mesh({aSphere}, OccImguiMeshLodCache::Level_Coarse);
+  aCache.mesh({aSphere}, OccImguiMeshLodCache::Level_Fine);
+  ASSERT_TRUE(aCache.activate(aSphere, OccImguiMeshLodCache::Level_Fine));
+
+  const size_t aSize = aCache.memorySize();
+  EXPECT_GT(aSize, 0u);
+  EXPECT_EQ(aCache.memorySize(aSphere), aSize);
+
+  // the active level survives as well as the kept one
+  EXPECT_EQ(aCache.release(aSphere, OccImguiMeshLodCache::Level_Coarse), 0u);
+  EXPECT_EQ(aCache.memorySize(), aSize);
+
+  ASSERT_TRUE(aCache.activate(aSphere, OccImguiMeshLodCache::Level_Coarse));
+  const size_t aReleased = aCache.release(aSphere, OccImguiMeshLodCache::Level_Coarse);
+  EXPECT_GT(aReleased, 0u);
+  EXPECT_EQ(aCache.memorySize(), aSize - aReleased);
+  EXPECT_TRUE(aCache.hasLevel(aSphere, OccImguiMeshLodCache::Level_Coarse));
+  EXPECT_FALSE(aCache.hasLevel(aSphere, OccImguiMeshLodCache::Level_Fine));
+}
+
+TEST(OccImguiMeshDiskCacheTest, ShapeKey)
+{
+  const TopoDS_Shape aBox = BRepPrimAPI_MakeBox(1.0, 2.0, 3.0).Shape();
+  gp_Trsf            aTrsf;
+  aTrsf.SetTranslation(gp_Vec(10.0, 0.0, 0.0));
+  const TopoDS_Shape anInstance = aBox.Moved(TopLoc_Location(aTrsf));
+  const TopoDS_Shape anOther    = BRepPrimAPI_MakeBox(1.0, 2.0, 4.0).Shape();
+
+  const uint64_t aShapeKey = OccImguiMeshDiskCache::shapeKey(aBox);
+  EXPECT_EQ(aShapeKey, OccImguiMeshDiskCache::shapeKey(anInstance));
+  EXPECT_NE(aShapeKey, OccImguiMeshDiskCache::shapeKey(anOther));
+
+  const uint64_t aKey = OccImguiMeshDiskCache::levelKey(aShapeKey, 0.1, 0.5);
+  EXPECT_EQ(aKey, OccImguiMeshDiskCache::levelKey(aShapeKey, 0.1, 0.5));
+  EXPECT_NE(aKey, aShapeKey);
+  EXPECT_NE(aKey, OccImguiMeshDiskCache::levelKey(aShapeKey, 0.2, 0.5));
+  EXPECT_NE(aKey, OccImguiMeshDiskCache::levelKey(aShapeKey, 0.1, 0.25));
+  const uint64_t anOtherKey = OccImguiMeshDiskCache::shapeKey(anOther);
+  EXPECT_NE(aKey, OccImguiMeshDiskCache::levelKey(anOtherKey, 0.1, 0.5));
+}
+
+TEST(OccImguiMeshDiskCacheTest, StoreAndLoad)
+{
+  const OccImguiTestDir aDir("store-load");
+  const TopoDS_Shape     aSphere = BRepPrimAPI_MakeSphere(10.0).Shape();
+  OccImguiMeshLodCache   aLodCache;
+  aLodCache.mesh({aSphere}, OccImguiMeshLodCache::Level_Medium);
+  ASSERT_TRUE(aLodCache.activate(aSphere, OccImguiMeshLodCache::Level_Medium));
+  const std::vector<Handle(Poly_Triangulation)> aStored = meshCacheTestTriangulations(aSphere);
+
+  OccImguiMeshDiskCache aCache(aDir.path(), 1024 * 1024);
+  std::vector<Handle(Poly_Triangulation)> aLoaded;
+  EXPECT_FALSE(aCache.load(42, aStored.size(), aLoaded));
+  EXPECT_EQ(aCache.nbMisses(), 1u);
+
+  aCache.store(42, aStored);
+  const uint64_t anEntrySize = aCache.size();
+  EXPECT_GT(anEntrySize, 0u);
+
+  // replacing the entry does not count its size twice
+  aCache.store(42, aStored);
+  EXPECT_EQ(aCache.size(), anEntrySize);
+
+  ASSERT_TRUE(aCache.load(42, aStored.size(), aLoaded));
+  EXPECT_EQ(aCache.nbHits(), 1u);
+  ASSERT_EQ(aLoaded.size(), aStored.size());
+  for (size_t aFaceIter = 0; aFaceIter < aStored.size(); ++aFaceIter)
+  {
+    const Handle(Poly_Triangulation)& aSrc = aStored[aFaceIter];
+    const Handle(Poly_Triangulation)& aDst = aLoaded[aFaceIter];
+    ASSERT_FALSE(aDst.IsNull());
+    EXPECT_EQ(aDst->NbNodes(), aSrc->NbNodes());
+    EXPECT_EQ(aDst->NbTriangles(), aSrc->NbTriangles());
+    EXPECT_EQ(aDst->HasNormals(), aSrc->HasNormals());
+    EXPECT_TRUE(aDst->Node(1).IsEqual(aSrc->Node(1), 1.0e-5));
+  }
+
+  // face count mismatch means the entry belongs to another shape
+  EXPECT_FALSE(aCache.load(42, aStored.size() + 1, aLoaded));
+
+  // entries referring to nodes out of range are rejected; the last value is a node index
+  std::filesystem::path anEntryPath;
+  for (const auto& aFile : std::filesystem::directory_iterator(aDir.path()))
+  {
+    anEntryPath = aFile.path();
+  }
+  {
+    std::fstream  aFile(anEntryPath, std::ios::in | std::ios::out | std::ios::binary);
+    const int32_t aBadIndex = std::numeric_limits<int32_t>::max();
+    aFile.seekp(-static_cast<std::streamoff>(sizeof(aBadIndex)), std::ios::end);
+    aFile.write(reinterpret_cast<const char*>(&aBadIndex), sizeof(aBadIndex));
+  }
+  EXPECT_FALSE(aCache.load(42, aStored.size(), aLoaded));
+
+  aCache.clear();
+  EXPECT_EQ(aCache.size(), 0u);
+  EXPECT_FALSE(aCache.load(42, aStored.size(), aLoaded));
+}
+
+TEST(OccImguiMeshDiskCacheTest, SizeLimitIsKept)
+{
+  const OccImguiTestDir aDir("size-limit");
+  const TopoDS_Shape     aSphere = BRepPrimAPI_MakeSphere(10.0).Shape();
+  OccImguiMeshLodCache   aLodCache;
+  aLodCache.mesh({aSphere}, OccImguiMeshLodCache::Level_Fine);
+  ASSERT_TRUE(aLodCache.activate(aSphere, OccImguiMeshLodCache::Level_Fine));
+  const std::vector<Handle(Poly_Triangulation)> aStored = meshCacheTestTriangulations(aSphere);
+
+  OccImguiMeshDiskCache aCache(aDir.path(), 256 * 1024);
+  for (uint64_t aKey = 0; aKey < 64; ++aKey)
+  {
+    aCache.store(aKey, aStored);
+    EXPECT_LE(aCache.size(), aCache.sizeLimit());
+  }
+}
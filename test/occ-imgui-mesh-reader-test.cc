@@ -0,0 +1,98 @@
+#include "occ_imgui/occ-imgui-mesh-reader.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+namespace
+{
+//! Build binary STL content of the triangles given by 9 coordinates each.
+std::vector<uint8_t> meshReaderTestStl(const std::vector<float>& theCoords)
+{
+  const uint32_t       aNbTriangles = static_cast<uint32_t>(theCoords.size() / 9);
+  std::vector<uint8_t> aData(84 + 50 * size_t(aNbTriangles), 0);
+  std::memcpy(aData.data() + 80, &aNbTriangles, 4);
+  for (size_t aTriIter = 0; aTriIter < aNbTriangles; ++aTriIter)
+  {
+    std::memcpy(aData.data() + 84 + aTriIter * 50 + 12, &theCoords[aTriIter * 9], 36);
+  }
+  return aData;
+}
+} // namespace
+
+TEST(OccImguiMeshReaderTest, SupportedExtensions)
+{
+  EXPECT_TRUE(OccImguiMeshReader::isSupportedFile("scan.STL"));
+  EXPECT_TRUE(OccImguiMeshReader::isSupportedFile("model.obj"));
+  EXPECT_TRUE(OccImguiMeshReader::isSupportedFile("scene.glb"));
+  EXPECT_FALSE(OccImguiMeshReader::isSupportedFile("part.step"));
+}
+
+TEST(OccImguiMeshReaderTest, BinaryStlMergesNodesPerChunk)
+{
+  // a quad of two triangles, a degenerate triangle and the quad once more
+  const std::vector<float> aCoords = {0, 0, 0, 1, 0, 0, 1, 1, 0, //
+                                      0, 0, 0, 1, 1, 0, 0, 1, 0, //
+                                      0, 0, 0, 0, 0, 0, 1, 1, 0, //
+                                      0, 0, 0, 1, 0, 0, 1, 1, 0, //
+                                      0, 0, 0, 1, 1, 0, 0, 1, 0};
+  const std::vector<uint8_t> aData = meshReaderTestStl(aCoords);
+  ASSERT_TRUE(OccImguiMeshReader::isBinaryStl(aData.data(), aData.size()));
+
+  std::vector<Handle(Poly_Triangulation)> aTriangulations;
+  ASSERT_TRUE(OccImguiMeshReader::readBinaryStl(aData.data(),
+                                                aData.size(),
+                                                3,
+                                                aTriangulations,
+                                                Message_ProgressRange()));
+  ASSERT_EQ(aTriangulations.size(), 2u);
+  EXPECT_EQ(aTriangulations[0]->NbNodes(), 4);
+  EXPECT_EQ(aTriangulations[0]->NbTriangles(), 2);
+  EXPECT_EQ(aTriangulations[1]->NbNodes(), 4);
+  EXPECT_EQ(aTriangulations[1]->NbTriangles(), 2);
+  EXPECT_FALSE(aTriangulations[0]->IsDoublePrecision());
+  EXPECT_TRUE(aTriangulations[0]->HasNormals());
+  EXPECT_TRUE(aTriangulations[0]->Node(3).IsEqual(gp_Pnt(1, 1, 0), 1.0e-7));
+
+  // truncated content is rejected
+  EXPECT_FALSE(OccImguiMeshReader::readBinaryStl(aData.data(),
+                                                 aData.size() - 1,
+                                                 3,
+                                                 aTriangulations,
+                                                 Message_ProgressRange()));
+}
+
+TEST(OccImguiMeshReaderTest, ObjPolygonsAndRelativeIndices)
+{
+  // the last line has no line end, as the end of a mapped file
+  const std::string anObj = "# quad\n"
+                            "v 0 0 0\n"
+                            "v 1 0 0\n"
+                            "vn 0 0 1\n"
+                            "v 1 1 0\r\n"
+                            "v 0 1 0\n"
+                            "f 1//1 2//1 3//1 4//1\n"
+                            "v 0 0 1\n"
+                            "f -5 -4 -1";
+  const Handle(Poly_Triangulation) aTri =
+    OccImguiMeshReader::readObj(anObj.data(), anObj.size(), Message_ProgressRange());
+  ASSERT_FALSE(aTri.IsNull());
+  EXPECT_EQ(aTri->NbNodes(), 5);
+  EXPECT_EQ(aTri->NbTriangles(), 3);
+
+  Standard_Integer aNodes[3] = {0, 0, 0};
+  aTri->Triangle(2).Get(aNodes[0], aNodes[1], aNodes[2]);
+  EXPECT_EQ(aNodes[0], 1);
+  EXPECT_EQ(aNodes[1], 3);
+  EXPECT_EQ(aNodes[2], 4);
+  aTri->Triangle(3).Get(aNodes[0], aNodes[1], aNodes[2]);
+  EXPECT_EQ(aNodes[0], 1);
+  EXPECT_EQ(aNodes[1], 2);
+  EXPECT_EQ(aNodes[2], 5);
+  EXPECT_TRUE(aTri->Node(5).IsEqual(gp_Pnt(0, 0, 1), 1.0e-7));
+
+  const std::string aBroken = "v 0 0 0\nv 1 0 0\nf 1 2 3\n";
+  EXPECT_TRUE(
+    OccImguiMeshReader::readObj(aBroken.data(), aBroken.size(), Message_ProgressRange()).IsNull());
+}
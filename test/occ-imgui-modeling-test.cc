@@ -0,0 +1,100 @@
+#include "occ_imgui/occ-imgui-modeling.h"
+
+#include <gtest/gtest.h>
+
+#include <opencascade/BRepCheck_Analyzer.hxx>
+#include <opencascade/BRepGProp.hxx>
+#include <opencascade/BRepPrimAPI_MakeBox.hxx>
+#include <opencascade/GProp_GProps.hxx>
+#include <opencascade/TopExp.hxx>
+#include <opencascade/TopTools_IndexedMapOfShape.hxx>
+
+namespace
+{
+//! Return volume of the shape.
+double modelingTestVolume(const TopoDS_Shape& theShape)
+{
+  GProp_GProps aProps;
+  BRepGProp::VolumeProperties(theShape, aProps);
+  return aProps.Mass();
+}
+} // namespace
+
+TEST(OccImguiModelingTest, BooleansAndFillet)
+{
+  const TopoDS_Shape aBox  = BRepPrimAPI_MakeBox(gp_Pnt(0, 0, 0), 10.0, 10.0, 10.0).Shape();
+  const TopoDS_Shape aTool = BRepPrimAPI_MakeBox(gp_Pnt(5, 5, 5), 10.0, 10.0, 10.0).Shape();
+
+  const TopoDS_Shape aFused = OccImguiModeling::perform(OccImguiModeling::Operation_Fuse,
+                                                        aBox,
+                                                        {aTool},
+                                                        0.0,
+                                                        Message_ProgressRange());
+  ASSERT_FALSE(aFused.IsNull());
+  EXPECT_TRUE(BRepCheck_Analyzer(aFused).IsValid());
+  EXPECT_NEAR(modelingTestVolume(aFused), 2000.0 - 125.0, 1.0e-6);
+
+  const TopoDS_Shape aCut = OccImguiModeling::perform(OccImguiModeling::Operation_Cut,
+                                                      aBox,
+                                                      {aTool},
+                                                      0.0,
+                                                      Message_ProgressRange());
+  ASSERT_FALSE(aCut.IsNull());
+  EXPECT_NEAR(modelingTestVolume(aCut), 1000.0 - 125.0, 1.0e-6);
+
+  // non-destructive mode keeps the inputs intact
+  EXPECT_NEAR(modelingTestVolume(aBox), 1000.0, 1.0e-6);
+
+  const TopoDS_Shape aFillet = OccImguiModeling::perform(OccImguiModeling::Operation_Fillet,
+                                                         aBox,
+                                                         {},
+                                                         1.0,
+                                                         Message_ProgressRange());
+  ASSERT_FALSE(aFillet.IsNull());
+  TopTools_IndexedMapOfShape aFaces;
+  TopExp::MapShapes(aFillet, TopAbs_FACE, aFaces);
+  EXPECT_EQ(aFaces.Extent(), 6 + 12 + 8);
+  EXPECT_LT(modelingTestVolume(aFillet), 1000.0);
+
+  EXPECT_THROW(OccImguiModeling::perform(OccImguiModeling::Operation_Fillet,
+                                         aBox,
+                                         {},
+                                         20.0,
+                                         Message_ProgressRange()),
+               Standard_Failure);
+}
+
+TEST(OccImguiModelingTest, TasksRunInBackground)
+{
+  OccImguiMeshLodCache aCache;
+  OccImguiModeling     aModeling(aCache);
+  Handle(AIS_Shape)    aTarget =
+    new AIS_Shape(BRepPrimAPI_MakeBox(gp_Pnt(0, 0, 0), 10.0, 10.0, 10.0).Shape());
+  Handle(AIS_Shape) aTool =
+    new AIS_Shape(BRepPrimAPI_MakeBox(gp_Pnt(5, 5, 5), 10.0, 10.0, 10.0).Shape());
+
+  // Booleans need tools, shapes of a running task cannot be used by another one
+  EXPECT_FALSE(aModeling.start(OccImguiModeling::Operation_Fuse, aTarget, {}, 0.0));
+  ASSERT_TRUE(aModeling.start(OccImguiModeling::Operation_Fuse, aTarget, {aTool}, 0.0));
+  EXPECT_TRUE(aModeling.isBusy(aTool));
+  EXPECT_FALSE(aModeling.start(OccImguiModeling::Operation_Offset, aTool, {}, 1.0));
+
+  aModeling.wait();
+  std::vector<std::unique_ptr<OccImguiModeling::Task>> aTasks;
+  ASSERT_EQ(aModeling.fetch(aTasks), 1u);
+  EXPECT_TRUE(aModeling.tasks().empty());
+  EXPECT_FALSE(aModeling.isBusy(aTool));
+  ASSERT_EQ(aTasks.front()->State.load(), OccImguiModeling::Status_Finished);
+  EXPECT_NEAR(modelingTestVolume(aTasks.front()->Result), 2000.0 - 125.0, 1.0e-6);
+  EXPECT_EQ(aCache.activeLevel(aTasks.front()->Result), OccImguiMeshLodCache::Level_Medium);
+
+  // operations stop at the first progress check after cancellation
+  Handle(OccImguiProgress) aProgress = new OccImguiProgress();
+  aProgress->requestCancel();
+  EXPECT_TRUE(OccImguiModeling::perform(OccImguiModeling::Operation_Fuse,
+                                        aTarget->Shape(),
+                                        {aTool->Shape()},
+                                        0.0,
+                                        aProgress->Start())
+                .IsNull());
+}
@@ -0,0 +1,76 @@
+#include "occ_imgui/occ-imgui-png-writer.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+//! Read a 32-bit big-endian value.
+uint32_t readPngTestUInt32(const std::vector<uint8_t>& theData, const size_t theOffset)
+{
+  return (uint32_t(theData[theOffset]) << 24) | (uint32_t(theData[theOffset + 1]) << 16)
+         | (uint32_t(theData[theOffset + 2]) << 8) | uint32_t(theData[theOffset + 3]);
+}
+} // namespace
+
+TEST(OccImguiPngWriterTest, Crc32CheckValue)
+{
+  const char* aData = "123456789";
+  EXPECT_EQ(OccImguiPngWriter::crc32(reinterpret_cast<const uint8_t*>(aData), 9), 0xCBF43926u);
+}
+
+TEST(OccImguiPngWriterTest, EncodesStoredScanlines)
+{
+  Image_PixMap anImage;
+  ASSERT_TRUE(anImage.InitZero(Image_Format_BGR, 3, 2));
+  for (size_t aRow = 0; aRow < 2; ++aRow)
+  {
+    for (size_t aCol = 0; aCol < 3; ++aCol)
+    {
+      uint8_t* aPixel = anImage.ChangeRow(aRow) + aCol * 3;
+      aPixel[0]       = 0;                                // blue
+      aPixel[1]       = static_cast<uint8_t>(aRow);       // green
+      aPixel[2]       = static_cast<uint8_t>(10 + aCol);  // red
+    }
+  }
+
+  std::vector<uint8_t> aData;
+  ASSERT_TRUE(OccImguiPngWriter::encode(anImage, aData));
+  ASSERT_GT(aData.size(), 8u + 25u + 12u);
+  EXPECT_EQ(aData[0], 0x89);
+  EXPECT_EQ(aData[1], 'P');
+
+  // IHDR: 13 bytes of width, height, bit depth 8 and color type 2 (RGB)
+  EXPECT_EQ(readPngTestUInt32(aData, 8), 13u);
+  EXPECT_EQ(std::string(aData.begin() + 12, aData.begin() + 16), "IHDR");
+  EXPECT_EQ(readPngTestUInt32(aData, 16), 3u);
+  EXPECT_EQ(readPngTestUInt32(aData, 20), 2u);
+  EXPECT_EQ(aData[24], 8);
+  EXPECT_EQ(aData[25], 2);
+  EXPECT_EQ(readPngTestUInt32(aData, 29), OccImguiPngWriter::crc32(aData.data() + 12, 17));
+
+  // IDAT: zlib header, one final stored block and the scanlines converted to RGB
+  const size_t anIdat = 33;
+  EXPECT_EQ(std::string(aData.begin() + anIdat + 4, aData.begin() + anIdat + 8), "IDAT");
+  const size_t aBlock = anIdat + 8 + 2;
+  EXPECT_EQ(aData[aBlock], 1);
+  const size_t aRawSize = 2 * (1 + 3 * 3);
+  EXPECT_EQ(aData[aBlock + 1] | (aData[aBlock + 2] << 8), static_cast<int>(aRawSize));
+  const uint8_t* aRaw = aData.data() + aBlock + 5;
+  EXPECT_EQ(aRaw[0], 0);
+  EXPECT_EQ(aRaw[1], 10);
+  EXPECT_EQ(aRaw[2], 0);
+  EXPECT_EQ(aRaw[3], 0);
+  EXPECT_EQ(aRaw[10], 0);
+  EXPECT_EQ(aRaw[10 + 7], 12);
+  EXPECT_EQ(aRaw[10 + 8], 1);
+
+  EXPECT_EQ(std::string(aData.end() - 8, aData.end() - 4), "IEND");
+}
+
+TEST(OccImguiPngWriterTest, RejectsFloatImages)
+{
+  Image_PixMap anImage;
+  ASSERT_TRUE(anImage.InitZero(Image_Format_RGBF, 2, 2));
+  std::vector<uint8_t> aData;
+  EXPECT_FALSE(OccImguiPngWriter::encode(anImage, aData));
+}
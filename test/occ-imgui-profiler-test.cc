@@ -0,0 +1,71 @@
+#include "occ_imgui/occ-imgui-profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+TEST(OccImguiProfilerTest, SnapshotKeepsLatestSamples)
+{
+  OccImguiProfiler aProfiler;
+  for (uint64_t aFrame = 0; aFrame < 10000; ++aFrame)
+  {
+    OccImguiProfiler::Sample aSample;
+    aSample.Frame = aFrame;
+    aProfiler.push(aSample);
+  }
+
+  std::vector<OccImguiProfiler::Sample> aSamples;
+  aProfiler.snapshot(aSamples, 100);
+  ASSERT_EQ(aSamples.size(), 100u);
+  EXPECT_EQ(aSamples.front().Frame, 9900u);
+  EXPECT_EQ(aSamples.back().Frame, 9999u);
+}
+
+TEST(OccImguiProfilerTest, ScopeRecordsStage)
+{
+  OccImguiProfiler aProfiler;
+  EXPECT_FALSE(aProfiler.hasGpuTimer());
+  aProfiler.beginFrame();
+  {
+    // GPU timing is silently skipped without OpenGL context
+    OccImguiProfiler::Scope aScope(aProfiler, OccImguiProfiler::Stage_Scene, true);
+  }
+
+  std::vector<OccImguiProfiler::Sample> aSamples;
+  aProfiler.snapshot(aSamples, 10);
+  ASSERT_EQ(aSamples.size(), 1u);
+  EXPECT_EQ(aSamples[0].StageId, OccImguiProfiler::Stage_Scene);
+  EXPECT_EQ(aSamples[0].Frame, 1u);
+  EXPECT_FALSE(aSamples[0].IsGpu);
+  EXPECT_GE(aSamples[0].DurationUs, 0.0);
+}
+
+TEST(OccImguiProfilerTest, DisabledProfilerRecordsNothing)
+{
+  OccImguiProfiler aProfiler;
+  aProfiler.setEnabled(false);
+  {
+    OccImguiProfiler::Scope aScope(aProfiler, OccImguiProfiler::Stage_Swap);
+  }
+
+  std::vector<OccImguiProfiler::Sample> aSamples;
+  aProfiler.snapshot(aSamples, 10);
+  EXPECT_TRUE(aSamples.empty());
+}
+
+TEST(OccImguiProfilerTest, ChromeTraceExport)
+{
+  OccImguiProfiler aProfiler;
+  {
+    OccImguiProfiler::Scope aScope(aProfiler, OccImguiProfiler::Stage_GuiBuild);
+  }
+
+  std::ostringstream aStream;
+  aProfiler.exportChromeTrace(aStream);
+  const std::string aTrace = aStream.str();
+  EXPECT_EQ(aTrace.front(), '{');
+  EXPECT_NE(aTrace.find("\"traceEvents\""), std::string::npos);
+  EXPECT_NE(aTrace.find("\"ph\":\"X\""), std::string::npos);
+  EXPECT_NE(aTrace.find(OccImguiProfiler::stageName(OccImguiProfiler::Stage_GuiBuild)),
+            std::string::npos);
+}
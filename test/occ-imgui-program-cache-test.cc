@@ -0,0 +1,61 @@
+#include "occ_imgui/occ-imgui-program-cache.h"
+
+#include "occ-imgui-test-dir.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+TEST(OccImguiProgramCacheTest, ProgramKey)
+{
+  const std::string aDriver  = "Mesa\nllvmpipe\n4.5";
+  const std::string aSources = "35633\nvoid main() {}\n";
+  const uint64_t    aKey     = OccImguiProgramCache::programKey(aDriver, aSources);
+  EXPECT_EQ(aKey, OccImguiProgramCache::programKey(aDriver, aSources));
+  EXPECT_NE(aKey, OccImguiProgramCache::programKey("Mesa\nllvmpipe\n4.6", aSources));
+  EXPECT_NE(aKey, OccImguiProgramCache::programKey(aDriver, "35632\nvoid main() {}\n"));
+}
+
+TEST(OccImguiProgramCacheTest, StoreAndLoad)
+{
+  const OccImguiTestDir      aDir("program-cache");
+  const OccImguiProgramCache aCache(aDir.path());
+  EXPECT_FALSE(aCache.isInstalled());
+
+  uint32_t             aFormat = 0;
+  std::vector<uint8_t> aBinary;
+  EXPECT_FALSE(aCache.load(42, aFormat, aBinary));
+
+  const std::vector<uint8_t> aStored = {1, 2, 3, 4, 5, 6, 7};
+  aCache.store(42, 0x8E21, aStored);
+  ASSERT_TRUE(aCache.load(42, aFormat, aBinary));
+  EXPECT_EQ(aFormat, 0x8E21u);
+  EXPECT_EQ(aBinary, aStored);
+  EXPECT_FALSE(aCache.load(43, aFormat, aBinary));
+
+  // entries claiming more data than the file holds are ignored without allocating it
+  for (const std::filesystem::directory_entry& anEntry :
+       std::filesystem::directory_iterator(aDir.path()))
+  {
+    const uint64_t aHugeSize = std::numeric_limits<uint64_t>::max() / 2;
+    std::fstream   aFile(anEntry.path(), std::ios::in | std::ios::out | std::ios::binary);
+    aFile.seekp(24);
+    aFile.write(reinterpret_cast<const char*>(&aHugeSize), sizeof(aHugeSize));
+  }
+  EXPECT_FALSE(aCache.load(42, aFormat, aBinary));
+  aCache.store(42, 0x8E21, aStored);
+  ASSERT_TRUE(aCache.load(42, aFormat, aBinary));
+
+  // truncated entries are ignored
+  for (const std::filesystem::directory_entry& anEntry :
+       std::filesystem::directory_iterator(aDir.path()))
+  {
+    std::filesystem::resize_file(anEntry.path(), 36);
+  }
+  EXPECT_FALSE(aCache.load(42, aFormat, aBinary));
+}
@@ -0,0 +1,120 @@
+#include "occ_imgui/occ-imgui-scene-index.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+//! Scene index naming objects "Part N" with attribute "solid" or "shell", counting fetches.
+struct SceneIndexTestScene
+{
+  size_t             NbFetches = 0;
+  OccImguiSceneIndex Index{[this](size_t theId, std::string& theName, std::string& theAttributes) {
+    ++NbFetches;
+    theName       = "Part " + std::to_string(theId);
+    theAttributes = theId % 2 == 0 ? "SOLID" : "SHELL";
+  }};
+
+  //! Add objects and return the scene.
+  explicit SceneIndexTestScene(const size_t theNbObjects)
+  {
+    for (size_t anIter = 0; anIter < theNbObjects; ++anIter)
+    {
+      Index.add();
+    }
+  }
+
+  //! Update the index until it is complete.
+  void complete()
+  {
+    while (!Index.update(16))
+    {
+    }
+  }
+};
+} // namespace
+
+TEST(OccImguiSceneIndexTest, NamesAreFetchedLazily)
+{
+  SceneIndexTestScene aScene(100);
+  EXPECT_EQ(aScene.NbFetches, 0u);
+
+  // all objects match the empty filter without fetching names
+  EXPECT_FALSE(aScene.Index.update(100));
+  EXPECT_EQ(aScene.Index.rows().size(), 100u);
+  EXPECT_EQ(aScene.NbFetches, 0u);
+
+  EXPECT_EQ(aScene.Index.name(42), "Part 42");
+  EXPECT_EQ(aScene.Index.attributes(42), "SOLID");
+  EXPECT_EQ(aScene.NbFetches, 1u);
+
+  // remaining names are indexed in bounded steps
+  EXPECT_FALSE(aScene.Index.update(50));
+  EXPECT_EQ(aScene.Index.nbIndexed(), 50u);
+  EXPECT_TRUE(aScene.Index.update(50));
+  EXPECT_EQ(aScene.Index.nbIndexed(), 100u);
+  EXPECT_EQ(aScene.NbFetches, 100u);
+}
+
+TEST(OccImguiSceneIndexTest, ExtendedFilterRefinesMatches)
+{
+  SceneIndexTestScene aScene(1000);
+  aScene.complete();
+
+  aScene.Index.setFilter("Part 1");
+  EXPECT_TRUE(aScene.Index.isFiltering());
+  aScene.complete();
+  EXPECT_EQ(aScene.Index.rows().size(), 271u); // numbers containing the digit 1
+  EXPECT_EQ(aScene.NbFetches, 1000u);
+
+  // the extended filter re-tests previous matches only, case-insensitively
+  aScene.Index.setFilter("Part 12 shell");
+  EXPECT_TRUE(aScene.Index.update(271));
+  ASSERT_EQ(aScene.Index.rows().size(), 5u); // odd ones of x12 and 120-129
+  EXPECT_EQ(aScene.Index.rows().front(), 121u);
+  EXPECT_EQ(aScene.Index.rows().back(), 129u);
+
+  // other filters scan the whole scene again
+  aScene.Index.setFilter("Part 99");
+  EXPECT_FALSE(aScene.Index.update(111));
+  aScene.complete();
+  EXPECT_EQ(aScene.Index.rows().size(), 19u); // x99 and 990-998
+  EXPECT_EQ(aScene.NbFetches, 1000u);
+
+  aScene.Index.setFilter("");
+  aScene.complete();
+  EXPECT_EQ(aScene.Index.rows().size(), 1000u);
+}
+
+TEST(OccImguiSceneIndexTest, ChangesKeepMatchesSorted)
+{
+  SceneIndexTestScene aScene(20);
+  aScene.Index.setFilter("solid");
+  aScene.complete();
+  EXPECT_EQ(aScene.Index.rows().size(), 10u);
+
+  aScene.Index.remove(4);
+  EXPECT_TRUE(aScene.Index.isRemoved(4));
+  EXPECT_EQ(aScene.Index.nbObjects(), 19u);
+  EXPECT_EQ(aScene.Index.rows().size(), 9u);
+
+  // objects added meanwhile are tested as well while refining a partial scan
+  aScene.Index.setFilter("solid part");
+  aScene.Index.update(3);
+  EXPECT_EQ(aScene.Index.add(), 20u);
+  EXPECT_EQ(aScene.Index.add(), 21u);
+  aScene.complete();
+  const std::vector<size_t> aRows = aScene.Index.rows();
+  EXPECT_EQ(aRows, (std::vector<size_t>{0, 2, 6, 8, 10, 12, 14, 16, 18, 20}));
+
+  // invalidated objects are matched again against the current filter
+  aScene.Index.invalidate(3);
+  EXPECT_EQ(aScene.Index.rows().size(), 10u);
+  aScene.Index.invalidate(6);
+  EXPECT_EQ(aScene.Index.rows().size(), 10u);
+  aScene.complete();
+  EXPECT_TRUE(std::is_sorted(aScene.Index.rows().begin(), aScene.Index.rows().end()));
+}
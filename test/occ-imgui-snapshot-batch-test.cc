@@ -0,0 +1,34 @@
+#include "occ_imgui/occ-imgui-snapshot-batch.h"
+
+#include <gtest/gtest.h>
+
+TEST(OccImguiSnapshotBatchTest, PartitionBalancesCosts)
+{
+  const std::vector<uintmax_t>           aCosts = {100, 10, 60, 50, 0};
+  const std::vector<std::vector<size_t>> aParts = OccImguiSnapshotBatch::partition(aCosts, 2);
+  ASSERT_EQ(aParts.size(), 2u);
+
+  // largest first to the least loaded worker: 100 | 60, 50 | 10 | 0
+  EXPECT_EQ(aParts[0], (std::vector<size_t>{0, 1, 4}));
+  EXPECT_EQ(aParts[1], (std::vector<size_t>{2, 3}));
+}
+
+TEST(OccImguiSnapshotBatchTest, PartitionLimitsWorkers)
+{
+  EXPECT_EQ(OccImguiSnapshotBatch::partition({1, 2}, 8).size(), 2u);
+  EXPECT_EQ(OccImguiSnapshotBatch::partition({}, 8).size(), 1u);
+  EXPECT_EQ(OccImguiSnapshotBatch::partition({1, 2, 3}, 0).size(), 1u);
+}
+
+TEST(OccImguiSnapshotBatchTest, ImageNamesAreUnique)
+{
+  std::vector<GlfwOcctSnapshot::Model> aModels = {{"a/part.step", ""},
+                                                  {"b/part.step", ""},
+                                                  {"c/other.brep", "part-2"},
+                                                  {"d/part.igs", ""}};
+  OccImguiSnapshotBatch::assignImageNames(aModels);
+  EXPECT_EQ(aModels[0].Name, "part");
+  EXPECT_EQ(aModels[1].Name, "part-3");
+  EXPECT_EQ(aModels[2].Name, "part-2");
+  EXPECT_EQ(aModels[3].Name, "part-4");
+}
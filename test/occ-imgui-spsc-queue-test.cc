@@ -0,0 +1,60 @@
+#include "occ_imgui/occ-imgui-spsc-queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+TEST(OccImguiSpscQueueTest, BoundedFifo)
+{
+  OccImguiSpscQueue<int> aQueue(3);
+  ASSERT_EQ(aQueue.capacity(), 4u);
+  EXPECT_TRUE(aQueue.empty());
+
+  int aValue = 0;
+  EXPECT_FALSE(aQueue.pop(aValue));
+  for (int anIter = 0; anIter < 4; ++anIter)
+  {
+    EXPECT_TRUE(aQueue.push(anIter));
+  }
+  EXPECT_FALSE(aQueue.push(4));
+
+  // indices wrap around the ring
+  for (int anIter = 0; anIter < 10; ++anIter)
+  {
+    ASSERT_TRUE(aQueue.pop(aValue));
+    EXPECT_EQ(aValue, anIter);
+    EXPECT_TRUE(aQueue.push(anIter + 4));
+  }
+  EXPECT_FALSE(aQueue.empty());
+}
+
+TEST(OccImguiSpscQueueTest, ProducerAndConsumerThreads)
+{
+  constexpr int          THE_NB_VALUES = 100000;
+  OccImguiSpscQueue<int> aQueue(64);
+  std::thread            aProducer([&aQueue]() {
+    for (int anIter = 0; anIter < THE_NB_VALUES; ++anIter)
+    {
+      while (!aQueue.push(anIter))
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  // values arrive complete and in order
+  int aNbReceived = 0;
+  int aValue      = 0;
+  while (aNbReceived < THE_NB_VALUES)
+  {
+    if (!aQueue.pop(aValue))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    EXPECT_EQ(aValue, aNbReceived);
+    ++aNbReceived;
+  }
+  aProducer.join();
+  EXPECT_TRUE(aQueue.empty());
+}
@@ -0,0 +1,53 @@
+#include "occ_imgui/occ-imgui-startup-timeline.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+TEST(OccImguiStartupTimelineTest, ScopesRecordPhases)
+{
+  OccImguiStartupTimeline aTimeline;
+  {
+    OccImguiStartupTimeline::Scope aScope(aTimeline, "window");
+  }
+  {
+    OccImguiStartupTimeline::Scope aScope(aTimeline, "viewer");
+  }
+  ASSERT_EQ(aTimeline.phases().size(), 2u);
+  EXPECT_EQ(aTimeline.phases()[0].Name, "window");
+  EXPECT_EQ(aTimeline.phases()[1].Name, "viewer");
+  EXPECT_GE(aTimeline.phases()[1].BeginMs,
+            aTimeline.phases()[0].BeginMs + aTimeline.phases()[0].DurationMs);
+  EXPECT_FALSE(aTimeline.hasFirstFrame());
+
+  aTimeline.start();
+  EXPECT_TRUE(aTimeline.phases().empty());
+}
+
+TEST(OccImguiStartupTimelineTest, DumpSplitsDeferredPhases)
+{
+  OccImguiStartupTimeline aTimeline;
+  aTimeline.addPhase("viewer", 10.0, 30.0);
+  aTimeline.addPhase("window", 0.0, 10.0);
+  aTimeline.markFirstFrame(50.0);
+  aTimeline.addPhase("grid", 51.0, 51.5);
+  aTimeline.markFirstFrame(60.0);
+  EXPECT_DOUBLE_EQ(aTimeline.firstFrameMs(), 50.0);
+
+  EXPECT_FALSE(aTimeline.isDeferred(aTimeline.phases()[0]));
+  EXPECT_TRUE(aTimeline.isDeferred(aTimeline.phases()[2]));
+
+  // phases are printed by start time, the first frame in between
+  std::ostringstream aStream;
+  aTimeline.dump(aStream);
+  const std::string aText   = aStream.str();
+  const size_t      aWindow = aText.find("window");
+  const size_t      aViewer = aText.find("viewer");
+  const size_t      aFrame  = aText.find("first frame");
+  const size_t      aGrid   = aText.find("grid (deferred)");
+  ASSERT_NE(aGrid, std::string::npos);
+  EXPECT_LT(aWindow, aViewer);
+  EXPECT_LT(aViewer, aFrame);
+  EXPECT_LT(aFrame, aGrid);
+  EXPECT_NE(aText.find("20.0  viewer"), std::string::npos);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+//! Temporary directory of a unit test, removed at the end of the test.
+class OccImguiTestDir
+{
+public:
+  //! Create the path of the directory in the temporary folder, removing leftovers of earlier runs.
+  explicit OccImguiTestDir(const std::string& theName)
+      : myPath(std::filesystem::temp_directory_path() / ("occ-imgui-test-" + theName))
+  {
+    std::filesystem::remove_all(myPath);
+  }
+
+  //! Remove the directory with its content.
+  ~OccImguiTestDir()
+  {
+    std::error_code anError;
+    std::filesystem::remove_all(myPath, anError);
+  }
+
+  OccImguiTestDir(const OccImguiTestDir&)            = delete;
+  OccImguiTestDir& operator=(const OccImguiTestDir&) = delete;
+
+  //! Return path of the directory.
+  const std::filesystem::path& path() const { return myPath; }
+
+private:
+  std::filesystem::path myPath;
+};
@@ -0,0 +1,21 @@
+// This file #includes all occ-imgui implementation .cc files together
+// with the unit tests. The purpose is to allow a user to build
+// occ-imgui-test by compiling this file alone.
+
+#include "occ-imgui-all.cc"
+
+#include "occ-imgui-adaptive-resolution-test.cc"
+#include "occ-imgui-frame-pacer-test.cc"
+#include "occ-imgui-frame-stats-test.cc"
+#include "occ-imgui-input-queue-test.cc"
+#include "occ-imgui-input-recording-test.cc"
+#include "occ-imgui-mesh-cache-test.cc"
+#include "occ-imgui-mesh-reader-test.cc"
+#include "occ-imgui-modeling-test.cc"
+#include "occ-imgui-png-writer-test.cc"
+#include "occ-imgui-profiler-test.cc"
+#include "occ-imgui-program-cache-test.cc"
+#include "occ-imgui-scene-index-test.cc"
+#include "occ-imgui-snapshot-batch-test.cc"
+#include "occ-imgui-spsc-queue-test.cc"
+#include "occ-imgui-startup-timeline-test.cc"